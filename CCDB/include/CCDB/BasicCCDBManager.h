@@ -20,6 +20,7 @@
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 // #include <FairLogger.h>
 
@@ -81,6 +82,19 @@ class CCDBManagerInstance
     return getForTimeStamp<T>(path, mTimestamp);
   }
 
+  /// download concurrently the objects at given paths valid for the timestamp into the local object cache,
+  /// from where the subsequent queries are served; returns the number of objects available there
+  int prefetch(std::vector<std::string> const& paths, long timestamp)
+  {
+    return mCCDBAccessor.prefetch(paths, mMetaData, timestamp);
+  }
+
+  /// prefetch objects valid for the timestamp member
+  int prefetch(std::vector<std::string> const& paths) { return prefetch(paths, mTimestamp); }
+
+  /// set the directory of the persistent local object cache (empty to disable it)
+  void setLocalObjectCache(std::string const& dir) { mCCDBAccessor.setLocalObjectCache(dir); }
+
   bool isHostReachable() const { return mCCDBAccessor.isHostReachable(); }
 
   /// clear all entries in the cache
@@ -19,6 +19,7 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 #include <curl/curl.h>
 #include <TObject.h>
 #include <TMessage.h>
@@ -147,6 +148,35 @@ class CcdbApi //: public DatabaseInterface
                           long timestamp = -1, std::map<std::string, std::string>* headers = nullptr, std::string const& etag = "",
                           const std::string& createdNotAfter = "", const std::string& createdNotBefore = "") const;
 
+  /**
+   * Download concurrently (with curl multi handles) the objects at the given paths valid for the timestamp and
+   * persist them in the local object cache, from where the subsequent retrievals are served.
+   * Objects already present in the local object cache are not downloaded again.
+   *
+   * @param paths The paths where the objects are to be found.
+   * @param metadata Key-values representing the metadata to filter out objects.
+   * @param timestamp Timestamp of the objects to retrieve. If omitted, current timestamp is used.
+   * @param maxConnections Maximum number of simultaneous connections.
+   * @return the number of requested objects which are available in the local object cache.
+   */
+  int prefetch(std::vector<std::string> const& paths, std::map<std::string, std::string> const& metadata,
+               long timestamp = -1, int maxConnections = 16) const;
+
+  /**
+   * Set the directory of the persistent local object cache (empty to disable it, which is the default unless
+   * the ALICEO2_CCDB_LOCALCACHE environment variable is set).
+   * The retrieved objects are stored there, keyed by path, validity interval and ETag. A retrieval for a timestamp
+   * within the validity of a stored object is served from the disk without contacting the server, also in later
+   * processes. The cache is not consulted in the TimeMachine mode (createdNotAfter/createdNotBefore).
+   * Objects uploaded later with an overlapping validity are not seen until the cache is cleaned.
+   */
+  void setLocalObjectCache(std::string const& dir) { mLocalCacheDir = dir; }
+
+  /**
+   * Query the directory of the persistent local object cache
+   */
+  std::string const& getLocalObjectCache() const { return mLocalCacheDir; }
+
   /**
    * Delete all versions of the object at this path.
    *
@@ -240,6 +270,36 @@ class CcdbApi //: public DatabaseInterface
    */
   static void* extractFromTFile(TFile& file, TClass const* cl);
 
+  /**
+   * Extract the object of type T from the image of a CCDB file in memory (as created by createObjectImage or
+   * sent by the server). Can be called concurrently, see enableConcurrentDeserialization.
+   * @param image pointer to the image
+   * @param size size of the image
+   * @return raw pointer to created object, nullptr if the image does not contain an object of type T
+   */
+  template <typename T>
+  static T* extractFromImage(char const* image, size_t size)
+  {
+    return static_cast<T*>(extractFromImage(image, size, typeid(T)));
+  }
+
+  /**
+   * Extract the object of the type given by tinfo from the image of a CCDB file in memory
+   */
+  static void* extractFromImage(char const* image, size_t size, std::type_info const& tinfo);
+
+  /**
+   * Enable the concurrent deserialization of the retrieved objects, for all the instances of CcdbApi.
+   * The files are then read without the global IO lock of CcdbApi, relying on the thread safety of ROOT
+   * (ROOT::EnableThreadSafety is called), so the threads retrieving objects do not wait for each other.
+   */
+  static void enableConcurrentDeserialization(bool v = true);
+
+  /**
+   * Check whether the retrieved objects are deserialized concurrently
+   */
+  static bool isConcurrentDeserializationEnabled();
+
   /** Get headers associated to a given CCDBEntry on the server. 
    * @param url the url which refers to the objects
    * @param etag of the previous reply
@@ -364,7 +424,18 @@ class CcdbApi //: public DatabaseInterface
 
   /// Queries the CCDB server and navigates through possible redirects until binary content is found; Retrieves content as instance
   /// given by tinfo if that is possible. Returns nullptr if something fails...
-  void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers) const;
+  /// If blob is given, the binary content is copied there as well.
+  void* navigateURLsAndRetrieveContent(CURL*, std::string const& url, std::type_info const& tinfo, std::map<std::string, std::string>* headers,
+                                       std::string* blob = nullptr) const;
+
+  /// Looks in the local object cache for the object at path valid for the timestamp; returns the name of the file
+  /// holding it (empty if there is none) and fills the headers it was retrieved with.
+  std::string findInLocalCache(std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                               std::map<std::string, std::string>& headers) const;
+
+  /// Persists the binary content of the object at path in the local object cache, the headers must provide its validity.
+  bool storeInLocalCache(std::string const& path, std::map<std::string, std::string> const& metadata,
+                         std::map<std::string, std::string> const& headers, std::string const& blob) const;
 
   // helper that interprets a content chunk as TMemFile and extracts the object therefrom
   void* interpretAsTMemFileAndExtract(char* contentptr, size_t contentsize, std::type_info const& tinfo) const;
@@ -383,6 +454,7 @@ class CcdbApi //: public DatabaseInterface
   bool mInSnapshotMode = false;
   mutable TGrid* mAlienInstance = nullptr;                     // a cached connection to TGrid (needed for Alien locations)
   bool mHaveAlienToken = false;                                // stores if an alien token is available
+  std::string mLocalCacheDir{};                                // directory of the persistent local object cache
 
   ClassDefNV(CcdbApi, 1);
 };
@@ -20,7 +20,9 @@
 #include <chrono>
 #include <sstream>
 #include <TFile.h>
+#include <TDirectory.h>
 #include <TGrid.h>
+#include <TROOT.h>
 #include <TSystem.h>
 #include <TStreamerInfo.h>
 #include <TMemFile.h>
@@ -31,8 +33,10 @@
 #include <TClass.h>
 #include <CCDB/CCDBTimeStampUtils.h>
 #include <algorithm>
+#include <atomic>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
+#include <fstream>
 #include <iostream>
 #include <mutex>
 
@@ -43,7 +47,56 @@ namespace ccdb
 
 using namespace std;
 
-std::mutex gIOMutex; // to protect TMemFile IO operations
+std::mutex gIOMutex;                                 // to protect TMemFile IO operations
+std::atomic<bool> gConcurrentDeserialization{false}; // if set, reading of files is not protected by gIOMutex
+
+namespace
+{
+// the lock protecting the reading of files, if they are not read concurrently
+std::unique_lock<std::mutex> readLock()
+{
+  return gConcurrentDeserialization ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(gIOMutex);
+}
+
+// silences the errors of ROOT while files, possibly invalid, are opened; shared by the concurrent readers,
+// the last one restores the previous error level
+class SilentROOTErrors
+{
+ public:
+  SilentROOTErrors()
+  {
+    std::lock_guard<std::mutex> guard(mutex());
+    if (users()++ == 0) {
+      previousLevel() = gErrorIgnoreLevel;
+      gErrorIgnoreLevel = kFatal;
+    }
+  }
+  ~SilentROOTErrors()
+  {
+    std::lock_guard<std::mutex> guard(mutex());
+    if (--users() == 0) {
+      gErrorIgnoreLevel = previousLevel();
+    }
+  }
+
+ private:
+  static std::mutex& mutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+  static int& users()
+  {
+    static int n = 0;
+    return n;
+  }
+  static Int_t& previousLevel()
+  {
+    static Int_t level = 0;
+    return level;
+  }
+};
+} // namespace
 
 CcdbApi::~CcdbApi()
 {
@@ -71,6 +124,11 @@ void CcdbApi::init(std::string const& host)
     curlInit();
   }
 
+  // the persistent local object cache can be shared by all processes of a workflow
+  if (mLocalCacheDir.empty() && getenv("ALICEO2_CCDB_LOCALCACHE")) {
+    mLocalCacheDir = getenv("ALICEO2_CCDB_LOCALCACHE");
+  }
+
   // find out if we can can in principle connect to Alien
   mHaveAlienToken = checkAlienToken();
 }
@@ -460,8 +518,9 @@ void* CcdbApi::extractFromLocalFile(std::string const& filename, std::type_info
     LOG(INFO) << "Local snapshot " << filename << " not found \n";
     return nullptr;
   }
-  std::lock_guard<std::mutex> guard(gIOMutex);
+  auto lock = readLock();
   auto tcl = tinfo2TClass(tinfo);
+  TDirectory::TContext context;
   TFile f(filename.c_str(), "READ");
   return extractFromTFile(f, tcl);
 }
@@ -507,26 +566,48 @@ void* CcdbApi::downloadAlienContent(std::string const& url, std::type_info const
 }
 
 void* CcdbApi::interpretAsTMemFileAndExtract(char* contentptr, size_t contentsize, std::type_info const& tinfo) const
+{
+  return extractFromImage(contentptr, contentsize, tinfo);
+}
+
+void* CcdbApi::extractFromImage(char const* image, size_t size, std::type_info const& tinfo)
 {
   void* result = nullptr;
-  Int_t previousErrorLevel = gErrorIgnoreLevel;
-  gErrorIgnoreLevel = kFatal;
-  std::lock_guard<std::mutex> guard(gIOMutex);
-  TMemFile memFile("name", contentptr, contentsize, "READ");
-  gErrorIgnoreLevel = previousErrorLevel;
-  if (!memFile.IsZombie()) {
+  auto lock = readLock();
+  // gDirectory is changed by opening the file, with the thread safety of ROOT enabled it is local to the thread
+  TDirectory::TContext context;
+  std::unique_ptr<TMemFile> memFile;
+  {
+    SilentROOTErrors silence;
+    memFile = std::make_unique<TMemFile>("name", const_cast<char*>(image), size, "READ");
+  }
+  if (!memFile->IsZombie()) {
     auto tcl = tinfo2TClass(tinfo);
-    result = extractFromTFile(memFile, tcl);
+    result = extractFromTFile(*memFile, tcl);
     if (!result) {
       LOG(ERROR) << o2::utils::concat_string("Couldn't retrieve object corresponding to ", tcl->GetName(), " from TFile");
     }
-    memFile.Close();
+    memFile->Close();
   }
   return result;
 }
 
+void CcdbApi::enableConcurrentDeserialization(bool v)
+{
+  if (v) {
+    ROOT::EnableThreadSafety();
+  }
+  gConcurrentDeserialization = v;
+}
+
+bool CcdbApi::isConcurrentDeserializationEnabled()
+{
+  return gConcurrentDeserialization;
+}
+
 // navigate sequence of URLs until TFile content is found; object is extracted and returned
-void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers) const
+void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string const& url, std::type_info const& tinfo, std::map<string, string>* headers,
+                                               std::string* blob) const
 {
   // a global internal data structure that can be filled with HTTP header information
   // static --> to avoid frequent alloc/dealloc as optimization
@@ -572,6 +653,9 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
     if (200 <= response_code && response_code < 300) {
       // good response and the content is directly provided and should have been dumped into "chunk"
       content = interpretAsTMemFileAndExtract(chunk.memory, chunk.size, tinfo);
+      if (content && blob) {
+        blob->assign(chunk.memory, chunk.size);
+      }
     } else if (response_code == 304) {
       // this means the object exist but I am not serving
       // it since it's already in your possession
@@ -612,7 +696,7 @@ void* CcdbApi::navigateURLsAndRetrieveContent(CURL* curl_handle, std::string con
       for (auto& l : locs) {
         if (l.size() > 0) {
           LOG(DEBUG) << "Trying content location " << l;
-          content = navigateURLsAndRetrieveContent(curl_handle, l, tinfo, nullptr);
+          content = navigateURLsAndRetrieveContent(curl_handle, l, tinfo, nullptr, blob);
           if (content /* or other success marker in future */) {
             break;
           }
@@ -650,9 +734,34 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
   string fullUrl = getFullUrlForRetrieval(curl_handle, path, metadata, timestamp);
   // if we are in snapshot mode we can simply open the file; extract the object and return
   if (mInSnapshotMode) {
+    curl_easy_cleanup(curl_handle);
     return extractFromLocalFile(fullUrl, tinfo);
   }
 
+  // objects valid for the timestamp which are already in the local object cache are served from there
+  const bool useLocalCache = !mLocalCacheDir.empty() && createdNotAfter.empty() && createdNotBefore.empty();
+  if (useLocalCache) {
+    std::map<std::string, std::string> cachedHeaders;
+    auto cachedFile = findInLocalCache(path, metadata, timestamp < 0 ? getCurrentTimestamp() : timestamp, cachedHeaders);
+    if (!cachedFile.empty()) {
+      if (headers) {
+        for (auto& p : cachedHeaders) {
+          (*headers)[p.first] = p.second;
+        }
+      }
+      if (!etag.empty() && cachedHeaders["ETag"] == etag) {
+        // the caller has this object already, as with the 304 reply of the server
+        curl_easy_cleanup(curl_handle);
+        return nullptr;
+      }
+      auto content = extractFromLocalFile(cachedFile, tinfo);
+      if (content) {
+        curl_easy_cleanup(curl_handle);
+        return content;
+      }
+    }
+  }
+
   // add some global options to the curl query
   struct curl_slist* list = nullptr;
   if (!etag.empty()) {
@@ -669,8 +778,15 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
   }
   curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, list);
 
-  auto content = navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, headers);
+  // the validity of the object is needed to persist it in the local object cache
+  std::map<std::string, std::string> replyHeaders;
+  std::string blob;
+  auto content = navigateURLsAndRetrieveContent(curl_handle, fullUrl, tinfo, headers ? headers : &replyHeaders, useLocalCache ? &blob : nullptr);
+  if (content && !blob.empty()) {
+    storeInLocalCache(path, metadata, headers ? *headers : replyHeaders, blob);
+  }
   curl_easy_cleanup(curl_handle);
+  curl_slist_free_all(list);
   return content;
 }
 
@@ -689,6 +805,260 @@ size_t CurlWrite_CallbackFunc_StdString2(void* contents, size_t size, size_t nme
   return size * nmemb;
 }
 
+namespace
+{
+// the name under which the metadata of the query is kept in the headers stored in the local object cache
+constexpr const char* LOCALCACHE_METADATA = "Query-Metadata";
+
+std::string metadataToString(std::map<std::string, std::string> const& metadata)
+{
+  std::string result;
+  for (auto& kv : metadata) {
+    result += kv.first + "=" + kv.second + "/";
+  }
+  return result;
+}
+} // namespace
+
+std::string CcdbApi::findInLocalCache(std::string const& path, std::map<std::string, std::string> const& metadata, long timestamp,
+                                      std::map<std::string, std::string>& headers) const
+{
+  namespace fs = boost::filesystem;
+  boost::system::error_code ec;
+  fs::path dir = fs::path(mLocalCacheDir) / path;
+  if (!fs::is_directory(dir, ec)) {
+    return {};
+  }
+  const auto metadataString = metadataToString(metadata);
+  std::string found;
+  long foundStart = 0;
+  for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+    auto const& file = it->path();
+    if (file.extension() != ".root") {
+      continue;
+    }
+    // the name of the file is <valid from>_<valid until>_<etag>, the newest object valid for the timestamp is taken
+    std::vector<std::string> tokens;
+    auto stem = file.stem().string();
+    boost::split(tokens, stem, boost::is_any_of("_"));
+    if (tokens.size() != 3) {
+      continue;
+    }
+    long validFrom = 0, validUntil = 0;
+    try {
+      validFrom = std::stol(tokens[0]);
+      validUntil = std::stol(tokens[1]);
+    } catch (std::exception const&) {
+      continue;
+    }
+    if (timestamp < validFrom || timestamp >= validUntil || (!found.empty() && validFrom < foundStart)) {
+      continue;
+    }
+    std::ifstream headersFile(fs::path(file).replace_extension(".headers").string());
+    if (!headersFile) {
+      continue;
+    }
+    std::map<std::string, std::string> fileHeaders;
+    std::string line;
+    while (std::getline(headersFile, line)) {
+      auto index = line.find(':');
+      if (index != std::string::npos) {
+        fileHeaders[line.substr(0, index)] = boost::algorithm::trim_copy(line.substr(index + 1));
+      }
+    }
+    if (fileHeaders[LOCALCACHE_METADATA] != metadataString) {
+      continue;
+    }
+    fileHeaders.erase(LOCALCACHE_METADATA);
+    found = file.string();
+    foundStart = validFrom;
+    headers = std::move(fileHeaders);
+  }
+  return found;
+}
+
+bool CcdbApi::storeInLocalCache(std::string const& path, std::map<std::string, std::string> const& metadata,
+                                std::map<std::string, std::string> const& headers, std::string const& blob) const
+{
+  namespace fs = boost::filesystem;
+  auto validFrom = headers.find("Valid-From");
+  auto validUntil = headers.find("Valid-Until");
+  if (validFrom == headers.end() || validUntil == headers.end()) {
+    return false;
+  }
+  long start = 0, end = 0;
+  try {
+    start = std::stol(validFrom->second);
+    end = std::stol(validUntil->second);
+  } catch (std::exception const&) {
+    return false;
+  }
+  auto etag = headers.count("ETag") ? headers.at("ETag") : std::string();
+  etag.erase(std::remove_if(etag.begin(), etag.end(), [](auto const& c) -> bool { return (!std::isalnum(c) && c != '-'); }), etag.end());
+
+  boost::system::error_code ec;
+  fs::path dir = fs::path(mLocalCacheDir) / path;
+  fs::create_directories(dir, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not create the local object cache directory " << dir.string();
+    return false;
+  }
+  const auto name = (dir / (std::to_string(start) + "_" + std::to_string(end) + "_" + etag)).string();
+
+  // the files are written under temporary names and renamed, so that concurrent processes never read them incomplete;
+  // the headers go first as the objects are looked up by their .root files
+  auto write = [&ec](std::string const& target, std::string const& content) {
+    auto tmp = fs::unique_path(target + ".%%%%-%%%%-%%%%");
+    {
+      std::ofstream out(tmp.string(), std::ios::binary);
+      out.write(content.data(), content.size());
+      if (!out) {
+        fs::remove(tmp, ec);
+        return false;
+      }
+    }
+    fs::rename(tmp, target, ec);
+    return !ec;
+  };
+  std::string headersContent;
+  for (auto& h : headers) {
+    if (h.first != "Error") {
+      headersContent += h.first + ": " + h.second + "\n";
+    }
+  }
+  headersContent += std::string(LOCALCACHE_METADATA) + ": " + metadataToString(metadata) + "\n";
+  if (!write(name + ".headers", headersContent) || !write(name + ".root", blob)) {
+    LOG(WARNING) << "Could not store " << path << " in the local object cache " << mLocalCacheDir;
+    return false;
+  }
+  return true;
+}
+
+int CcdbApi::prefetch(std::vector<std::string> const& paths, std::map<std::string, std::string> const& metadata,
+                      long timestamp, int maxConnections) const
+{
+  if (mInSnapshotMode || mLocalCacheDir.empty()) {
+    LOG(WARNING) << "Prefetching of CCDB objects requires a server and the local object cache";
+    return 0;
+  }
+  if (timestamp < 0) {
+    timestamp = getCurrentTimestamp();
+  }
+
+  // one transfer per object, it follows the redirections of the server to the content locations
+  struct Transfer {
+    std::string path;
+    CURL* handle = nullptr;
+    std::multimap<std::string, std::string> reply; // headers of the current reply
+    std::map<std::string, std::string> headers;    // headers of the reply of the CCDB server
+    std::vector<std::string> locations;            // content locations still to be tried
+    std::string blob;
+  };
+  int nAvailable = 0;
+  std::vector<Transfer> transfers;
+  transfers.reserve(paths.size());
+  for (auto& path : paths) {
+    std::map<std::string, std::string> cachedHeaders;
+    if (findInLocalCache(path, metadata, timestamp, cachedHeaders).empty()) {
+      transfers.emplace_back();
+      transfers.back().path = path;
+    } else {
+      nAvailable++;
+    }
+  }
+  if (transfers.empty()) {
+    return nAvailable;
+  }
+
+  CURLM* multi = curl_multi_init();
+  curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(maxConnections));
+  int nActive = 0;
+  auto start = [multi, &nActive](Transfer& t, std::string const& url) {
+    t.reply.clear();
+    t.blob.clear();
+    curl_easy_setopt(t.handle, CURLOPT_URL, url.c_str());
+    curl_multi_add_handle(multi, t.handle);
+    nActive++;
+  };
+  for (auto& t : transfers) {
+    t.handle = curl_easy_init();
+    curl_easy_setopt(t.handle, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+    curl_easy_setopt(t.handle, CURLOPT_FOLLOWLOCATION, 0L);
+    curl_easy_setopt(t.handle, CURLOPT_HEADERFUNCTION, header_map_callback<decltype(t.reply)>);
+    curl_easy_setopt(t.handle, CURLOPT_HEADERDATA, (void*)&t.reply);
+    curl_easy_setopt(t.handle, CURLOPT_WRITEFUNCTION, CurlWrite_CallbackFunc_StdString2);
+    curl_easy_setopt(t.handle, CURLOPT_WRITEDATA, &t.blob);
+    curl_easy_setopt(t.handle, CURLOPT_PRIVATE, &t);
+    start(t, getFullUrlForRetrieval(t.handle, t.path, metadata, timestamp));
+  }
+
+  // some locations are relative to the main server so we need to complement them
+  auto complement_Location = [this](std::string const& loc) {
+    return loc[0] == '/' ? getURL() + loc : loc;
+  };
+  while (nActive > 0) {
+    int running = 0;
+    curl_multi_perform(multi, &running);
+    int left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi, &left)) {
+      if (msg->msg != CURLMSG_DONE) {
+        continue;
+      }
+      Transfer* t = nullptr;
+      curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &t);
+      const auto result = msg->data.result;
+      curl_multi_remove_handle(multi, t->handle);
+      nActive--;
+
+      long response_code = -1;
+      if (result == CURLE_OK && curl_easy_getinfo(t->handle, CURLINFO_RESPONSE_CODE, &response_code) == CURLE_OK) {
+        if (t->headers.empty()) {
+          for (auto& p : t->reply) {
+            t->headers[p.first] = p.second;
+          }
+        }
+        if (200 <= response_code && response_code < 300) {
+          if (storeInLocalCache(t->path, metadata, t->headers, t->blob)) {
+            nAvailable++;
+          }
+          t->locations.clear();
+        } else if (300 <= response_code && response_code < 400) {
+          // the locations are tried in order of appearance, alien:// ones are left to the regular retrieval
+          for (auto field : {"Location", "Content-Location"}) {
+            auto range = t->reply.equal_range(field);
+            for (auto it = range.first; it != range.second; ++it) {
+              if (it->second.empty() || it->second.find("alien:/", 0) != std::string::npos) {
+                continue;
+              }
+              auto location = complement_Location(it->second);
+              if (std::find(t->locations.begin(), t->locations.end(), location) == t->locations.end()) {
+                t->locations.push_back(location);
+              }
+            }
+          }
+        } else {
+          LOG(ERROR) << "Prefetching of " << t->path << " failed with the response code " << response_code;
+        }
+      } else {
+        LOG(ERROR) << "Curl request prefetching " << t->path << " failed: " << curl_easy_strerror(result);
+      }
+      if (!t->locations.empty()) {
+        auto location = t->locations.front();
+        t->locations.erase(t->locations.begin());
+        start(*t, location);
+      }
+    }
+    if (nActive > 0) {
+      curl_multi_wait(multi, nullptr, 0, 1000, nullptr);
+    }
+  }
+  for (auto& t : transfers) {
+    curl_easy_cleanup(t.handle);
+  }
+  curl_multi_cleanup(multi);
+  return nAvailable;
+}
+
 std::string CcdbApi::list(std::string const& path, bool latestOnly, std::string const& returnFormat) const
 {
   CURL* curl;
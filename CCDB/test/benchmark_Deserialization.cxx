@@ -0,0 +1,68 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmark_Deserialization.cxx
+/// \brief  Measures the contention of threads extracting CCDB objects from their images in memory
+///
+
+#include <benchmark/benchmark.h>
+
+#include "CCDB/CcdbApi.h"
+#include <TH2F.h>
+#include <TRandom.h>
+
+using namespace o2::ccdb;
+
+namespace
+{
+// an image of a CCDB file with a 2D histogram of 1000x1000 bins
+std::vector<char> const& getImage()
+{
+  static std::vector<char> image = []() {
+    TH2F histo("calib", "calib", 1000, 0, 1, 1000, 0, 1);
+    histo.SetDirectory(nullptr);
+    for (int i = 0; i < 100000; i++) {
+      histo.Fill(gRandom->Rndm(), gRandom->Rndm());
+    }
+    return *CcdbApi::createObjectImage(&histo);
+  }();
+  return image;
+}
+
+void extract(benchmark::State& state, bool concurrent)
+{
+  auto const& image = getImage();
+  CcdbApi::enableConcurrentDeserialization(concurrent);
+  for (auto _ : state) {
+    auto histo = CcdbApi::extractFromImage<TH2F>(image.data(), image.size());
+    benchmark::DoNotOptimize(histo);
+    delete histo;
+  }
+  state.SetBytesProcessed(state.iterations() * image.size());
+}
+} // namespace
+
+static void BM_ExtractWithGlobalLock(benchmark::State& state)
+{
+  extract(state, false);
+}
+
+static void BM_ExtractConcurrently(benchmark::State& state)
+{
+  extract(state, true);
+}
+
+// TEST: see how the deserialization scales with the number of threads retrieving objects.
+// The locked variant goes first, as the thread safety of ROOT cannot be switched off once enabled.
+BENCHMARK(BM_ExtractWithGlobalLock)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ExtractConcurrently)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
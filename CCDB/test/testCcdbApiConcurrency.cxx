@@ -0,0 +1,64 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCcdbApiConcurrency.cxx
+/// \brief  Test the concurrent extraction of objects from their images in memory
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CcdbApi.h"
+#include <boost/test/unit_test.hpp>
+#include <TH1F.h>
+#include <atomic>
+#include <thread>
+
+using namespace o2::ccdb;
+
+BOOST_AUTO_TEST_CASE(TestConcurrentDeserialization)
+{
+  TH1F histo("calib", "calib", 100, 0, 100);
+  histo.SetDirectory(nullptr);
+  for (int i = 0; i < 100; i++) {
+    histo.Fill(i, i);
+  }
+  auto image = CcdbApi::createObjectImage(&histo);
+
+  CcdbApi::enableConcurrentDeserialization();
+  BOOST_CHECK(CcdbApi::isConcurrentDeserializationEnabled());
+  std::atomic<int> nGood{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < 50; i++) {
+        std::unique_ptr<TH1F> h(CcdbApi::extractFromImage<TH1F>(image->data(), image->size()));
+        if (h && h->GetEntries() == 100 && h->GetBinContent(51) == 50 && h->GetDirectory() == nullptr) {
+          nGood++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(nGood.load(), 8 * 50);
+
+  // an invalid image or a wrong type give nullptr
+  std::vector<char> garbage(1000, 'x');
+  BOOST_CHECK(CcdbApi::extractFromImage<TH1F>(garbage.data(), garbage.size()) == nullptr);
+  BOOST_CHECK(CcdbApi::extractFromImage<std::string>(image->data(), image->size()) == nullptr);
+
+  CcdbApi::enableConcurrentDeserialization(false);
+  std::unique_ptr<TH1F> h(CcdbApi::extractFromImage<TH1F>(image->data(), image->size()));
+  BOOST_CHECK(h && h->GetEntries() == 100);
+}
@@ -0,0 +1,220 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCcdbApiLocalCache.cxx
+/// \brief  Test the concurrent prefetching of objects and the persistent local object cache
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CcdbApi.h"
+#include "CCDB/BasicCCDBManager.h"
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace o2::ccdb;
+namespace fs = boost::filesystem;
+
+namespace
+{
+/// A minimal stand-in of the CCDB server, serving the objects from the files <path>/<valid from>_<valid until>
+/// of a local directory. As the real server, it redirects the queries to the content locations.
+class FileServer
+{
+ public:
+  FileServer(std::string const& dir) : mDir(dir)
+  {
+    mSocket = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    bind(mSocket, reinterpret_cast<sockaddr*>(&address), length);
+    listen(mSocket, 64);
+    getsockname(mSocket, reinterpret_cast<sockaddr*>(&address), &length);
+    mPort = ntohs(address.sin_port);
+    mThread = std::thread([this]() { run(); });
+  }
+
+  ~FileServer()
+  {
+    mStop = true;
+    mThread.join();
+    close(mSocket);
+  }
+
+  std::string getURL() const { return "http://127.0.0.1:" + std::to_string(mPort); }
+  int getNRequests() const { return mNRequests; }
+
+ private:
+  void run()
+  {
+    while (!mStop) {
+      pollfd fd{mSocket, POLLIN, 0};
+      if (poll(&fd, 1, 50) <= 0) {
+        continue;
+      }
+      int connection = accept(mSocket, nullptr, nullptr);
+      if (connection < 0) {
+        continue;
+      }
+      std::string request;
+      char buffer[4096];
+      ssize_t n = 0;
+      while (request.find("\r\n\r\n") == std::string::npos && (n = read(connection, buffer, sizeof(buffer))) > 0) {
+        request.append(buffer, n);
+      }
+      mNRequests++;
+      auto reply = serve(request.substr(0, request.find("\r\n")));
+      for (size_t written = 0; written < reply.size() && (n = write(connection, reply.data() + written, reply.size() - written)) > 0;) {
+        written += n;
+      }
+      close(connection);
+    }
+  }
+
+  std::string serve(std::string const& requestLine)
+  {
+    std::vector<std::string> tokens;
+    boost::split(tokens, requestLine, boost::is_any_of(" "));
+    if (tokens.size() < 2) {
+      return "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    std::string target = tokens[1];
+    if (target.find("/download/") == 0) {
+      std::ifstream file((fs::path(mDir) / target.substr(10)).string(), std::ios::binary);
+      std::stringstream content;
+      content << file.rdbuf();
+      auto body = content.str();
+      return "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    }
+    // <path>/<timestamp>/[<metadata>/]
+    std::vector<std::string> components;
+    boost::trim_if(target, boost::is_any_of("/"));
+    boost::split(components, target, boost::is_any_of("/"));
+    auto timestampIt = std::find_if(components.begin(), components.end(), [](std::string const& c) { return boost::all(c, boost::is_digit()); });
+    if (timestampIt == components.end()) {
+      return "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    auto path = boost::join(std::vector<std::string>(components.begin(), timestampIt), "/");
+    auto timestamp = std::stol(*timestampIt);
+    boost::system::error_code ec;
+    for (fs::directory_iterator it(fs::path(mDir) / path, ec), end; !ec && it != end; it.increment(ec)) {
+      std::vector<std::string> validity;
+      auto name = it->path().filename().string();
+      boost::split(validity, name, boost::is_any_of("_"));
+      if (timestamp >= std::stol(validity[0]) && timestamp < std::stol(validity[1])) {
+        return "HTTP/1.1 303 See Other\r\nLocation: /download/" + path + "/" + name + "\r\nValid-From: " + validity[0] +
+               "\r\nValid-Until: " + validity[1] + "\r\nETag: \"" + path + name + "\"\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+      }
+    }
+    return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+  }
+
+  std::string mDir;
+  int mSocket = -1;
+  int mPort = 0;
+  std::atomic<bool> mStop{false};
+  std::atomic<int> mNRequests{0};
+  std::thread mThread;
+};
+
+void storeInServer(std::string const& dir, std::string const& path, std::string const& object, long start, long stop)
+{
+  auto image = CcdbApi::createObjectImage(&object);
+  fs::create_directories(fs::path(dir) / path);
+  std::ofstream file((fs::path(dir) / path / (std::to_string(start) + "_" + std::to_string(stop))).string(), std::ios::binary);
+  file.write(image->data(), image->size());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestPrefetchAndLocalCache)
+{
+  auto top = fs::temp_directory_path() / fs::unique_path("ccdb-localcache-%%%%-%%%%");
+  auto serverDir = (top / "server").string();
+  auto cacheDir = (top / "cache").string();
+  storeInServer(serverDir, "Test/CacheA", "objectA", 1000, 2000);
+  storeInServer(serverDir, "Test/CacheA", "objectAN", 2000, 3000);
+  storeInServer(serverDir, "Test/CacheB", "objectB", 1000, 2000);
+  FileServer server(serverDir);
+  std::map<std::string, std::string> md;
+
+  {
+    CcdbApi api;
+    api.init(server.getURL());
+    api.setLocalObjectCache(cacheDir);
+    // the missing object is reported, the others are downloaded by following the redirection
+    BOOST_CHECK_EQUAL(api.prefetch({"Test/CacheA", "Test/CacheB", "Test/Missing"}, md, 1500), 2);
+    BOOST_CHECK_EQUAL(server.getNRequests(), 5);
+    // nothing is downloaded again
+    BOOST_CHECK_EQUAL(api.prefetch({"Test/CacheA", "Test/CacheB"}, md, 1600), 2);
+    BOOST_CHECK_EQUAL(server.getNRequests(), 5);
+  }
+
+  // another process is served from the local object cache
+  CcdbApi api;
+  api.init(server.getURL());
+  api.setLocalObjectCache(cacheDir);
+  std::map<std::string, std::string> headers;
+  auto objA = api.retrieveFromTFileAny<std::string>("Test/CacheA", md, 1700, &headers);
+  BOOST_CHECK(objA && *objA == "objectA");
+  BOOST_CHECK_EQUAL(headers["Valid-From"], "1000");
+  BOOST_CHECK_EQUAL(headers["Valid-Until"], "2000");
+  BOOST_CHECK_EQUAL(server.getNRequests(), 5);
+
+  // the object in possession of the caller is not extracted again
+  headers.clear();
+  auto etag = "\"Test/CacheA1000_2000\"";
+  BOOST_CHECK(api.retrieveFromTFileAny<std::string>("Test/CacheA", md, 1700, &headers, etag) == nullptr);
+  BOOST_CHECK(headers.count("Error") == 0);
+  BOOST_CHECK_EQUAL(headers["ETag"], etag);
+
+  // a timestamp outside of the cached validity goes to the server and the result is cached
+  auto objAN = api.retrieveFromTFileAny<std::string>("Test/CacheA", md, 2500);
+  BOOST_CHECK(objAN && *objAN == "objectAN");
+  BOOST_CHECK_EQUAL(server.getNRequests(), 7);
+  delete objAN;
+  objAN = api.retrieveFromTFileAny<std::string>("Test/CacheA", md, 2600);
+  BOOST_CHECK(objAN && *objAN == "objectAN");
+  BOOST_CHECK_EQUAL(server.getNRequests(), 7);
+
+  // the objects cached with other metadata are not used
+  std::map<std::string, std::string> otherMd{{"key", "value"}};
+  BOOST_CHECK_EQUAL(api.prefetch({"Test/CacheB"}, otherMd, 1500), 1);
+  BOOST_CHECK_EQUAL(server.getNRequests(), 9);
+
+  // the manager
+  CCDBManagerInstance cdb(server.getURL());
+  cdb.setLocalObjectCache(cacheDir);
+  cdb.setTimestamp(1500);
+  BOOST_CHECK_EQUAL(cdb.prefetch({"Test/CacheA", "Test/CacheB"}), 2);
+  auto objB = cdb.get<std::string>("Test/CacheB");
+  BOOST_CHECK(objB && *objB == "objectB");
+  BOOST_CHECK_EQUAL(server.getNRequests(), 9);
+
+  delete objA;
+  delete objAN;
+  fs::remove_all(top);
+}
@@ -0,0 +1,107 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MagFieldGrid.h
+/// \brief Definition of the cached magnetic field on a regular grid MagFieldGrid
+
+#ifndef ALICEO2_FIELD_MAGFIELDGRID_H_
+#define ALICEO2_FIELD_MAGFIELDGRID_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace o2
+{
+namespace field
+{
+class MagneticField;
+
+/// Magnetic field cached in the nodes of a regular cartesian grid and trilinearly interpolated
+/// between them, for the fast online use. The nodes are filled from the batch evaluation of the
+/// MagneticField. After the filling the interpolation is compared to the exact field at the centres,
+/// the face centres and the edge midpoints of every cell, and the grid is refined until the largest
+/// deviation of any component does not exceed the requested tolerance. The deviation at the midpoints
+/// of the edges along a single axis is due to the curvature of the field along this axis only, so
+/// only the axes where it is significant are refined.
+/// Since the cached values include the field scaling factors, the grid must be rebuilt if these change.
+class MagFieldGrid
+{
+ public:
+  MagFieldGrid() = default;
+  ~MagFieldGrid() = default;
+
+  /// Fill the grid in the box [xyzMin : xyzMax] starting from the step (in cm), halving it along the axes
+  /// responsible for the deviation while the max deviation (in kG) from the exact field is above
+  /// maxDeviation and the number of nodes does not exceed maxNodes.
+  /// Returns false if the requested precision could not be reached.
+  bool init(const MagneticField& field, const std::array<float, 3>& xyzMin, const std::array<float, 3>& xyzMax,
+            float step, float maxDeviation, std::size_t maxNodes = 20000000);
+
+  /// Interpolate the field at the point, return false if it is outside of the grid
+  bool Field(const double xyz[3], double bxyz[3]) const { return interpolate(xyz, bxyz); }
+  bool Field(const float xyz[3], float bxyz[3]) const { return interpolate(xyz, bxyz); }
+
+  bool isInitialized() const { return !mB.empty(); }
+  float getStep(int dim) const { return mStep[dim]; }
+  int getNNodes(int dim) const { return mNNodes[dim]; }
+  float getMaxDeviation() const { return mMaxDeviation; }
+
+ private:
+  template <typename T>
+  bool interpolate(const T* xyz, T* bxyz) const;
+
+  /// fill the nodes for the given number of cells in each dimension
+  void fill(const MagneticField& field, const std::array<int, 3>& nCells);
+  /// return the max deviation from the exact field in the cell check points, and the one in the midpoints
+  /// of the edges along each axis
+  float checkDeviation(const MagneticField& field, std::array<float, 3>& axisDeviation) const;
+
+  std::array<float, 3> mMin{};     ///< lower corner of the grid
+  std::array<float, 3> mMax{};     ///< upper corner of the grid
+  std::array<float, 3> mStep{};    ///< cell size in each dimension
+  std::array<float, 3> mStepInv{}; ///< inverse cell size
+  std::array<int, 3> mNNodes{};    ///< number of nodes in each dimension
+  float mMaxDeviation = 0.f;       ///< max deviation from the exact field found at the initialization
+  std::vector<float> mB;           ///< Bx,By,Bz in the nodes, X running fastest
+};
+
+template <typename T>
+inline bool MagFieldGrid::interpolate(const T* xyz, T* bxyz) const
+{
+  int ib[3];
+  float dx[3];
+  for (int i = 0; i < 3; i++) {
+    float u = (xyz[i] - mMin[i]) * mStepInv[i];
+    if (!(u >= 0.f && u < mNNodes[i] - 1)) { // also rejects NaN and non-initialized grid
+      return false;
+    }
+    ib[i] = int(u);
+    dx[i] = u - ib[i];
+  }
+  const int sx = 3, sy = 3 * mNNodes[0], sz = sy * mNNodes[1];
+  const float* b000 = &mB[3 * ((ib[2] * mNNodes[1] + ib[1]) * mNNodes[0] + ib[0])];
+  for (int c = 0; c < 3; c++) {
+    const float* bc = b000 + c;
+    float c00 = bc[0] + dx[0] * (bc[sx] - bc[0]);
+    float c10 = bc[sy] + dx[0] * (bc[sy + sx] - bc[sy]);
+    float c01 = bc[sz] + dx[0] * (bc[sz + sx] - bc[sz]);
+    float c11 = bc[sz + sy] + dx[0] * (bc[sz + sy + sx] - bc[sz + sy]);
+    float c0 = c00 + dx[1] * (c10 - c00);
+    float c1 = c01 + dx[1] * (c11 - c01);
+    bxyz[c] = c0 + dx[2] * (c1 - c0);
+  }
+  return true;
+}
+
+} // namespace field
+} // namespace o2
+
+#endif
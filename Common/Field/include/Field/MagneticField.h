@@ -19,6 +19,7 @@
 #include "Field/MagFieldParam.h"
 #include "Field/MagneticWrapperChebyshev.h" // for MagneticWrapperChebyshev
 #include "Field/MagFieldFast.h"
+#include "Field/MagFieldGrid.h"
 #include "TSystem.h"
 #include "Rtypes.h" // for Double_t, Char_t, Int_t, Float_t, etc
 #include "TNamed.h" // for TNamed
@@ -77,6 +78,11 @@ class MagneticField : public FairField
   /// allow fast field param
   void AllowFastField(bool v = true);
 
+  /// allow the field cached on the regular grid covering |x|,|y| < halfSizeXY, |z| < halfSizeZ and trilinearly
+  /// interpolated, with the max deviation (in kG) from the exact field. Returns false if it could not be built
+  bool AllowGridField(bool v = true, float maxDeviation = 1.e-2, float halfSizeXY = 260., float halfSizeZ = 260.,
+                      float step = 5.);
+
   /// Virtual methods from FairField
 
   /// X component, avoid using since slow
@@ -106,6 +112,10 @@ class MagneticField : public FairField
   /// Main interface from TVirtualMagField used in simulation
   void Field(const Double_t* __restrict__ point, Double_t* __restrict__ bField) override;
 
+  /// Method to calculate the field at np points, with point and bField holding x,y,z triplets.
+  /// The points in the measured map are evaluated at once, grouped by parameterization piece
+  void fieldBatch(int np, const Double_t* point, Double_t* bField) const;
+
   /// 3d field query alias for Alias Method to calculate the field at point xyz
   void GetBxyz(const Double_t p[3], Double_t* b) override { MagneticField::Field(p, b); }
 
@@ -133,6 +143,9 @@ class MagneticField : public FairField
   /// get fast field direct pointer
   const MagFieldFast* getFastField() const { return mFastField.get(); }
 
+  /// get cached grid field direct pointer
+  const MagFieldGrid* getGridField() const { return mGridField.get(); }
+
   // Former MagF methods or their aliases
 
   /// Sets the sign/scale of the current in the L3 according to sPolarityConvention
@@ -214,6 +227,7 @@ class MagneticField : public FairField
  private:
   std::unique_ptr<MagneticWrapperChebyshev> mMeasuredMap; //! Measured part of the field map
   std::unique_ptr<MagFieldFast> mFastField;               // ! optional fast parametrization
+  std::unique_ptr<MagFieldGrid> mGridField;               //! optional cached grid interpolation
   MagFieldParam::BMap_t mMapType;                         ///< field map type
   Double_t mSolenoid;                                     ///< Solenoid field setting
   MagFieldParam::BeamType_t mBeamType;                    ///< Beam type: A-A (mBeamType=0) or p-p (mBeamType=1)
@@ -209,6 +209,11 @@ class MagneticWrapperChebyshev : public TNamed
   /// it gets it at closest valid point
   virtual void Field(const Double_t* xyz, Double_t* b) const;
 
+  /// Computes field in cartesian coordinates for np points, with xyz and b holding x,y,z triplets.
+  /// The points are grouped by the parameterization piece and evaluated in SIMD batches. Unlike
+  /// Field, it does not use the temporaries of the parameterization, so it can be called concurrently
+  void fieldBatch(int np, const Double_t* xyz, Double_t* b) const;
+
   /// Computes Bz for the point in cartesian coordinates. If point is outside of the parameterized region
   /// it gets it at closest valid point
   Double_t getBz(const Double_t* xyz) const;
@@ -0,0 +1,148 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MagFieldGrid.cxx
+/// \brief Implementation of the cached magnetic field on a regular grid MagFieldGrid
+
+#include "Field/MagFieldGrid.h"
+#include "Field/MagneticField.h"
+#include "FairLogger.h" // for FairLogger
+#include <algorithm>
+#include <cmath>
+
+using namespace o2::field;
+
+//_______________________________________________________________________
+bool MagFieldGrid::init(const MagneticField& field, const std::array<float, 3>& xyzMin, const std::array<float, 3>& xyzMax,
+                        float step, float maxDeviation, size_t maxNodes)
+{
+  if (step <= 0.f || xyzMin[0] >= xyzMax[0] || xyzMin[1] >= xyzMax[1] || xyzMin[2] >= xyzMax[2]) {
+    LOG(ERROR) << "MagFieldGrid::init: invalid grid definition, step " << step;
+    return false;
+  }
+  mMin = xyzMin;
+  mMax = xyzMax;
+  std::array<int, 3> nCells;
+  for (int i = 0; i < 3; i++) {
+    nCells[i] = std::max(1, int(std::ceil((mMax[i] - mMin[i]) / step)));
+  }
+  auto getNNodes = [](const std::array<int, 3>& nc) { return size_t(nc[0] + 1) * (nc[1] + 1) * (nc[2] + 1); };
+  if (getNNodes(nCells) > maxNodes) {
+    LOG(ERROR) << "MagFieldGrid::init: the initial step " << step << " cm requires more than " << maxNodes << " nodes";
+    return false;
+  }
+  while (true) {
+    fill(field, nCells);
+    std::array<float, 3> axisDev;
+    mMaxDeviation = checkDeviation(field, axisDev);
+    LOG(INFO) << "MagFieldGrid::init: steps " << mStep[0] << " " << mStep[1] << " " << mStep[2]
+              << " cm, max deviation " << mMaxDeviation << " kG, along the axes " << axisDev[0] << " "
+              << axisDev[1] << " " << axisDev[2] << " kG";
+    if (mMaxDeviation <= maxDeviation) {
+      return true;
+    }
+    // the deviations due to the different axes add up, so the axes contributing significantly are refined,
+    // at least the worst one. If it is not possible to refine all of them, only the worst one is
+    int worst = std::max_element(axisDev.begin(), axisDev.end()) - axisDev.begin();
+    auto refined = nCells;
+    for (int i = 0; i < 3; i++) {
+      if (i == worst || axisDev[i] > maxDeviation / 3) {
+        refined[i] *= 2;
+      }
+    }
+    if (getNNodes(refined) > maxNodes) {
+      refined = nCells;
+      refined[worst] *= 2;
+    }
+    if (getNNodes(refined) > maxNodes) {
+      LOG(ERROR) << "MagFieldGrid::init: max deviation " << maxDeviation << " kG is not reached with "
+                 << maxNodes << " nodes, last deviation: " << mMaxDeviation << " kG";
+      mB.clear();
+      mB.shrink_to_fit();
+      mNNodes.fill(0);
+      mStepInv.fill(0.f);
+      return false;
+    }
+    nCells = refined;
+  }
+}
+
+//_______________________________________________________________________
+void MagFieldGrid::fill(const MagneticField& field, const std::array<int, 3>& nCells)
+{
+  for (int i = 0; i < 3; i++) {
+    mNNodes[i] = nCells[i] + 1;
+    mStep[i] = (mMax[i] - mMin[i]) / nCells[i];
+    mStepInv[i] = 1.f / mStep[i];
+  }
+  const int nxy = mNNodes[0] * mNNodes[1];
+  mB.resize(3 * size_t(nxy) * mNNodes[2]);
+  std::vector<double> xyz(3 * nxy), b(3 * nxy);
+
+  // fill the nodes, one XY plane per batch
+  for (int iz = 0; iz < mNNodes[2]; iz++) {
+    int ip = 0;
+    for (int iy = 0; iy < mNNodes[1]; iy++) {
+      for (int ix = 0; ix < mNNodes[0]; ix++) {
+        xyz[ip++] = mMin[0] + ix * mStep[0];
+        xyz[ip++] = mMin[1] + iy * mStep[1];
+        xyz[ip++] = mMin[2] + iz * mStep[2];
+      }
+    }
+    field.fieldBatch(nxy, xyz.data(), b.data());
+    std::copy(b.begin(), b.end(), mB.begin() + 3 * size_t(nxy) * iz);
+  }
+}
+
+//_______________________________________________________________________
+float MagFieldGrid::checkDeviation(const MagneticField& field, std::array<float, 3>& axisDeviation) const
+{
+  // Check the interpolation in the points shifted by half a step from the nodes along any subset of the axes:
+  // the edge midpoints (1 axis), the face centres (2 axes) and the cell centres (3 axes).
+  // The points on the upper faces of the grid, formally outside of it, are moved inside by a small fraction of the step.
+  float maxDev = 0.f;
+  const float uMax[3] = {mNNodes[0] - 1.001f, mNNodes[1] - 1.001f, mNNodes[2] - 1.001f};
+  axisDeviation.fill(0.f);
+  const int nxy = mNNodes[0] * mNNodes[1];
+  std::vector<double> xyz(3 * nxy), b(3 * nxy);
+  for (int shifted = 1; shifted < 8; shifted++) { // bit i set: shifted along the axis i
+    float off[3];
+    for (int i = 0; i < 3; i++) {
+      off[i] = (shifted & (1 << i)) ? 0.5f : 0.f;
+    }
+    const int axis = (shifted == 1 || shifted == 2 || shifted == 4) ? shifted >> 1 : -1; // 1 -> 0, 2 -> 1, 4 -> 2
+    for (int iz = 0; iz < mNNodes[2] - (off[2] > 0.f); iz++) {
+      int np = 0;
+      for (int iy = 0; iy < mNNodes[1] - (off[1] > 0.f); iy++) {
+        for (int ix = 0; ix < mNNodes[0] - (off[0] > 0.f); ix++) {
+          xyz[3 * np] = mMin[0] + std::min(ix + off[0], uMax[0]) * mStep[0];
+          xyz[3 * np + 1] = mMin[1] + std::min(iy + off[1], uMax[1]) * mStep[1];
+          xyz[3 * np + 2] = mMin[2] + std::min(iz + off[2], uMax[2]) * mStep[2];
+          np++;
+        }
+      }
+      field.fieldBatch(np, xyz.data(), b.data());
+      double bint[3];
+      for (int ip = 0; ip < np; ip++) {
+        if (!interpolate(&xyz[3 * ip], bint)) {
+          continue; // cannot happen
+        }
+        for (int i = 0; i < 3; i++) {
+          float dev = std::abs(bint[i] - b[3 * ip + i]);
+          maxDev = std::max(maxDev, dev);
+          if (axis >= 0) {
+            axisDeviation[axis] = std::max(axisDeviation[axis], dev);
+          }
+        }
+      }
+    }
+  }
+  return maxDev;
+}
@@ -20,6 +20,7 @@
 #include "FairParamList.h"
 #include "FairRun.h"
 #include "FairRuntimeDb.h"
+#include <vector>
 
 using namespace o2::field;
 
@@ -65,6 +66,7 @@ MagneticField::MagneticField()
   : FairField(),
     mMeasuredMap(nullptr),
     mFastField(nullptr),
+    mGridField(nullptr),
     mMapType(MagFieldParam::k5kG),
     mSolenoid(0),
     mBeamType(MagFieldParam::kNoBeamField),
@@ -94,6 +96,7 @@ MagneticField::MagneticField(const char* name, const char* title, Double_t facto
   : FairField(name, title),
     mMeasuredMap(nullptr),
     mFastField(nullptr),
+    mGridField(nullptr),
     mMapType(maptype),
     mSolenoid(0),
     mBeamType(bt),
@@ -123,6 +126,7 @@ MagneticField::MagneticField(const MagFieldParam& param)
   : FairField(param.GetName(), param.GetTitle()),
     mMeasuredMap(nullptr),
     mFastField(nullptr),
+    mGridField(nullptr),
     mMapType(param.GetMapType()),
     mSolenoid(0),
     mBeamType(param.GetBeamType()),
@@ -259,6 +263,9 @@ void MagneticField::Field(const Double_t* __restrict__ xyz, Double_t* __restrict
    */
 
   //  b[0]=b[1]=b[2]=0.0;
+  if (mGridField && mGridField->Field(xyz, b)) {
+    return;
+  }
   if (mFastField && mFastField->Field(xyz, b)) {
     return;
   }
@@ -279,12 +286,56 @@ void MagneticField::Field(const Double_t* __restrict__ xyz, Double_t* __restrict
   }
 }
 
+void MagneticField::fieldBatch(int np, const Double_t* xyz, Double_t* b) const
+{
+  /*
+   * query field values at np points, the points in the measured map are evaluated in one batch
+   */
+
+  std::vector<int> mapPoints;
+  std::vector<Double_t> mapXYZ, mapB;
+  for (int ip = 0; ip < np; ip++) {
+    const Double_t* pnt = xyz + 3 * ip;
+    Double_t* bp = b + 3 * ip;
+    if (mGridField && mGridField->Field(pnt, bp)) {
+      continue;
+    }
+    if (mFastField && mFastField->Field(pnt, bp)) {
+      continue;
+    }
+    if (mMeasuredMap && pnt[2] > mMeasuredMap->getMinZ() && pnt[2] < mMeasuredMap->getMaxZ()) {
+      mapPoints.push_back(ip);
+      mapXYZ.insert(mapXYZ.end(), pnt, pnt + 3);
+    } else {
+      MachineField(pnt, bp);
+    }
+  }
+  if (mapPoints.empty()) {
+    return;
+  }
+  mapB.resize(mapXYZ.size());
+  mMeasuredMap->fieldBatch(mapPoints.size(), mapXYZ.data(), mapB.data());
+  for (size_t i = 0; i < mapPoints.size(); i++) {
+    Double_t* bp = b + 3 * mapPoints[i];
+    double fact = (mapXYZ[3 * i + 2] > sSolenoidToDipoleZ || mDipoleOnOffFlag) ? mMultipicativeFactorSolenoid : mMultipicativeFactorDipole;
+    for (int j = 3; j--;) {
+      bp[j] = mapB[3 * i + j] * fact;
+    }
+  }
+}
+
 Double_t MagneticField::getBz(const Double_t* xyz) const
 {
   /*
    * query field Bz component at point
    */
 
+  if (mGridField) {
+    double b[3];
+    if (mGridField->Field(xyz, b)) {
+      return b[2];
+    }
+  }
   if (mFastField) {
     double bz = 0;
     if (mFastField->GetBz(xyz, bz)) {
@@ -322,6 +373,7 @@ MagneticField& MagneticField::operator=(const MagneticField& src)
     mDipoleOnOffFlag = src.mDipoleOnOffFlag;
     mParameterNames = src.mParameterNames;
     mFastField.reset(src.mFastField ? new MagFieldFast(*src.getFastField()) : nullptr);
+    mGridField.reset(src.mGridField ? new MagFieldGrid(*src.getGridField()) : nullptr);
   }
   return *this;
 }
@@ -485,6 +537,10 @@ void MagneticField::setFactorSolenoid(Float_t fc)
   if (mFastField) {
     mFastField->setFactorSol(getFactorSolenoid());
   }
+  if (mGridField) {
+    LOG(WARNING) << "MagneticField::setFactorSolenoid: cached field grid is dropped, call AllowGridField to rebuild it";
+    mGridField.reset(nullptr);
+  }
 }
 
 void MagneticField::setFactorDipole(Float_t fc)
@@ -500,6 +556,10 @@ void MagneticField::setFactorDipole(Float_t fc)
       mMultipicativeFactorDipole = fc;
       break; // case kConvMap2005: mMultipicativeFactorDipole =  fc; break;
   }
+  if (mGridField) {
+    LOG(WARNING) << "MagneticField::setFactorDipole: cached field grid is dropped, call AllowGridField to rebuild it";
+    mGridField.reset(nullptr);
+  }
 }
 
 Double_t MagneticField::getFactorSolenoid() const
@@ -677,3 +737,18 @@ void MagneticField::AllowFastField(bool v)
     mFastField.reset(nullptr);
   }
 }
+
+bool MagneticField::AllowGridField(bool v, float maxDeviation, float halfSizeXY, float halfSizeZ, float step)
+{
+  mGridField.reset(nullptr); // the grid is filled from the exact field
+  if (!v) {
+    return true;
+  }
+  auto grid = std::make_unique<MagFieldGrid>();
+  if (!grid->init(*this, {-halfSizeXY, -halfSizeXY, -halfSizeZ}, {halfSizeXY, halfSizeXY, halfSizeZ}, step, maxDeviation)) {
+    LOG(ERROR) << "MagneticField::AllowGridField: failed to build the field grid, the exact field will be used";
+    return false;
+  }
+  mGridField = std::move(grid);
+  return true;
+}
@@ -24,6 +24,9 @@
 #include "TNamed.h"     // for TNamed
 #include "TObjArray.h"  // for TObjArray
 #include "TString.h"    // for TString
+#include <algorithm>    // for sort, min
+#include <utility>      // for pair
+#include <vector>       // for vector
 
 using namespace o2::field;
 using namespace o2::math_utils;
@@ -444,6 +447,77 @@ void MagneticWrapperChebyshev::Field(const Double_t* xyz, Double_t* b) const
   par->Eval(xyz, b);
 }
 
+void MagneticWrapperChebyshev::fieldBatch(int np, const Double_t* xyz, Double_t* b) const
+{
+  constexpr int NLanes = Vc::float_v::Size;
+  std::vector<std::pair<int, int>> pieces; // parameterization piece (dipole ones after solenoid ones) and point
+  std::vector<Double_t> rphiz(3 * np);
+  pieces.reserve(np);
+
+  for (int ip = 0; ip < np; ip++) {
+    const Double_t* pnt = xyz + 3 * ip;
+    Double_t* bp = b + 3 * ip;
+    bp[0] = bp[1] = bp[2] = 0;
+    if (pnt[2] > mMinZSolenoid) {
+      Double_t* rpz = &rphiz[3 * ip];
+      cartesianToCylindrical(pnt, rpz);
+      int id = findSolenoidSegment(rpz);
+      if (id < 0) {
+        continue;
+      }
+#ifndef _BRING_TO_BOUNDARY_
+      if (!getParameterSolenoid(id)->isInside(rpz)) {
+        continue;
+      }
+#endif
+      pieces.emplace_back(id, ip);
+    } else {
+      int iddip = findDipoleSegment(pnt);
+      if (iddip < 0) {
+        continue;
+      }
+#ifndef _BRING_TO_BOUNDARY_
+      if (!getParameterDipole(iddip)->isInside(pnt)) {
+        continue;
+      }
+#endif
+      pieces.emplace_back(mNumberOfParameterizationSolenoid + iddip, ip);
+    }
+  }
+  std::sort(pieces.begin(), pieces.end());
+
+  Vc::float_v par[3], res[3];
+  for (size_t beg = 0, end = 0; beg < pieces.size(); beg = end) {
+    int id = pieces[beg].first;
+    while (end < pieces.size() && pieces[end].first == id) {
+      end++;
+    }
+    bool isSolenoid = id < mNumberOfParameterizationSolenoid;
+    const Chebyshev3D* cheb = isSolenoid ? getParameterSolenoid(id) : getParameterDipole(id - mNumberOfParameterizationSolenoid);
+    for (size_t first = beg; first < end; first += NLanes) {
+      int nl = std::min(size_t(NLanes), end - first);
+      for (int il = 0; il < NLanes; il++) {
+        int ip = pieces[first + std::min(il, nl - 1)].second; // unused lanes repeat the last point
+        const Double_t* loc = isSolenoid ? &rphiz[3 * ip] : xyz + 3 * ip;
+        for (int i = 3; i--;) {
+          par[i][il] = loc[i];
+        }
+      }
+      cheb->Eval(par, res);
+      for (int il = 0; il < nl; il++) {
+        int ip = pieces[first + il].second;
+        Double_t* bp = b + 3 * ip;
+        for (int i = 3; i--;) {
+          bp[i] = res[i][il];
+        }
+        if (isSolenoid) { // convert field to cartesian system
+          cylindricalToCartesianCylB(&rphiz[3 * ip], bp, bp);
+        }
+      }
+    }
+  }
+}
+
 Double_t MagneticWrapperChebyshev::getBz(const Double_t* xyz) const
 {
   Double_t rphiz[3];
@@ -16,6 +16,8 @@
 #include "Field/MagneticField.h"
 #include "Field/MagFieldFast.h"
 #include <memory>
+#include <vector>
+#include <algorithm>
 #include "FairLogger.h" // for FairLogger
 #include <TStopwatch.h>
 #include <TRandom.h>
@@ -97,3 +99,85 @@ BOOST_AUTO_TEST_CASE(MagneticField_test)
     BOOST_CHECK(TMath::Abs(rms[i] / nomBz) < 1.e-3);
   }
 }
+
+BOOST_AUTO_TEST_CASE(MagneticFieldBatch_test)
+{
+  std::unique_ptr<MagneticField> fld = std::make_unique<MagneticField>("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG);
+  const double nomBz = 5.00685;
+
+  const int ntst = 10000;
+  float rnd[3];
+  std::vector<double> xyz(3 * ntst), bScalar(3 * ntst), bBatch(3 * ntst);
+  // fill input, including points outside of the solenoid parameterization
+  for (int it = ntst; it--;) {
+    gRandom->RndmArray(3, rnd);
+    xyz[3 * it + 0] = rnd[0] * 600. * TMath::Cos(rnd[1] * TMath::Pi() * 2);
+    xyz[3 * it + 1] = rnd[0] * 600. * TMath::Sin(rnd[1] * TMath::Pi() * 2);
+    xyz[3 * it + 2] = (rnd[2] - 0.5) * 1200;
+  }
+
+  const int repFactor = 50;
+  // timing: scalar evaluation
+  TStopwatch swScalar;
+  swScalar.Start();
+  for (int ii = repFactor; ii--;) {
+    for (int it = ntst; it--;) {
+      fld->Field(&xyz[3 * it], &bScalar[3 * it]);
+    }
+  }
+  swScalar.Stop();
+
+  // timing: batch evaluation
+  TStopwatch swBatch;
+  swBatch.Start();
+  for (int ii = repFactor; ii--;) {
+    fld->fieldBatch(ntst, xyz.data(), bBatch.data());
+  }
+  swBatch.Stop();
+
+  double sS = swScalar.CpuTime() / (ntst * repFactor);
+  double sB = swBatch.CpuTime() / (ntst * repFactor);
+  LOG(INFO) << "Timing: Scalar: " << sS << " Batch: " << sB << "s/point -> factor " << (sB > 0. ? sS / sB : -1);
+
+  // batch evaluation must reproduce the scalar one up to the float precision of the parameterization
+  double maxDiff = 0.;
+  for (int i = 3 * ntst; i--;) {
+    maxDiff = std::max(maxDiff, TMath::Abs(bScalar[i] - bBatch[i]));
+  }
+  LOG(INFO) << "Max difference of batch wrt scalar evaluation: " << maxDiff << " kG";
+  BOOST_CHECK(maxDiff < 1.e-4 * nomBz);
+
+  // cached grid interpolation
+  const float maxDev = 1.e-2;
+  BOOST_CHECK(fld->AllowGridField(true, maxDev));
+  const auto* grid = fld->getGridField();
+  BOOST_REQUIRE(grid != nullptr);
+  BOOST_CHECK(grid->getMaxDeviation() <= maxDev);
+
+  // timing: grid, for the points inside of it
+  std::vector<double> bGrid(3 * ntst);
+  TStopwatch swGrid;
+  swGrid.Start();
+  int nInside = 0;
+  for (int ii = repFactor; ii--;) {
+    nInside = 0;
+    for (int it = ntst; it--;) {
+      nInside += grid->Field(&xyz[3 * it], &bGrid[3 * it]);
+    }
+  }
+  swGrid.Stop();
+  double sG = nInside ? swGrid.CpuTime() / (nInside * repFactor) : 0.;
+  LOG(INFO) << "Timing: Grid: " << sG << "s/point for " << nInside << " points inside the grid";
+
+  // the deviation at arbitrary points is bounded by the one found at the cell check points, up to the curvature of the field
+  maxDiff = 0.;
+  for (int it = ntst; it--;) {
+    if (grid->Field(&xyz[3 * it], &bGrid[3 * it])) {
+      for (int i = 3; i--;) {
+        maxDiff = std::max(maxDiff, TMath::Abs(bScalar[3 * it + i] - bGrid[3 * it + i]));
+      }
+    }
+  }
+  LOG(INFO) << "Max difference of grid wrt exact field: " << maxDiff << " kG";
+  BOOST_CHECK(maxDiff < 2 * maxDev);
+}
@@ -135,6 +135,8 @@ class Chebyshev3D : public TNamed
 
   Double_t Eval(const Double_t* par, int idim);
 
+  void Eval(const Vc::float_v* par, Vc::float_v* res) const;
+
   void evaluateDerivative(int dimd, const Float_t* par, Float_t* res);
 
   void evaluateDerivative2(int dimd1, int dimd2, const Float_t* par, Float_t* res);
@@ -300,6 +302,22 @@ inline void Chebyshev3D::Eval(const Double_t* par, Double_t* res)
   }
 }
 
+/// Evaluates Chebyshev parameterization for 3d->DimOut function in Vc::float_v::Size points at once,
+/// par[i] holding the i-th argument of every point. Does not use the temporary coefficients vector.
+inline void Chebyshev3D::Eval(const Vc::float_v* par, Vc::float_v* res) const
+{
+  Vc::float_v parInt[3];
+  for (int i = 3; i--;) {
+    parInt[i] = (par[i] - mBoundaryMappingOffset[i]) * mBoundaryMappingScale[i];
+#ifdef _BRING_TO_BOUNDARY_
+    parInt[i] = Vc::min(Vc::max(parInt[i], Vc::float_v(-1.f)), Vc::float_v(1.f));
+#endif
+  }
+  for (int i = mOutputArrayDimension; i--;) {
+    res[i] = getChebyshevCalc(i)->Eval(parInt);
+  }
+}
+
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
 inline Double_t Chebyshev3D::Eval(const Double_t* par, int idim)
 {
@@ -18,6 +18,7 @@
 #include <TNamed.h> // for TNamed
 #include <cstdio>   // for FILE, stdout
 #include "Rtypes.h" // for Float_t, UShort_t, Int_t, Double_t, etc
+#include "Vc/Vc"    // for Vc::float_v
 
 class TString;
 
@@ -147,6 +148,9 @@ class Chebyshev3DCalc : public TNamed
 
   static Float_t chebyshevEvaluation1D(Float_t x, const Float_t* array, int ncf);
 
+  /// Evaluates 1D Chebyshev parameterization for Vc::float_v::Size arguments mapped to [-1:1] interval at once
+  static Vc::float_v chebyshevEvaluation1D(Vc::float_v x, const Float_t* array, int ncf);
+
   /// Evaluates 1D Chebyshev parameterization's derivative. x is the argument mapped to [-1:1] interval
   static Float_t chebyshevEvaluation1Derivative(Float_t x, const Float_t* array, int ncf);
 
@@ -168,6 +172,8 @@ class Chebyshev3DCalc : public TNamed
 
   Double_t Eval(const Double_t* par) const;
 
+  Vc::float_v Eval(const Vc::float_v* par) const;
+
  private:
   Int_t mNumberOfCoefficients;    ///< total number of coeeficients
   Int_t mNumberOfRows;            ///< number of significant rows in the 3D coeffs matrix
@@ -212,6 +218,23 @@ inline Float_t Chebyshev3DCalc::chebyshevEvaluation1D(Float_t x, const Float_t*
   return b0 - x * b1;
 }
 
+/// Evaluates 1D Chebyshev parameterization for Vc::float_v::Size arguments mapped to [-1:1] interval at once
+inline Vc::float_v Chebyshev3DCalc::chebyshevEvaluation1D(Vc::float_v x, const Float_t* array, int ncf)
+{
+  if (ncf <= 0) {
+    return Vc::float_v::Zero();
+  }
+
+  Vc::float_v b0(array[--ncf]), b1(Vc::Zero), b2(Vc::Zero), x2 = x + x;
+
+  for (int i = ncf; i--;) {
+    b2 = b1;
+    b1 = b0;
+    b0 = array[i] + x2 * b1 - b2;
+  }
+  return b0 - x * b1;
+}
+
 /// Evaluates Chebyshev parameterization for 3D function.
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
 inline Float_t Chebyshev3DCalc::Eval(const Float_t* par) const
@@ -243,6 +266,32 @@ inline Double_t Chebyshev3DCalc::Eval(const Double_t* par) const
   }
   return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
 }
+
+/// Evaluates Chebyshev parameterization for 3D function in Vc::float_v::Size points at once.
+/// The 2D and 1D summations consume the coefficients in the same (descending) order as the lower
+/// dimension produces them, so they are accumulated on the fly and no temporary buffers are used:
+/// unlike the scalar version, this method can be called concurrently.
+/// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
+inline Vc::float_v Chebyshev3DCalc::Eval(const Vc::float_v* par) const
+{
+  const Vc::float_v x0x2 = par[0] + par[0], x1x2 = par[1] + par[1];
+  Vc::float_v r0(Vc::Zero), r1(Vc::Zero), r2(Vc::Zero);
+  for (int id0 = mNumberOfRows; id0--;) {
+    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
+    int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    Vc::float_v c0(Vc::Zero), c1(Vc::Zero), c2(Vc::Zero);
+    for (int id1 = nCLoc; id1--;) {
+      int id = id1 + col0;
+      c2 = c1;
+      c1 = c0;
+      c0 = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]) + x1x2 * c1 - c2;
+    }
+    r2 = r1;
+    r1 = r0;
+    r0 = (c0 - par[1] * c1) + x0x2 * r1 - r2;
+  }
+  return r0 - par[0] * r1;
+}
 } // namespace math_utils
 } // namespace o2
 
@@ -94,6 +94,10 @@ class RandomRing
   /// @return vector with random values
   float_v getNextValueVc()
   {
+    // the position might not be a multiple of the vector size if getNextValue() was used before
+    if (mRingPosition + float_v::size() > mRandomNumbers.size()) {
+      mRingPosition = 0;
+    }
     const float_v value = float_v(&mRandomNumbers[mRingPosition]);
     mRingPosition += float_v::size();
     if (mRingPosition >= mRandomNumbers.size()) {
@@ -29,6 +29,7 @@ struct DigiParams : public o2::conf::ConfigurableParamHelper<DigiParams> {
   std::string digitizationgeometry = "";              // with with geometry file to digitize -> leave empty as this needs to be filled by the digitizer workflow
   std::string grpfile = "";                           // which GRP file to use --> leave empty as this needs to be filled by the digitizer workflow
   bool mctruth = true;                                // whether to create labels
+  int hitCacheMB = 1024;                              // memory budget (MB) for the hits of the events used by several collisions, 0 = no caching
 
   O2ParamDef(DigiParams, "DigiParams");
 };
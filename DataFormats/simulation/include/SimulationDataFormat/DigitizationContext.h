@@ -11,6 +11,8 @@
 #ifndef ALICEO2_SIMULATIONDATAFORMAT_RUNCONTEXT_H
 #define ALICEO2_SIMULATIONDATAFORMAT_RUNCONTEXT_H
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <TChain.h>
 #include <TBranch.h>
@@ -18,6 +20,7 @@
 #include "CommonDataFormat/BunchFilling.h"
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "DataFormatsParameters/GRPObject.h"
+#include "SimulationDataFormat/HitCache.h"
 #include <GPUCommonLogger.h>
 
 namespace o2
@@ -58,7 +61,11 @@ class DigitizationContext
   int getMaxNumberParts() const { return mMaxPartNumber; }
 
   std::vector<o2::InteractionTimeRecord>& getEventRecords(bool withQED = false) { return withQED ? mEventRecordsWithQED : mEventRecords; }
-  std::vector<std::vector<o2::steer::EventPart>>& getEventParts(bool withQED = false) { return withQED ? mEventPartsWithQED : mEventParts; }
+  std::vector<std::vector<o2::steer::EventPart>>& getEventParts(bool withQED = false)
+  {
+    invalidatePartReferences(); // the parts may be modified, use the const overload for reading
+    return withQED ? mEventPartsWithQED : mEventParts;
+  }
 
   const std::vector<o2::InteractionTimeRecord>& getEventRecords(bool withQED = false) const { return withQED ? mEventRecordsWithQED : mEventRecords; }
   const std::vector<std::vector<o2::steer::EventPart>>& getEventParts(bool withQED = false) const { return withQED ? mEventPartsWithQED : mEventParts; }
@@ -96,6 +103,7 @@ class DigitizationContext
 
   /// function reading the hits from a chain (previously initialized with initSimChains
   /// The hits pointer will be initialized (what to we do about ownership??)
+  /// The hits of the events used by several collisions are read only once and then copied from the HitCache
   template <typename T>
   void retrieveHits(std::vector<TChain*> const& chains,
                     const char* brname,
@@ -103,6 +111,18 @@ class DigitizationContext
                     int entryID,
                     std::vector<T>* hits) const;
 
+  /// same as retrieveHits, but the hits of the events used by several collisions are shared with the HitCache
+  /// rather than copied
+  template <typename T>
+  std::shared_ptr<const std::vector<T>> retrieveHitsShared(std::vector<TChain*> const& chains,
+                                                           const char* brname,
+                                                           int sourceID,
+                                                           int entryID) const;
+
+  /// number of the collision parts (including QED ones) referring to the entry of the source.
+  /// The counts are filled at the first query after the parts were modified, may be queried concurrently.
+  int getNPartReferences(int sourceID, int entryID) const;
+
   /// returns the GRP object associated to this context
   o2::parameters::GRPObject const& getGRP() const;
 
@@ -128,9 +148,16 @@ class DigitizationContext
 
   o2::BunchFilling mBCFilling; // patter of active BCs
 
-  std::vector<std::string> mSimPrefixes;             // identifiers to the hit sim products; the key corresponds to the source ID of event record
-  std::string mQEDSimPrefix;                         // prefix for QED production/contribution
-  mutable o2::parameters::GRPObject* mGRP = nullptr; //!
+  std::vector<std::string> mSimPrefixes;                     // identifiers to the hit sim products; the key corresponds to the source ID of event record
+  std::string mQEDSimPrefix;                                 // prefix for QED production/contribution
+  mutable o2::parameters::GRPObject* mGRP = nullptr;         //!
+  mutable std::unordered_map<uint64_t, int> mPartReferences; //! number of parts referring to (source, entry), filled on demand
+  mutable bool mPartReferencesFilled = false;                //! whether mPartReferences corresponds to the parts
+
+  void invalidatePartReferences();
+
+  template <typename T>
+  void readHits(std::vector<TChain*> const& chains, const char* brname, int sourceID, int entryID, std::vector<T>* hits) const;
 
   ClassDefNV(DigitizationContext, 4);
 };
@@ -142,6 +169,30 @@ inline void DigitizationContext::retrieveHits(std::vector<TChain*> const& chains
                                               int sourceID,
                                               int entryID,
                                               std::vector<T>* hits) const
+{
+  if (HitCache::Instance().getMemoryBudget() && getNPartReferences(sourceID, entryID) > 1) {
+    *hits = *retrieveHitsShared<T>(chains, brname, sourceID, entryID);
+    return;
+  }
+  readHits(chains, brname, sourceID, entryID, hits);
+}
+
+template <typename T>
+inline std::shared_ptr<const std::vector<T>> DigitizationContext::retrieveHitsShared(std::vector<TChain*> const& chains,
+                                                                                      const char* brname,
+                                                                                      int sourceID,
+                                                                                      int entryID) const
+{
+  return HitCache::Instance().get<T>(sourceID, entryID, brname, getNPartReferences(sourceID, entryID),
+                                     [&](std::vector<T>* hits) { readHits(chains, brname, sourceID, entryID, hits); });
+}
+
+template <typename T>
+inline void DigitizationContext::readHits(std::vector<TChain*> const& chains,
+                                          const char* brname,
+                                          int sourceID,
+                                          int entryID,
+                                          std::vector<T>* hits) const
 {
   auto br = chains[sourceID]->GetBranch(brname);
   if (!br) {
@@ -0,0 +1,134 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file HitCache.h
+/// \brief Process-wide cache of the hits of the events used by several collisions in the digitization
+
+#ifndef ALICEO2_SIMULATIONDATAFORMAT_HITCACHE_H
+#define ALICEO2_SIMULATIONDATAFORMAT_HITCACHE_H
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace o2
+{
+namespace steer
+{
+
+/// Cache of the hits read for the (source, entry, branch), shared by all users in the process.
+/// In the embedding and pile-up productions the same (background) event may be a part of many
+/// collisions. The hits of such an event are read and deserialized at their first use only and kept
+/// until the expected number of uses (the number of the collision parts referring to the event) is
+/// reached, provided the memory budget is not exceeded. When the budget is full, the least recently
+/// used entries are evicted, so that the entries whose expected uses never come (e.g. the collisions
+/// were not digitized) do not block the cache. The hits are handed out as shared pointers,
+/// so they stay valid for the user even after they were released from the cache.
+/// The default memory budget is taken from DigiParams.hitCacheMB.
+class HitCache
+{
+ public:
+  struct Stats {
+    size_t nHits = 0;     ///< requests served from the cache
+    size_t nMisses = 0;   ///< requests which needed reading
+    size_t nRejected = 0; ///< hits not cached since they exceed the budget alone
+    size_t nEvicted = 0;  ///< entries released before their last expected use to free the budget
+    size_t memory = 0;    ///< estimated memory of the cached hits
+    size_t memoryPeak = 0;
+  };
+
+  static HitCache& Instance();
+
+  /// set the max memory (in bytes) of the cached hits, 0 disables the caching
+  void setMemoryBudget(size_t bytes);
+  size_t getMemoryBudget() const { return mMemoryBudget; }
+
+  /// Get the hits of the (source, entry, branch) from the cache, or read them with the reader, which
+  /// is called as reader(std::vector<T>*). The hits read are cached if nUses > 1 uses are expected.
+  template <typename T, typename Reader>
+  std::shared_ptr<const std::vector<T>> get(int source, int entry, const std::string& branch, int nUses, Reader&& reader);
+
+  /// release all cached hits, e.g. when the digitization of the context is finished
+  void clear();
+  Stats getStats() const;
+  void printStats() const;
+
+ private:
+  HitCache();
+  ~HitCache() = default;
+  HitCache(const HitCache&) = delete;
+  HitCache& operator=(const HitCache&) = delete;
+
+  using Key = std::tuple<int, int, std::string>;
+  struct Entry {
+    std::shared_ptr<const void> hits;
+    size_t size = 0;              // estimated memory
+    int remainingUses = 0;        // uses after which the entry is released
+    std::list<Key>::iterator lru; // position in the LRU list
+  };
+
+  void release(std::map<Key, Entry>::iterator it);
+
+  size_t mMemoryBudget = 0;
+  std::map<Key, Entry> mEntries;
+  std::list<Key> mLRUList; // keys of the entries, most recently used first
+  Stats mStats;
+  mutable std::mutex mMutex;
+};
+
+template <typename T, typename Reader>
+std::shared_ptr<const std::vector<T>> HitCache::get(int source, int entry, const std::string& branch, int nUses, Reader&& reader)
+{
+  Key key{source, entry, branch};
+  std::unique_lock<std::mutex> lock(mMutex);
+  auto it = mEntries.find(key);
+  if (it != mEntries.end()) {
+    auto hits = std::static_pointer_cast<const std::vector<T>>(it->second.hits);
+    mStats.nHits++;
+    if (--it->second.remainingUses <= 0) {
+      release(it);
+    } else {
+      mLRUList.splice(mLRUList.begin(), mLRUList, it->second.lru);
+    }
+    return hits;
+  }
+  mStats.nMisses++;
+  lock.unlock(); // don't block other users while reading
+
+  auto hits = std::make_shared<std::vector<T>>();
+  reader(hits.get());
+  if (nUses > 1 && mMemoryBudget) {
+    size_t size = sizeof(std::vector<T>) + hits->capacity() * sizeof(T);
+    lock.lock();
+    if (size > mMemoryBudget) {
+      mStats.nRejected++;
+    } else if (mEntries.find(key) == mEntries.end()) { // may have been cached meanwhile by another user
+      while (mStats.memory + size > mMemoryBudget) {
+        release(mEntries.find(mLRUList.back()));
+        mStats.nEvicted++;
+      }
+      mLRUList.push_front(key);
+      mEntries.emplace(key, Entry{hits, size, nUses - 1, mLRUList.begin()});
+      mStats.memory += size;
+      mStats.memoryPeak = std::max(mStats.memoryPeak, mStats.memory);
+    }
+  }
+  return hits;
+}
+
+} // namespace steer
+} // namespace o2
+
+#endif
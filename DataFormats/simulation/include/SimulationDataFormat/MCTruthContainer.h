@@ -233,7 +233,8 @@ class MCTruthContainer
   // Add element at last position or for a previous index
   // (at random access position).
   // This might be a slow process since data has to be moved internally
-  // so this function should be used with care.
+  // so this function should be used with care. For many out-of-order
+  // insertions use the MCTruthContainerBuilder instead.
   void addElementRandomAccess(uint32_t dataindex, TruthElement const& element)
   {
     if (dataindex >= mHeaderArray.size()) {
@@ -0,0 +1,190 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MCTruthContainerBuilder.h
+/// \brief Builder of MCTruthContainer from the labels added in arbitrary order of the data indices
+
+#ifndef O2_MCTRUTHCONTAINERBUILDER_H
+#define O2_MCTRUTHCONTAINERBUILDER_H
+
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace o2
+{
+namespace dataformats
+{
+
+/// @class MCTruthContainerBuilder
+/// @brief Collects (data index, label) pairs in arbitrary order and builds the MCTruthContainer in one go
+///
+/// Contrary to MCTruthContainer::addElementRandomAccess, which moves the stored labels and the
+/// indices of all following headers for every out-of-order insertion, the adding here is O(1):
+/// the pairs are appended to the chunked buffer of the slot (e.g. thread) which adds them.
+/// The chunks are never reallocated, so the filling does not copy the labels already added.
+/// Once all labels are added, a single stable counting sort by the data index places them either
+/// to the vectors of the MCTruthContainer or directly to the flat layout of MCTruthContainer::flatten_to
+/// (e.g. in the ConstMCTruthContainer or the output message), so no flattening copy is needed.
+/// The labels of the same data index keep the order in which they were added to the same slot,
+/// the labels of different slots follow in the order of the slots.
+/// Different slots may be filled concurrently, but every slot must be filled by one thread only.
+template <typename TruthElement>
+class MCTruthContainerBuilder
+{
+ public:
+  using FlatHeader = typename MCTruthContainer<TruthElement>::FlatHeader;
+
+  MCTruthContainerBuilder(int nSlots = 1, size_t chunkSize = 4096) : mChunkSize(chunkSize > 0 ? chunkSize : 1)
+  {
+    setNSlots(nSlots);
+  }
+
+  /// set the number of slots which can be filled concurrently, discards the added labels
+  void setNSlots(int n)
+  {
+    mSlots.clear();
+    mSlots.resize(n > 0 ? n : 1);
+  }
+  int getNSlots() const { return mSlots.size(); }
+
+  /// add the label for the data index to the buffer of the slot
+  void addElement(uint32_t dataindex, TruthElement const& element, int slot = 0)
+  {
+    auto& sl = mSlots[slot];
+    if (sl.chunks.empty() || sl.chunks.back().size() == mChunkSize) {
+      sl.chunks.emplace_back().reserve(mChunkSize);
+    }
+    sl.chunks.back().push_back(Entry{dataindex, element});
+    sl.nElements++;
+    if (dataindex >= sl.indexedSize) {
+      sl.indexedSize = dataindex + 1;
+    }
+  }
+
+  /// total number of labels added
+  size_t getNElements() const
+  {
+    size_t n = 0;
+    for (const auto& sl : mSlots) {
+      n += sl.nElements;
+    }
+    return n;
+  }
+
+  /// number of data indices to be indexed in the container: max added data index + 1
+  size_t getIndexedSize() const
+  {
+    uint32_t n = 0;
+    for (const auto& sl : mSlots) {
+      n = std::max(n, sl.indexedSize);
+    }
+    return n;
+  }
+
+  /// discard the added labels, keeping the number of slots
+  void clear()
+  {
+    for (auto& sl : mSlots) {
+      sl = Slot();
+    }
+  }
+
+  /// Fill the container with the sorted labels. The number of indexed data is the max of the
+  /// max added data index + 1 and of nIndexed (to account for the trailing data w/o labels).
+  void build(MCTruthContainer<TruthElement>& container, size_t nIndexed = 0) const
+  {
+    nIndexed = std::max(nIndexed, getIndexedSize());
+    std::vector<MCTruthHeaderElement> header(nIndexed);
+    std::vector<TruthElement> truthArray(getNElements());
+    sort(header.data(), reinterpret_cast<char*>(truthArray.data()), nIndexed);
+    container.setFrom(header, truthArray);
+  }
+
+  /// Place the sorted labels directly to the flat layout of MCTruthContainer::flatten_to in the
+  /// provided contiguous container, which can be then used as ConstMCTruthContainer or sent as is.
+  /// Returns the size of the flat buffer.
+  template <typename ContainerType>
+  size_t flatten_to(ContainerType& container, size_t nIndexed = 0) const
+  {
+    nIndexed = std::max(nIndexed, getIndexedSize());
+    const size_t nElements = getNElements();
+    size_t bufferSize = sizeof(FlatHeader) + sizeof(MCTruthHeaderElement) * nIndexed + sizeof(TruthElement) * nElements;
+    container.resize((bufferSize / sizeof(typename ContainerType::value_type)) + ((bufferSize % sizeof(typename ContainerType::value_type)) > 0 ? 1 : 0));
+    char* target = reinterpret_cast<char*>(container.data());
+    auto& flatheader = *reinterpret_cast<FlatHeader*>(target);
+    flatheader = FlatHeader();
+    flatheader.nofHeaderElements = nIndexed;
+    flatheader.nofTruthElements = nElements;
+    target += sizeof(FlatHeader);
+    sort(reinterpret_cast<MCTruthHeaderElement*>(target), target + sizeof(MCTruthHeaderElement) * nIndexed, nIndexed);
+    return bufferSize;
+  }
+
+ private:
+  struct Entry {
+    uint32_t dataindex;
+    TruthElement element;
+  };
+  struct Slot {
+    std::vector<std::vector<Entry>> chunks;
+    size_t nElements = 0;
+    uint32_t indexedSize = 0;
+  };
+
+  /// stable counting sort of the entries of all slots to the header and truth arrays, the latter may be unaligned
+  void sort(MCTruthHeaderElement* header, char* truth, size_t nIndexed) const
+  {
+    // count the labels of every data index in the header
+    for (size_t i = 0; i < nIndexed; i++) {
+      header[i].index = 0;
+    }
+    for (const auto& sl : mSlots) {
+      for (const auto& chunk : sl.chunks) {
+        for (const auto& e : chunk) {
+          header[e.dataindex].index++;
+        }
+      }
+    }
+    // convert counts to the start positions
+    uint32_t start = 0;
+    for (size_t i = 0; i < nIndexed; i++) {
+      auto cnt = header[i].index;
+      header[i].index = start;
+      start += cnt;
+    }
+    // place the labels, advancing the position of every index: it ends at the start of the next one
+    for (const auto& sl : mSlots) {
+      for (const auto& chunk : sl.chunks) {
+        for (const auto& e : chunk) {
+          memcpy(truth + sizeof(TruthElement) * header[e.dataindex].index++, &e.element, sizeof(TruthElement));
+        }
+      }
+    }
+    // restore the start positions
+    for (size_t i = nIndexed; i-- > 1;) {
+      header[i].index = header[i - 1].index;
+    }
+    if (nIndexed) {
+      header[0].index = 0;
+    }
+  }
+
+  size_t mChunkSize = 4096; ///< number of entries per chunk
+  std::vector<Slot> mSlots; ///< buffers of the slots
+};
+
+using MCLabelContainerBuilder = o2::dataformats::MCTruthContainerBuilder<o2::MCCompLabel>;
+
+} // namespace dataformats
+} // namespace o2
+
+#endif //O2_MCTRUTHCONTAINERBUILDER_H
@@ -14,6 +14,7 @@
 #include <TChain.h>
 #include <TFile.h>
 #include <iostream>
+#include <mutex>
 #include <numeric> // for iota
 #include <MathUtils/Cartesian.h>
 
@@ -59,6 +60,42 @@ void DigitizationContext::setSimPrefixes(std::vector<std::string> const& prefixe
   }
 }
 
+namespace
+{
+// the digitizers of several detectors may query the same context concurrently
+std::mutex partReferencesMutex;
+} // namespace
+
+void DigitizationContext::invalidatePartReferences()
+{
+  std::lock_guard<std::mutex> lock(partReferencesMutex);
+  mPartReferencesFilled = false;
+}
+
+int DigitizationContext::getNPartReferences(int sourceID, int entryID) const
+{
+  auto key = [](int source, int entry) { return (uint64_t(uint32_t(source)) << 32) | uint32_t(entry); };
+  std::lock_guard<std::mutex> lock(partReferencesMutex);
+  if (!mPartReferencesFilled) {
+    mPartReferences.clear();
+    for (const auto& parts : mEventParts) {
+      for (const auto& part : parts) {
+        mPartReferences[key(part.sourceID, part.entryID)]++;
+      }
+    }
+    for (const auto& parts : mEventPartsWithQED) { // the hadronic parts are already counted
+      for (const auto& part : parts) {
+        if (EventPart::isQED(part)) {
+          mPartReferences[key(part.sourceID, part.entryID)]++;
+        }
+      }
+    }
+    mPartReferencesFilled = true;
+  }
+  auto ref = mPartReferences.find(key(sourceID, entryID));
+  return ref == mPartReferences.end() ? 0 : ref->second;
+}
+
 bool DigitizationContext::initSimChains(o2::detectors::DetID detid, std::vector<TChain*>& simchains) const
 {
   if (!(simchains.size() == 0)) {
@@ -134,7 +171,7 @@ bool DigitizationContext::checkVertexCompatibility(bool verbose) const
     headers.resize(kinematicschain.size(), nullptr);
     // loop over all collisions in this context
     int collisionID = 0;
-    for (auto& collision : getEventParts()) {
+    for (const auto& collision : mEventParts) { // read only, the part references stay valid
       collisionID++;
       vertices.clear();
       for (auto& part : collision) {
@@ -242,6 +279,7 @@ void DigitizationContext::fillQED(std::string_view QEDprefix, std::vector<o2::In
 
   mEventRecordsWithQED.clear();
   mEventPartsWithQED.clear();
+  invalidatePartReferences();
   for (int i = 0; i < idx.size(); ++i) {
     mEventRecordsWithQED.push_back(combinedrecords[idx[i]]);
     mEventPartsWithQED.push_back(combinedparts[idx[i]]);
@@ -0,0 +1,67 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "SimulationDataFormat/HitCache.h"
+#include "SimConfig/DigiParams.h"
+#include "FairLogger.h"
+#include <algorithm>
+
+using namespace o2::steer;
+
+HitCache::HitCache()
+{
+  setMemoryBudget(size_t(std::max(o2::conf::DigiParams::Instance().hitCacheMB, 0)) << 20);
+}
+
+HitCache& HitCache::Instance()
+{
+  static HitCache cache;
+  return cache;
+}
+
+void HitCache::setMemoryBudget(size_t bytes)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mMemoryBudget = bytes;
+  while (mStats.memory > mMemoryBudget) {
+    release(mEntries.find(mLRUList.back()));
+    mStats.nEvicted++;
+  }
+}
+
+void HitCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mEntries.clear();
+  mLRUList.clear();
+  mStats.memory = 0;
+}
+
+void HitCache::release(std::map<Key, Entry>::iterator it)
+{
+  // must be called with the cache locked
+  mStats.memory -= it->second.size;
+  mLRUList.erase(it->second.lru);
+  mEntries.erase(it);
+}
+
+HitCache::Stats HitCache::getStats() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mStats;
+}
+
+void HitCache::printStats() const
+{
+  auto st = getStats();
+  LOG(INFO) << "HitCache: " << st.nHits << " hits, " << st.nMisses << " misses, " << st.nEvicted << " evicted, " << st.nRejected
+            << " not cached due to the budget of " << (mMemoryBudget >> 20) << " MB, memory " << (st.memory >> 20)
+            << " MB (peak " << (st.memoryPeak >> 20) << " MB)";
+}
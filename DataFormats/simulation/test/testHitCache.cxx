@@ -0,0 +1,129 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test HitCache class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "SimulationDataFormat/HitCache.h"
+#include "SimulationDataFormat/DigitizationContext.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace o2
+{
+BOOST_AUTO_TEST_CASE(HitCache_reuse)
+{
+  auto& cache = steer::HitCache::Instance();
+  cache.clear();
+  cache.setMemoryBudget(1 << 20);
+  int nRead = 0;
+  auto reader = [&nRead](std::vector<float>* hits) {
+    nRead++;
+    hits->assign(100, 1.f);
+  };
+
+  // event used by 3 collisions: read once, released after the last use
+  for (int i = 0; i < 3; i++) {
+    auto hits = cache.get<float>(0, 5, "TSTHit", 3, reader);
+    BOOST_CHECK(hits->size() == 100);
+  }
+  BOOST_CHECK(nRead == 1);
+  BOOST_CHECK(cache.getStats().memory == 0);
+
+  // the hits handed out stay valid after their release from the cache
+  auto hits0 = cache.get<float>(0, 6, "TSTHit", 2, reader);
+  auto hits1 = cache.get<float>(0, 6, "TSTHit", 2, reader);
+  BOOST_CHECK(hits0 == hits1);
+  BOOST_CHECK(hits0->size() == 100);
+  BOOST_CHECK(nRead == 2);
+
+  // the same event in another branch is a different entry, events used once are not cached
+  cache.get<float>(0, 6, "OTHHit", 1, reader);
+  cache.get<float>(0, 6, "OTHHit", 1, reader);
+  BOOST_CHECK(nRead == 4);
+  BOOST_CHECK(cache.getStats().memory == 0);
+
+  // nothing is cached beyond the budget
+  cache.setMemoryBudget(100);
+  cache.get<float>(1, 0, "TSTHit", 2, reader);
+  cache.get<float>(1, 0, "TSTHit", 2, reader);
+  BOOST_CHECK(nRead == 6);
+  BOOST_CHECK(cache.getStats().nRejected == 2);
+}
+
+BOOST_AUTO_TEST_CASE(HitCache_eviction)
+{
+  auto& cache = steer::HitCache::Instance();
+  cache.clear();
+  const size_t entrySize = sizeof(std::vector<float>) + 100 * sizeof(float);
+  cache.setMemoryBudget(2 * entrySize);
+  int nRead = 0;
+  auto reader = [&nRead](std::vector<float>* hits) {
+    nRead++;
+    hits->assign(100, 1.f);
+  };
+  auto nEvicted = cache.getStats().nEvicted;
+  // the entries whose other uses never come do not block the cache, the least recently used one is evicted
+  cache.get<float>(0, 1, "TSTHit", 3, reader);
+  cache.get<float>(0, 2, "TSTHit", 3, reader);
+  cache.get<float>(0, 1, "TSTHit", 3, reader);
+  cache.get<float>(0, 3, "TSTHit", 3, reader);
+  BOOST_CHECK(cache.getStats().nEvicted == nEvicted + 1);
+  BOOST_CHECK(cache.getStats().memory == 2 * entrySize);
+  cache.get<float>(0, 1, "TSTHit", 3, reader); // still cached
+  BOOST_CHECK(nRead == 3);
+  cache.get<float>(0, 2, "TSTHit", 3, reader); // evicted, read again
+  BOOST_CHECK(nRead == 4);
+
+  // lowering the budget and the clear release the entries
+  cache.setMemoryBudget(entrySize);
+  BOOST_CHECK(cache.getStats().memory == entrySize);
+  cache.clear();
+  BOOST_CHECK(cache.getStats().memory == 0);
+}
+
+BOOST_AUTO_TEST_CASE(DigitizationContext_partReferences)
+{
+  steer::DigitizationContext context;
+  auto& parts = context.getEventParts();
+  parts.push_back({steer::EventPart(0, 0), steer::EventPart(2, 0)});
+  parts.push_back({steer::EventPart(0, 0), steer::EventPart(2, 1)});
+  parts.push_back({steer::EventPart(0, 1), steer::EventPart(2, 2)});
+  BOOST_CHECK(context.getNPartReferences(0, 0) == 2);
+  BOOST_CHECK(context.getNPartReferences(0, 1) == 1);
+  BOOST_CHECK(context.getNPartReferences(2, 1) == 1);
+  BOOST_CHECK(context.getNPartReferences(1, 0) == 0);
+
+  // the counts follow the modification of the parts
+  context.getEventParts().push_back({steer::EventPart(0, 1)});
+  BOOST_CHECK(context.getNPartReferences(0, 1) == 2);
+
+  // the counts are filled once for the concurrent readers of the unchanged parts
+  context.getEventParts().push_back({steer::EventPart(0, 2)});
+  const auto& constContext = context;
+  std::atomic<int> nErrors{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&constContext, &nErrors]() {
+      for (int j = 0; j < 1000; j++) {
+        if (constContext.getNPartReferences(0, 2) != 1 || constContext.getEventParts().size() != 5) {
+          nErrors++;
+        }
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  BOOST_CHECK_EQUAL(nErrors.load(), 0);
+}
+} // namespace o2
@@ -14,6 +14,7 @@
 #include <boost/test/unit_test.hpp>
 #include "SimulationDataFormat/MCCompLabel.h"
 #include "SimulationDataFormat/ConstMCTruthContainer.h"
+#include "SimulationDataFormat/MCTruthContainerBuilder.h"
 #include "SimulationDataFormat/LabelContainer.h"
 #include "SimulationDataFormat/IOMCTruthContainerView.h"
 #include <algorithm>
@@ -154,6 +155,62 @@ BOOST_AUTO_TEST_CASE(MCTruth_RandomAccess)
   }
 }
 
+BOOST_AUTO_TEST_CASE(MCTruthContainer_builder)
+{
+  using TruthElement = long;
+  // same out-of-order insertions as in the MCTruth_RandomAccess test, distributed over 2 slots
+  dataformats::MCTruthContainerBuilder<TruthElement> builder(2, 2);
+  builder.addElement(0, TruthElement(1), 0);
+  builder.addElement(0, TruthElement(2), 0);
+  builder.addElement(1, TruthElement(1), 0);
+  builder.addElement(2, TruthElement(10), 1);
+  builder.addElement(1, TruthElement(5), 1);
+  builder.addElement(0, TruthElement(5), 1);
+  builder.addElement(3, TruthElement(20), 1);
+  builder.addElement(3, TruthElement(21), 1);
+  BOOST_CHECK(builder.getNElements() == 8);
+  BOOST_CHECK(builder.getIndexedSize() == 4);
+
+  dataformats::MCTruthContainer<TruthElement> container;
+  builder.build(container, 5); // last index has no labels
+  BOOST_CHECK(container.getIndexedSize() == 5);
+  BOOST_CHECK(container.getNElements() == 8);
+  BOOST_CHECK(container.getMCTruthHeader(0).index == 0);
+  BOOST_CHECK(container.getMCTruthHeader(1).index == 3);
+  BOOST_CHECK(container.getMCTruthHeader(2).index == 5);
+  BOOST_CHECK(container.getMCTruthHeader(3).index == 6);
+  BOOST_CHECK(container.getMCTruthHeader(4).index == 8);
+  BOOST_CHECK(container.getLabels(4).size() == 0);
+  {
+    auto view = container.getLabels(0);
+    BOOST_CHECK(view.size() == 3);
+    BOOST_CHECK(view[0] == 1);
+    BOOST_CHECK(view[1] == 2);
+    BOOST_CHECK(view[2] == 5);
+  }
+  {
+    auto view = container.getLabels(1);
+    BOOST_CHECK(view.size() == 2);
+    BOOST_CHECK(view[0] == 1);
+    BOOST_CHECK(view[1] == 5);
+  }
+
+  // the flat layout produced directly must be identical to the flattened container
+  std::vector<char> buffer, bufferRef;
+  BOOST_CHECK(builder.flatten_to(buffer, 5) == container.flatten_to(bufferRef));
+  BOOST_CHECK(buffer == bufferRef);
+  dataformats::ConstMCTruthContainer<TruthElement> cc;
+  builder.flatten_to(cc);
+  BOOST_CHECK(cc.getIndexedSize() == 4);
+  BOOST_CHECK(cc.getNElements() == 8);
+  BOOST_CHECK(cc.getLabels(3).size() == 2);
+  BOOST_CHECK(cc.getLabels(3)[1] == 21);
+
+  builder.clear();
+  BOOST_CHECK(builder.getNElements() == 0);
+  BOOST_CHECK(builder.getNSlots() == 2);
+}
+
 BOOST_AUTO_TEST_CASE(MCTruthContainer_flatten)
 {
   using TruthElement = long;
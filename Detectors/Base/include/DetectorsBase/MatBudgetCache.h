@@ -0,0 +1,110 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MatBudgetCache.h
+/// \brief Cache of the material budget integrated along radial lines of the MatLayerCylSet
+
+#ifndef ALICEO2_MATBUDGETCACHE_H
+#define ALICEO2_MATBUDGETCACHE_H
+
+#include "DetectorsBase/MatCell.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace o2
+{
+namespace base
+{
+class MatLayerCylSet;
+
+/// Precomputed material budget along the radial lines of the MatLayerCylSet: for every (phi, tgLambda) bin
+/// the <rho>*L, x/X0 and the length inside the layers, integrated from rMin, are stored at a set of radii
+/// (the boundaries of the LUT layers, subdivided to be not farther than maxDR from each other). A query for a
+/// segment close to radial (the phi and tgLambda of its ends differ by less than the tolerance) is answered
+/// in O(1) from the integrals at its radii, rescaled to its length. Other queries fall back to the exact ray
+/// tracing in the LUT. The cache is read-only after the initialization, so it can be queried concurrently.
+class MatBudgetCache
+{
+ public:
+  struct Params {
+    float rMin = 2.f;     ///< min radius of the cache domain
+    float rMax = 85.f;    ///< max radius of the cache domain
+    float tglMax = 1.f;   ///< max |tgLambda| (z/r) of the cache domain
+    int nPhiBins = 180;   ///< number of phi bins
+    int nTglBins = 40;    ///< number of tgLambda bins
+    float maxDR = 1.f;    ///< max radial distance between the integration nodes
+    float minDR = 0.1f;   ///< min radial span of the segment to use the cache
+    float tolPhi = 0.02f; ///< max difference of the phi of the segment ends to use the cache
+    float tolTgl = 0.02f; ///< max difference of the tgLambda of the segment ends to use the cache
+    int verifyEvery = 0;  ///< compare every N-th cache answer to the exact one for the error statistics, 0 = never
+    int nThreads = 1;     ///< number of threads to fill the cache
+  };
+
+  struct Stats {
+    size_t nQueries = 0;       ///< total number of queries
+    size_t nHits = 0;          ///< number of queries answered by the cache
+    size_t nVerified = 0;      ///< number of the answers compared to the exact ones
+    double sumRelErrX2X0 = 0.; ///< sum of |relative error| of x/X0
+    double maxRelErrX2X0 = 0.; ///< max |relative error| of x/X0
+    double sumRelErrRho = 0.; ///< sum of |relative error| of <rho>
+    double maxRelErrRho = 0.; ///< max |relative error| of <rho>
+    float getHitRate() const { return nQueries ? float(nHits) / nQueries : 0.f; }
+    float getMeanRelErrX2X0() const { return nVerified ? sumRelErrX2X0 / nVerified : 0.f; }
+    float getMeanRelErrRho() const { return nVerified ? sumRelErrRho / nVerified : 0.f; }
+  };
+
+  MatBudgetCache() = default;
+  ~MatBudgetCache() = default;
+
+  /// precompute the integrals for the LUT, which must stay alive while the cache is used
+  void init(const MatLayerCylSet* lut, const Params& par);
+  void init(const MatLayerCylSet* lut) { init(lut, Params()); }
+
+  /// get material budget traversed on the line between point0 and point1, from the cache if possible
+  MatBudget getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const;
+
+  bool isInitialized() const { return mLUT != nullptr; }
+  const Params& getParams() const { return mParams; }
+  int getNNodes() const { return mNodeR.size(); }
+
+  Stats getStats() const;
+  void resetStats();
+  void printStats() const;
+
+ private:
+  struct Integral {
+    float rhoL = 0.f; ///< integral of rho*dl from rMin
+    float x2x0 = 0.f; ///< integral of dl/X0 from rMin
+    float matL = 0.f; ///< length inside the LUT layers from rMin
+  };
+
+  Integral interpolate(const Integral* row, float r) const;
+  void verify(const MatBudget& cached, float x0, float y0, float z0, float x1, float y1, float z1) const;
+
+  const MatLayerCylSet* mLUT = nullptr;
+  Params mParams;
+  float mPhiBinInv = 0.f;
+  float mTglBinInv = 0.f;
+  float mRIndexStepInv = 0.f;
+  std::vector<float> mNodeR;    ///< radii of the integration nodes
+  std::vector<int> mRIndex;     ///< uniform radius bin -> last node below it
+  std::vector<Integral> mTable; ///< integrals at the nodes, per phi and tgLambda bin
+
+  mutable std::atomic<size_t> mNQueries{0};
+  mutable std::atomic<size_t> mNHits{0};
+  mutable std::mutex mStatsMutex; ///< protects the error statistics below
+  mutable Stats mErrStats;
+};
+
+} // namespace base
+} // namespace o2
+
+#endif
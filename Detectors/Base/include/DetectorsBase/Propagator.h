@@ -25,6 +25,7 @@
 
 #ifndef GPUCA_GPUCODE
 #include <string>
+#include <gsl/span>
 #endif
 
 namespace o2
@@ -51,6 +52,7 @@ class GPUTPCGMPolynomialField;
 
 namespace base
 {
+class MatBudgetCache;
 
 template <typename value_T>
 class PropagatorImpl
@@ -68,6 +70,7 @@ class PropagatorImpl
 
   static constexpr float MAX_SIN_PHI = 0.85f;
   static constexpr float MAX_STEP = 2.0f;
+  static constexpr int BATCH_CHUNK_SIZE = 256; // number of tracks propagated in lockstep by the batch methods
 
   GPUd() bool PropagateToXBxByBz(TrackParCov_t& track, value_type x,
                                  value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
@@ -112,6 +115,22 @@ class PropagatorImpl
                                    gpu::gpustd::array<value_type, 2>* dca = nullptr, track::TrackLTIntegral* tofInfo = nullptr,
                                    int signCorr = 0, value_type maxD = 999.f) const;
 
+#ifndef GPUCA_GPUCODE
+  /// Batch propagation of the tracks to the common X, taking into account all the three components of the field.
+  /// The tracks are stepped in lockstep in chunks of BATCH_CHUNK_SIZE: at every step the field and the material
+  /// budget are queried for all active tracks of the chunk at once. The chunks are processed by nThreads threads
+  /// (a single one if TGeo is used for the material queries). The optional status array must have the size of tracks.
+  /// Returns the number of successfully propagated tracks, the failed ones are left at the point of failure.
+  int PropagateToXBxByBz(gsl::span<TrackParCov_t> tracks, value_type x, value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP,
+                         MatCorrType matCorr = MatCorrType::USEMatCorrLUT, bool* status = nullptr, int signCorr = 0, int nThreads = 1) const;
+
+  /// Batch propagation of the tracks to their DCA to the common vertex, see the batch PropagateToXBxByBz.
+  /// The optional dca and status arrays must have the size of tracks. The failed tracks are left unchanged.
+  int propagateToDCABxByBz(const o2::dataformats::VertexBase& vtx, gsl::span<TrackParCov_t> tracks, value_type maxStep = MAX_STEP,
+                           MatCorrType matCorr = MatCorrType::USEMatCorrLUT, o2::dataformats::DCA* dca = nullptr, bool* status = nullptr,
+                           int signCorr = 0, value_type maxD = 999.f, int nThreads = 1) const;
+#endif
+
   PropagatorImpl(PropagatorImpl const&) = delete;
   PropagatorImpl(PropagatorImpl&&) = delete;
   PropagatorImpl& operator=(PropagatorImpl const&) = delete;
@@ -122,6 +141,9 @@ class PropagatorImpl
 
   GPUd() void setMatLUT(const o2::base::MatLayerCylSet* lut) { mMatLUT = lut; }
   GPUd() const o2::base::MatLayerCylSet* getMatLUT() const { return mMatLUT; }
+  /// optional cache for the LUT queries on the host, must be initialized with the same LUT
+  GPUd() void setMatBudgetCache(const o2::base::MatBudgetCache* cache) { mMatCache = cache; }
+  GPUd() const o2::base::MatBudgetCache* getMatBudgetCache() const { return mMatCache; }
   GPUd() void setGPUField(const o2::gpu::GPUTPCGMPolynomialField* field) { mGPUField = field; }
   GPUd() const o2::gpu::GPUTPCGMPolynomialField* getGPUField() const { return mGPUField; }
   GPUd() void setBz(value_type bz) { mBz = bz; }
@@ -152,10 +174,23 @@ class PropagatorImpl
   template <typename T>
   GPUd() void getFieldXYZImpl(const math_utils::Point3D<T> xyz, T* bxyz) const;
 
+#ifndef GPUCA_GPUCODE
+  /// lockstep propagation of the ntr tracks with status set to their xToGo
+  void propagateBatchToX(TrackParCov_t* tracks, const value_type* xToGo, bool* status, int ntr, value_type maxSnp, value_type maxStep,
+                         MatCorrType matCorr, int signCorr) const;
+
+  int getBatchThreads(MatCorrType matCorr, int nThreads) const
+  {
+    // TGeo navigation used for the material queries is not thread-safe
+    return (matCorr == MatCorrType::USEMatCorrTGeo || (matCorr != MatCorrType::USEMatCorrNONE && !mMatLUT)) ? 1 : nThreads;
+  }
+#endif
+
   const o2::field::MagFieldFast* mField = nullptr; ///< External fast field (barrel only for the moment)
   value_type mBz = 0;                              // nominal field
 
   const o2::base::MatLayerCylSet* mMatLUT = nullptr;           // externally set LUT
+  const o2::base::MatBudgetCache* mMatCache = nullptr;         // externally set cache of the LUT, host only
   const o2::gpu::GPUTPCGMPolynomialField* mGPUField = nullptr; // externally set GPU Field
 
   ClassDefNV(PropagatorImpl, 0);
@@ -0,0 +1,230 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file MatBudgetCache.cxx
+/// \brief Implementation of the cache of the material budget along radial lines
+
+#include "DetectorsBase/MatBudgetCache.h"
+#include "DetectorsBase/MatLayerCylSet.h"
+#include "CommonConstants/MathConstants.h"
+#include "GPUCommonLogger.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace o2::base;
+
+//________________________________________________________________________________
+void MatBudgetCache::init(const MatLayerCylSet* lut, const Params& par)
+{
+  mLUT = nullptr;
+  mNodeR.clear();
+  mRIndex.clear();
+  mTable.clear();
+  resetStats();
+  if (!lut || !lut->getNLayers() || par.rMin >= par.rMax || par.nPhiBins < 1 || par.nTglBins < 1 || par.maxDR <= 0.f) {
+    LOG(ERROR) << "MatBudgetCache::init: invalid LUT or cache parameters";
+    return;
+  }
+  mParams = par;
+
+  // integration nodes: the domain and layer boundaries, subdivided to be not farther than maxDR
+  std::vector<float> bounds{par.rMin, par.rMax};
+  for (int il = 0; il < lut->getNLayers(); il++) {
+    const auto& lr = lut->getLayer(il);
+    for (float r : {lr.getRMin(), lr.getRMax()}) {
+      if (r > par.rMin && r < par.rMax) {
+        bounds.push_back(r);
+      }
+    }
+  }
+  std::sort(bounds.begin(), bounds.end());
+  bounds.erase(std::unique(bounds.begin(), bounds.end(), [](float a, float b) { return b - a < 1e-4f; }), bounds.end());
+  mNodeR.push_back(bounds[0]);
+  for (size_t ib = 1; ib < bounds.size(); ib++) {
+    float dr = bounds[ib] - bounds[ib - 1];
+    int nsub = std::ceil(dr / par.maxDR);
+    for (int is = 1; is < nsub; is++) {
+      mNodeR.push_back(bounds[ib - 1] + is * dr / nsub);
+    }
+    mNodeR.push_back(bounds[ib]);
+  }
+  mNodeR.back() = par.rMax;
+  const int nNodes = mNodeR.size();
+
+  // layer containing each interval between the nodes, -1 for gaps
+  std::vector<int> intervalLayer(nNodes - 1, -1);
+  for (int in = 0; in < nNodes - 1; in++) {
+    float rMid = 0.5f * (mNodeR[in] + mNodeR[in + 1]);
+    for (int il = 0; il < lut->getNLayers(); il++) {
+      const auto& lr = lut->getLayer(il);
+      if (rMid > lr.getRMin() && rMid < lr.getRMax()) {
+        intervalLayer[in] = il;
+        break;
+      }
+    }
+  }
+
+  // uniform radius index with a step not exceeding the smallest node distance
+  float minStep = par.rMax - par.rMin;
+  for (int in = 1; in < nNodes; in++) {
+    minStep = std::min(minStep, mNodeR[in] - mNodeR[in - 1]);
+  }
+  minStep = std::max(minStep, 1e-2f);
+  int nRIndex = std::ceil((par.rMax - par.rMin) / minStep) + 1;
+  mRIndexStepInv = 1.f / minStep;
+  mRIndex.resize(nRIndex);
+  for (int ir = 0, in = 0; ir < nRIndex; ir++) {
+    float r = par.rMin + ir * minStep;
+    while (in < nNodes - 2 && mNodeR[in + 1] <= r) {
+      in++;
+    }
+    mRIndex[ir] = in;
+  }
+
+  mPhiBinInv = par.nPhiBins / o2::constants::math::TwoPI;
+  mTglBinInv = par.nTglBins / (2.f * par.tglMax);
+  const int nRows = par.nPhiBins * par.nTglBins;
+  mTable.resize(size_t(nRows) * nNodes);
+
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(par.nThreads)
+#endif
+  for (int irow = 0; irow < nRows; irow++) {
+    float phi = (irow / par.nTglBins + 0.5f) / mPhiBinInv;
+    float tgl = -par.tglMax + (irow % par.nTglBins + 0.5f) / mTglBinInv;
+    float cs = std::cos(phi), sn = std::sin(phi);
+    Integral* row = &mTable[size_t(irow) * nNodes];
+    for (int in = 1; in < nNodes; in++) {
+      row[in] = row[in - 1];
+      float ra = mNodeR[in - 1], rb = mNodeR[in];
+      auto mb = lut->getMatBudget(ra * cs, ra * sn, ra * tgl, rb * cs, rb * sn, rb * tgl);
+      row[in].x2x0 += mb.meanX2X0;
+      int il = intervalLayer[in - 1];
+      if (il >= 0 && std::abs(0.5f * (ra + rb) * tgl) < lut->getLayer(il).getZMax()) {
+        row[in].rhoL += mb.meanRho * mb.length;
+        row[in].matL += mb.length;
+      }
+    }
+  }
+  mLUT = lut;
+  LOG(INFO) << "MatBudgetCache::init: " << nNodes << " radial nodes in " << par.rMin << "<R<" << par.rMax
+            << " for " << par.nPhiBins << " phi x " << par.nTglBins << " tgLambda bins, "
+            << mTable.size() * sizeof(Integral) / 1024 << " kB";
+}
+
+//________________________________________________________________________________
+MatBudgetCache::Integral MatBudgetCache::interpolate(const Integral* row, float r) const
+{
+  // linear interpolation of the integrals between the nodes, r must be within the domain
+  int in = mRIndex[std::min(int((r - mParams.rMin) * mRIndexStepInv), int(mRIndex.size()) - 1)];
+  const int nNodes = mNodeR.size();
+  while (in < nNodes - 2 && mNodeR[in + 1] <= r) {
+    in++;
+  }
+  float f = (r - mNodeR[in]) / (mNodeR[in + 1] - mNodeR[in]);
+  const auto &i0 = row[in], &i1 = row[in + 1];
+  Integral res;
+  res.rhoL = i0.rhoL + f * (i1.rhoL - i0.rhoL);
+  res.x2x0 = i0.x2x0 + f * (i1.x2x0 - i0.x2x0);
+  res.matL = i0.matL + f * (i1.matL - i0.matL);
+  return res;
+}
+
+//________________________________________________________________________________
+MatBudget MatBudgetCache::getMatBudget(float x0, float y0, float z0, float x1, float y1, float z1) const
+{
+  // get material budget traversed on the line between point0 and point1, from the cache if the
+  // segment is close to radial and within the cache domain, otherwise from the LUT
+  mNQueries.fetch_add(1, std::memory_order_relaxed);
+  const auto& par = mParams;
+  float r0 = std::sqrt(x0 * x0 + y0 * y0), r1 = std::sqrt(x1 * x1 + y1 * y1);
+  if (r0 < par.rMin || r0 > par.rMax || r1 < par.rMin || r1 > par.rMax || std::abs(r1 - r0) < par.minDR) {
+    return mLUT->getMatBudget(x0, y0, z0, x1, y1, z1);
+  }
+  float dPhi = std::atan2(x0 * y1 - y0 * x1, x0 * x1 + y0 * y1); // angle between the end points in the XY plane
+  float tgl0 = z0 / r0, tgl1 = z1 / r1;
+  if (std::abs(dPhi) > par.tolPhi || std::abs(tgl1 - tgl0) > par.tolTgl) {
+    return mLUT->getMatBudget(x0, y0, z0, x1, y1, z1);
+  }
+  float tglM = 0.5f * (tgl0 + tgl1);
+  int itgl = (tglM + par.tglMax) * mTglBinInv;
+  if (itgl < 0 || itgl >= par.nTglBins) {
+    return mLUT->getMatBudget(x0, y0, z0, x1, y1, z1);
+  }
+  float phiM = std::atan2(y0 + y1, x0 + x1);
+  if (phiM < 0.f) {
+    phiM += o2::constants::math::TwoPI;
+  }
+  int iphi = std::min(int(phiM * mPhiBinInv), par.nPhiBins - 1);
+
+  const Integral* row = &mTable[size_t(iphi * par.nTglBins + itgl) * mNodeR.size()];
+  auto ia = interpolate(row, std::min(r0, r1)), ib = interpolate(row, std::max(r0, r1));
+  float dx = x1 - x0, dy = y1 - y0, dz = z1 - z0;
+  float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+  float lengthRad = std::abs(r1 - r0) * std::sqrt(1.f + tglM * tglM); // length of the cached radial path
+  float matL = ib.matL - ia.matL;
+  MatBudget rval;
+  rval.meanRho = matL > 0.f ? (ib.rhoL - ia.rhoL) / matL : 0.f;
+  rval.meanX2X0 = (ib.x2x0 - ia.x2x0) * length / lengthRad;
+  rval.length = length;
+
+  auto nHits = mNHits.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (par.verifyEvery > 0 && nHits % par.verifyEvery == 0) {
+    verify(rval, x0, y0, z0, x1, y1, z1);
+  }
+  return rval;
+}
+
+//________________________________________________________________________________
+void MatBudgetCache::verify(const MatBudget& cached, float x0, float y0, float z0, float x1, float y1, float z1) const
+{
+  // accumulate the deviation of the cached answer from the exact one
+  auto exact = mLUT->getMatBudget(x0, y0, z0, x1, y1, z1);
+  auto relErr = [](float c, float e) { return e > 0.f ? std::abs(c - e) / e : (c > 0.f ? 1. : 0.); };
+  double errX2X0 = relErr(cached.meanX2X0, exact.meanX2X0), errRho = relErr(cached.meanRho, exact.meanRho);
+  std::lock_guard<std::mutex> lock(mStatsMutex);
+  mErrStats.nVerified++;
+  mErrStats.sumRelErrX2X0 += errX2X0;
+  mErrStats.maxRelErrX2X0 = std::max(mErrStats.maxRelErrX2X0, errX2X0);
+  mErrStats.sumRelErrRho += errRho;
+  mErrStats.maxRelErrRho = std::max(mErrStats.maxRelErrRho, errRho);
+}
+
+//________________________________________________________________________________
+MatBudgetCache::Stats MatBudgetCache::getStats() const
+{
+  Stats st;
+  {
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    st = mErrStats;
+  }
+  st.nQueries = mNQueries.load(std::memory_order_relaxed);
+  st.nHits = mNHits.load(std::memory_order_relaxed);
+  return st;
+}
+
+//________________________________________________________________________________
+void MatBudgetCache::resetStats()
+{
+  mNQueries = 0;
+  mNHits = 0;
+  std::lock_guard<std::mutex> lock(mStatsMutex);
+  mErrStats = Stats();
+}
+
+//________________________________________________________________________________
+void MatBudgetCache::printStats() const
+{
+  auto st = getStats();
+  LOG(INFO) << "MatBudgetCache: " << st.nHits << " of " << st.nQueries << " queries answered from the cache ("
+            << st.getHitRate() * 100.f << "%), " << st.nVerified << " verified: rel.error of x/X0 mean "
+            << st.getMeanRelErrX2X0() << " max " << st.maxRelErrX2X0 << ", of <rho> mean "
+            << st.getMeanRelErrRho() << " max " << st.maxRelErrRho;
+}
@@ -20,12 +20,16 @@ using namespace o2::gpu;
 
 #if !defined(GPUCA_GPUCODE)
 #include "Field/MagFieldFast.h" // Don't use this on the GPU
+#include <algorithm>
+#include <memory>
+#include <vector>
 #endif
 
 #if !defined(GPUCA_STANDALONE) && !defined(GPUCA_GPUCODE)
 #include "Field/MagneticField.h"
 #include "DataFormatsParameters/GRPObject.h"
 #include "DetectorsBase/GeometryManager.h"
+#include "DetectorsBase/MatBudgetCache.h"
 #include <FairRunAna.h> // eventually will get rid of it
 #include <TGeoGlobalMagField.h>
 
@@ -543,6 +547,9 @@ GPUd() MatBudget PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type
   if (corrType == MatCorrType::USEMatCorrTGeo || !mMatLUT) {
     return GeometryManager::meanMaterialBudget(p0, p1);
   }
+  if (mMatCache) {
+    return mMatCache->getMatBudget(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z());
+  }
 #endif
   return mMatLUT->getMatBudget(p0.X(), p0.Y(), p0.Z(), p1.X(), p1.Y(), p1.Z());
 }
@@ -583,6 +590,177 @@ GPUd() void PropagatorImpl<value_T>::getFieldXYZ(const math_utils::Point3D<doubl
   getFieldXYZImpl<double>(xyz, bxyz);
 }
 
+#ifndef GPUCA_GPUCODE
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::PropagateToXBxByBz(gsl::span<TrackParCov_t> tracks, value_type xToGo, value_type maxSnp, value_type maxStep,
+                                                PropagatorImpl<value_T>::MatCorrType matCorr, bool* status, int signCorr, int nThreads) const
+{
+  // Propagates the tracks to the plane X=xToGo (cm), see the single track version for details
+  const int ntr = tracks.size();
+  std::unique_ptr<bool[]> statusOwn;
+  if (!status) {
+    statusOwn.reset(new bool[ntr]);
+    status = statusOwn.get();
+  }
+  std::vector<value_type> xv(BATCH_CHUNK_SIZE, xToGo);
+  const int nChunks = (ntr + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+  nThreads = getBatchThreads(matCorr, nThreads);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int ic = 0; ic < nChunks; ic++) {
+    int first = ic * BATCH_CHUNK_SIZE, n = std::min(BATCH_CHUNK_SIZE, ntr - first);
+    std::fill(status + first, status + first + n, true);
+    propagateBatchToX(&tracks[first], xv.data(), status + first, n, maxSnp, maxStep, matCorr, signCorr);
+  }
+  return std::count(status, status + ntr, true);
+}
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateToDCABxByBz(const o2::dataformats::VertexBase& vtx, gsl::span<TrackParCov_t> tracks,
+                                                  value_type maxStep, PropagatorImpl<value_type>::MatCorrType matCorr,
+                                                  o2::dataformats::DCA* dca, bool* status, int signCorr, value_type maxD, int nThreads) const
+{
+  // propagate tracks to DCA to the vertex, see the single track version for details
+  const int ntr = tracks.size();
+  std::unique_ptr<bool[]> statusOwn;
+  if (!status) {
+    statusOwn.reset(new bool[ntr]);
+    status = statusOwn.get();
+  }
+  const int nChunks = (ntr + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+  nThreads = getBatchThreads(matCorr, nThreads);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int ic = 0; ic < nChunks; ic++) {
+    int first = ic * BATCH_CHUNK_SIZE, n = std::min(BATCH_CHUNK_SIZE, ntr - first);
+    std::vector<TrackParCov_t> tmpT(tracks.begin() + first, tracks.begin() + first + n); // operate on the copies to recover after the failure
+    std::vector<value_type> xvA(n), yvA(n), alpA(n);
+    for (int i = 0; i < n; i++) {
+      auto& track = tmpT[i];
+      value_type sn, cs, alp = track.getAlpha();
+      math_utils::detail::sincos<value_type>(alp, sn, cs);
+      value_type x = track.getX(), y = track.getY(), snp = track.getSnp(), csp = math_utils::detail::sqrt<value_type>((1.f - snp) * (1.f + snp));
+      value_type xv = vtx.getX() * cs + vtx.getY() * sn, yv = -vtx.getX() * sn + vtx.getY() * cs;
+      x -= xv;
+      y -= yv;
+      //Estimate the impact parameter neglecting the track curvature
+      value_type d = math_utils::detail::abs<value_type>(x * snp - y * csp);
+      if (d > maxD) {
+        status[first + i] = false;
+        continue;
+      }
+      value_type crv = track.getCurvature(mBz);
+      value_type tgfv = -(crv * x - snp) / (crv * y + csp);
+      sn = tgfv / math_utils::detail::sqrt<value_type>(1.f + tgfv * tgfv);
+      cs = math_utils::detail::sqrt<value_type>((1. - sn) * (1. + sn));
+      cs = (math_utils::detail::abs<value_type>(tgfv) > o2::constants::math::Almost0) ? sn / tgfv : o2::constants::math::Almost1;
+
+      x = xv * cs + yv * sn;
+      yvA[i] = -xv * sn + yv * cs;
+      xvA[i] = x;
+      alpA[i] = alp + math_utils::detail::asin<value_type>(sn);
+      status[first + i] = track.rotate(alpA[i]);
+    }
+    propagateBatchToX(tmpT.data(), xvA.data(), status + first, n, 0.85, maxStep, matCorr, signCorr);
+    for (int i = 0; i < n; i++) {
+      if (!status[first + i]) {
+        continue;
+      }
+      auto& track = tracks[first + i];
+      track = tmpT[i];
+      if (dca) {
+        value_type sn, cs;
+        math_utils::detail::sincos<value_type>(alpA[i], sn, cs);
+        auto s2ylocvtx = vtx.getSigmaX2() * sn * sn + vtx.getSigmaY2() * cs * cs - 2. * vtx.getSigmaXY() * cs * sn;
+        dca[first + i].set(track.getY() - yvA[i], track.getZ() - vtx.getZ(),
+                           track.getSigmaY2() + s2ylocvtx, track.getSigmaZY(), track.getSigmaZ2() + vtx.getSigmaZ2());
+      }
+    }
+  }
+  return std::count(status, status + ntr, true);
+}
+
+//_______________________________________________________________________
+template <typename value_T>
+void PropagatorImpl<value_T>::propagateBatchToX(TrackParCov_t* tracks, const value_type* xToGo, bool* status, int ntr, value_type maxSnp,
+                                                value_type maxStep, PropagatorImpl<value_T>::MatCorrType matCorr, int signCorr) const
+{
+  // Propagates the tracks with the status set to their xToGo in lockstep: at every step the start points, the field,
+  // the propagation and the material budget are processed for all still active tracks in separate passes
+  const value_type Epsilon = 0.00001;
+  std::vector<int> active;
+  std::vector<math_utils::Point3D<value_type>> xyz0(ntr), xyz1(ntr);
+  std::vector<gpu::gpustd::array<value_type, 3>> b(ntr);
+  std::vector<int> signCorrT(ntr);
+  active.reserve(ntr);
+  for (int it = 0; it < ntr; it++) {
+    if (!status[it]) {
+      continue;
+    }
+    auto dx = xToGo[it] - tracks[it].getX();
+    signCorrT[it] = signCorr ? signCorr : (dx > 0.f ? -1 : 1); // sign of eloss correction is not imposed
+    if (math_utils::detail::abs<value_type>(dx) > Epsilon) {
+      active.push_back(it);
+    } else {
+      tracks[it].setX(xToGo[it]);
+    }
+  }
+
+  while (!active.empty()) {
+    int nact = active.size();
+    for (int ia = 0; ia < nact; ia++) {
+      xyz0[ia] = tracks[active[ia]].getXYZGlo();
+    }
+    for (int ia = 0; ia < nact; ia++) {
+      getFieldXYZ(xyz0[ia], &b[ia][0]);
+    }
+    for (int ia = 0; ia < nact; ia++) {
+      int it = active[ia];
+      auto& track = tracks[it];
+      auto dx = xToGo[it] - track.getX();
+      auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
+      if (dx < 0) {
+        step = -step;
+      }
+      if (!track.propagateTo(track.getX() + step, b[ia]) ||
+          (maxSnp > 0 && math_utils::detail::abs<value_type>(track.getSnp()) >= maxSnp)) {
+        status[it] = false;
+      }
+    }
+    if (matCorr != MatCorrType::USEMatCorrNONE) {
+      for (int ia = 0; ia < nact; ia++) {
+        int it = active[ia];
+        if (!status[it]) {
+          continue;
+        }
+        xyz1[ia] = tracks[it].getXYZGlo();
+        auto mb = getMatBudget(matCorr, xyz0[ia], xyz1[ia]);
+        if (!tracks[it].correctForMaterial(mb.meanX2X0, mb.getXRho(signCorrT[it]))) {
+          status[it] = false;
+        }
+      }
+    }
+    int nkeep = 0;
+    for (int ia = 0; ia < nact; ia++) {
+      int it = active[ia];
+      if (!status[it]) {
+        continue;
+      }
+      if (math_utils::detail::abs<value_type>(xToGo[it] - tracks[it].getX()) > Epsilon) {
+        active[nkeep++] = it;
+      } else {
+        tracks[it].setX(xToGo[it]);
+      }
+    }
+    active.resize(nkeep);
+  }
+}
+#endif
+
 namespace o2::base
 {
 template class PropagatorImpl<float>;
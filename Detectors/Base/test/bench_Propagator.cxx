@@ -0,0 +1,92 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   bench_Propagator.cxx
+/// \brief  Propagation of many tracks with the single track methods vs the batch ones with 1 or more threads.
+///         The material LUT is used when matbud.root is found in the working directory.
+
+#include "benchmark/benchmark.h"
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+using TrackParCov = Propagator::TrackParCov_t;
+
+const Propagator* getPropagator()
+{
+  static const Propagator* prop = []() {
+    TGeoGlobalMagField::Instance()->SetField(new o2::field::MagneticField("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG));
+    TGeoGlobalMagField::Instance()->Lock();
+    new TGeoManager("propagator", "empty geometry");
+    auto p = Propagator::Instance();
+    if (FILE* f = fopen("matbud.root", "r")) {
+      fclose(f);
+      p->setMatLUT(MatLayerCylSet::loadFromFile("matbud.root"));
+    }
+    return p;
+  }();
+  return prop;
+}
+
+Propagator::MatCorrType getMatCorr()
+{
+  return getPropagator()->getMatLUT() ? Propagator::MatCorrType::USEMatCorrLUT : Propagator::MatCorrType::USEMatCorrNONE;
+}
+
+// primary-like tracks at the beam pipe
+std::vector<TrackParCov> generateTracks(int ntr)
+{
+  std::mt19937 gen(ntr);
+  std::uniform_real_distribution<float> flat(-1.f, 1.f);
+  std::vector<TrackParCov> tracks;
+  for (int i = 0; i < ntr; i++) {
+    std::array<float, 5> par{0.1f * flat(gen), 5.f * flat(gen), 0.1f * flat(gen), flat(gen), 2.f * flat(gen)};
+    std::array<float, 15> cov{1e-2, 1e-4, 1e-2, 1e-5, 1e-6, 1e-4, 1e-6, 1e-5, 1e-7, 1e-4, 1e-4, 1e-5, 1e-5, 1e-6, 1e-2};
+    tracks.emplace_back(3.f, 3.14f * flat(gen), par, cov);
+  }
+  return tracks;
+}
+
+static void BM_PropagateSingle(benchmark::State& state)
+{
+  auto prop = getPropagator();
+  auto matCorr = getMatCorr();
+  const auto input = generateTracks(state.range(0));
+  for (auto _ : state) {
+    auto tracks = input;
+    for (auto& track : tracks) {
+      prop->PropagateToXBxByBz(track, 50.f, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr);
+    }
+    benchmark::DoNotOptimize(tracks.data());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+static void BM_PropagateBatch(benchmark::State& state)
+{
+  auto prop = getPropagator();
+  auto matCorr = getMatCorr();
+  const auto input = generateTracks(state.range(0));
+  for (auto _ : state) {
+    auto tracks = input;
+    prop->PropagateToXBxByBz(tracks, 50.f, Propagator::MAX_SIN_PHI, Propagator::MAX_STEP, matCorr, nullptr, 0, state.range(1));
+    benchmark::DoNotOptimize(tracks.data());
+  }
+  state.SetItemsProcessed(state.iterations() * input.size());
+}
+
+BENCHMARK(BM_PropagateSingle)->Arg(10000)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PropagateBatch)->Args({10000, 1})->Args({10000, 2})->Args({10000, 4})->Args({10000, 8})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
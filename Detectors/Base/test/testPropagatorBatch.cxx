@@ -0,0 +1,138 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Propagator batch methods
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace base
+{
+using TrackParCov = Propagator::TrackParCov_t;
+using MatCorrType = Propagator::MatCorrType;
+
+const Propagator* getPropagator()
+{
+  // the propagator needs only the field when the material corrections are not requested
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(new o2::field::MagneticField("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  if (!gGeoManager) {
+    new TGeoManager("propagator", "empty geometry");
+  }
+  return Propagator::Instance();
+}
+
+// tracks at radius x0 +- 1 cm, the low pt ones fail to reach the large radii with snp below the limit
+std::vector<TrackParCov> generateTracks(int ntr, float x0, unsigned int seed)
+{
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> flat(-1.f, 1.f);
+  std::vector<TrackParCov> tracks;
+  tracks.reserve(ntr);
+  for (int i = 0; i < ntr; i++) {
+    std::array<float, 5> par{5.f * flat(gen), 10.f * flat(gen), 0.3f * flat(gen), flat(gen), 6.f * flat(gen)};
+    std::array<float, 15> cov{1e-2, 1e-4, 1e-2, 1e-5, 1e-6, 1e-4, 1e-6, 1e-5, 1e-7, 1e-4, 1e-4, 1e-5, 1e-5, 1e-6, 1e-2};
+    tracks.emplace_back(x0 + flat(gen), 3.14f * flat(gen), par, cov);
+  }
+  return tracks;
+}
+
+void checkSame(const TrackParCov& single, const TrackParCov& batch)
+{
+  BOOST_CHECK_EQUAL(single.getX(), batch.getX());
+  BOOST_CHECK_EQUAL(single.getAlpha(), batch.getAlpha());
+  for (int i = 0; i < 5; i++) {
+    BOOST_CHECK_EQUAL(single.getParams()[i], batch.getParams()[i]);
+  }
+  for (int i = 0; i < 15; i++) {
+    BOOST_CHECK_EQUAL(single.getCov()[i], batch.getCov()[i]);
+  }
+}
+
+// the sizes around the chunk boundaries
+const std::vector<int> BatchSizes{0, 1, Propagator::BATCH_CHUNK_SIZE - 1, Propagator::BATCH_CHUNK_SIZE, Propagator::BATCH_CHUNK_SIZE + 1,
+                                  2 * Propagator::BATCH_CHUNK_SIZE + 17};
+
+BOOST_AUTO_TEST_CASE(PropagateToXBatch)
+{
+  auto prop = getPropagator();
+  for (int ntr : BatchSizes) {
+    auto reference = generateTracks(ntr, 4.f, ntr);
+    std::unique_ptr<bool[]> refStatus(new bool[ntr + 1]);
+    int nOK = 0;
+    for (int i = 0; i < ntr; i++) {
+      refStatus[i] = prop->PropagateToXBxByBz(reference[i], 80.f, 0.85f, 2.f, MatCorrType::USEMatCorrNONE);
+      nOK += refStatus[i];
+    }
+    if (ntr > 100) {
+      BOOST_CHECK(nOK > 0 && nOK < ntr); // both outcomes are exercised
+    }
+    for (int nThreads : {1, 4}) {
+      auto tracks = generateTracks(ntr, 4.f, ntr);
+      std::unique_ptr<bool[]> status(new bool[ntr + 1]);
+      BOOST_CHECK_EQUAL(prop->PropagateToXBxByBz(tracks, 80.f, 0.85f, 2.f, MatCorrType::USEMatCorrNONE, status.get(), 0, nThreads), nOK);
+      for (int i = 0; i < ntr; i++) {
+        BOOST_CHECK_EQUAL(refStatus[i], status[i]);
+        checkSame(reference[i], tracks[i]); // the failed tracks are left at the point of failure by both
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PropagateToDCABatch)
+{
+  auto prop = getPropagator();
+  o2::dataformats::VertexBase vtx({0.02f, -0.01f, 0.5f}, {1e-4, 1e-6, 1e-4, 1e-6, 1e-6, 1e-3});
+  const float maxD = 4.f; // some tracks are rejected by the impact parameter estimate
+  for (int ntr : BatchSizes) {
+    auto reference = generateTracks(ntr, 30.f, ntr);
+    std::vector<o2::dataformats::DCA> refDCA(ntr);
+    std::unique_ptr<bool[]> refStatus(new bool[ntr + 1]);
+    int nOK = 0;
+    for (int i = 0; i < ntr; i++) {
+      refStatus[i] = prop->propagateToDCABxByBz(vtx, reference[i], 2.f, MatCorrType::USEMatCorrNONE, &refDCA[i], nullptr, 0, maxD);
+      nOK += refStatus[i];
+    }
+    if (ntr > 100) {
+      BOOST_CHECK(nOK > 0 && nOK < ntr);
+    }
+    for (int nThreads : {1, 4}) {
+      auto tracks = generateTracks(ntr, 30.f, ntr);
+      std::vector<o2::dataformats::DCA> dca(ntr);
+      std::unique_ptr<bool[]> status(new bool[ntr + 1]);
+      BOOST_CHECK_EQUAL(prop->propagateToDCABxByBz(vtx, tracks, 2.f, MatCorrType::USEMatCorrNONE, dca.data(), status.get(), 0, maxD, nThreads), nOK);
+      for (int i = 0; i < ntr; i++) {
+        BOOST_CHECK_EQUAL(refStatus[i], status[i]);
+        checkSame(reference[i], tracks[i]); // the failed tracks are left unchanged by both
+        if (status[i]) {
+          BOOST_CHECK_EQUAL(refDCA[i].getY(), dca[i].getY());
+          BOOST_CHECK_EQUAL(refDCA[i].getZ(), dca[i].getZ());
+          BOOST_CHECK_EQUAL(refDCA[i].getSigmaY2(), dca[i].getSigmaY2());
+          BOOST_CHECK_EQUAL(refDCA[i].getSigmaYZ(), dca[i].getSigmaYZ());
+          BOOST_CHECK_EQUAL(refDCA[i].getSigmaZ2(), dca[i].getSigmaZ2());
+        }
+      }
+    }
+  }
+}
+
+} // namespace base
+} // namespace o2
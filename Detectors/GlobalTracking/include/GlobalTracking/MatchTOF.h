@@ -153,6 +153,10 @@ class MatchTOF
   ///< get number of sigma used to do the matching
   float getSigmaTimeCut() const { return mSigmaTimeCut; }
 
+  ///< set number of threads to match the chunks of tracks of all sectors
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   enum DebugFlagTypes : UInt_t {
     MatchTreeAll = 0x1 << 1, ///< produce matching candidates tree for all candidates
   };
@@ -248,8 +252,10 @@ class MatchTOF
   bool loadTPCTracksNextChunk();
   bool loadTOFClustersNextChunk();
 
-  void doMatching(int sec);
-  void doMatchingForTPC(int sec);
+  void matchSectors();
+  void doMatching(int sec, int itrkStart, int itrkEnd, std::vector<o2::dataformats::MatchInfoTOF>& matchedPairs);
+  void doMatchingForTPC(int sec, int itrkStart, int itrkEnd, std::vector<o2::dataformats::MatchInfoTOF>& matchedPairs);
+  void findClustersInStrips(int sec, const std::array<std::array<int, 5>, 2>& detId, int nStrips, double minTime, double maxTime, std::vector<std::pair<int, int>>& candidates) const;
   void selectBestMatches();
   bool propagateToRefX(o2::track::TrackParCov& trc, float xRef /*in cm*/, float stepInCm /*in cm*/, o2::track::TrackLTIntegral& intLT);
   bool propagateToRefXWithoutCov(o2::track::TrackParCov& trc, float xRef /*in cm*/, float stepInCm /*in cm*/, float bz);
@@ -284,6 +290,7 @@ class MatchTOF
   float mTimeTolerance = 1e3; ///< tolerance in ns for track-TOF time bracket matching
   float mSpaceTolerance = 10; ///< tolerance in cm for track-TOF time bracket matching
   int mSigmaTimeCut = 30.;    ///< number of sigmas to cut on time when matching the track to the TOF cluster
+  int mNThreads = 1;          ///< number of threads to match the chunks of tracks
 
   TTree* mInputTreeTracks = nullptr; ///< input tree for tracks
   TTree* mTreeTPCTracks = nullptr;   ///< input tree for TPC tracks
@@ -335,6 +342,10 @@ class MatchTOF
   std::array<std::vector<int>, o2::constants::math::NSectors> mTPCTracksSectIndexCache;
   ///< per sector indices of TOF cluster entry in mTOFClusWork
   std::array<std::vector<int>, o2::constants::math::NSectors> mTOFClusSectIndexCache;
+  ///< per sector positions in mTOFClusSectIndexCache grouped by strip, ordered in time within the strip
+  std::array<std::vector<int>, o2::constants::math::NSectors> mTOFClusSectStripIndexCache;
+  ///< per sector first entry of every strip in mTOFClusSectStripIndexCache
+  std::array<std::array<int, Geo::NSTRIPXSECTOR + 1>, o2::constants::math::NSectors> mTOFClusSectStripFirst;
 
   ///<array of track-TOFCluster pairs from the matching
   std::vector<o2::dataformats::MatchInfoTOF> mMatchedTracksPairs;
@@ -367,13 +378,14 @@ class MatchTOF
   std::string mDebugTreeFileName = "dbg_matchTOF.root"; ///< name for the debug tree file
 
   ///----------- aux stuff --------------///
-  static constexpr float MAXSNP = 0.85; // max snp of ITS or TPC track at xRef to be matched
+  static constexpr float MAXSNP = 0.85;     // max snp of ITS or TPC track at xRef to be matched
+  static constexpr int NTRACKSPERTASK = 50; // number of tracks of the sector matched as a single task
 
   Bool_t mIsworkflowON = kFALSE;
 
   TStopwatch mTimerTot;
   TStopwatch mTimerDBG;
-  ClassDefNV(MatchTOF, 3);
+  ClassDefNV(MatchTOF, 4);
 };
 } // namespace globaltracking
 } // namespace o2
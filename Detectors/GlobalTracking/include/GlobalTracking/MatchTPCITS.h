@@ -150,6 +150,17 @@ struct MatchRecord {
   }
 };
 
+///< matching candidate found for a pair of ITS and TPC tracks in a given sector, to be registered
+///< in the MatchRecords once all sectors are processed
+struct MatchCandidate {
+  int iITS = MinusOne;      ///< entry of ITS track in mITSWork
+  int iTPC = MinusOne;      ///< entry of TPC track in mTPCWork
+  float chi2 = -1.f;        ///< matching chi2
+  int matchedIC = MinusOne; ///< index of eventually matched InteractionCandidate
+  MatchCandidate(int its, int tpc, float chi2match, int candIC) : iITS(its), iTPC(tpc), chi2(chi2match), matchedIC(candIC) {}
+  MatchCandidate() = default;
+};
+
 ///< Link of the AfterBurner track: update at sertain cluster
 ///< original track in the currently loaded TPC reco output
 struct ABTrackLink : public o2::track::TrackParCov {
@@ -451,6 +462,8 @@ class MatchTPCITS
 
   std::vector<o2::dataformats::TrackTPCITS>& getMatchedTracks() { return mMatchedTracks; }
   MCLabContTr& getMatchLabels() { return mOutLabels; }
+  const std::vector<MatchRecord>& getMatchRecordsTPC() const { return mMatchRecordsTPC; }
+  const std::vector<MatchRecord>& getMatchRecordsITS() const { return mMatchRecordsITS; }
 
   //>>> ====================== options =============================>>>
   void setUseMatCorrFlag(MatCorrType f) { mUseMatCorrFlag = f; }
@@ -509,6 +522,7 @@ class MatchTPCITS
   void flagUsedITSClusters(const o2::its::TrackITS& track, int rofOffset);
 
   void doMatching(int sec);
+  void registerMatchCandidates();
 
   void refitWinners();
   bool refitTrackTPCITS(int iTPC, int& iITS);
@@ -689,6 +703,8 @@ class MatchTPCITS
   std::vector<MatchRecord> mMatchRecordsTPC;
   ///< container for reference to MatchRecord involving particular ITS track
   std::vector<MatchRecord> mMatchRecordsITS;
+  ///< per sector matching candidates, filled by doMatching and registered in the MatchRecords sector by sector
+  std::array<std::vector<MatchCandidate>, o2::constants::math::NSectors> mSectorMatchCandidates;
 
   std::vector<int> mITSROFofTPCBin;    ///< aux structure for mapping of TPC time-bins on ITS ROFs
   std::vector<BracketF> mITSROFTimes;  ///< min/max times of ITS ROFs in TPC time-bins
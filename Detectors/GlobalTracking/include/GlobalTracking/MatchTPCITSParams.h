@@ -45,6 +45,8 @@ struct MatchTPCITSParams : public o2::conf::ConfigurableParamHelper<MatchTPCITSP
 
   int maxMatchCandidates = 5; ///< max allowed matching candidates per TPC track
 
+  int nThreads = 1; ///< number of threads for the per sector matching candidates search
+
   int requireToReachLayerAB = 5; ///< AB tracks should reach at least this layer from above
 
   float safeMarginTPCITSTimeBin = 1.f; ///< safety margin (in TPC time bins) for ITS-TPC tracks time (in TPC time bins!) comparison
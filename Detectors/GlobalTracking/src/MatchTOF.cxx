@@ -8,6 +8,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include <TTree.h>
+#include <algorithm>
 #include <cassert>
 
 #include "FairLogger.h"
@@ -81,16 +82,7 @@ void MatchTOF::run()
     LOGF(INFO, "Timing prepare tracks: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
     mTimerTot.Start();
 
-    for (int sec = o2::constants::math::NSectors; sec--;) {
-      LOG(INFO) << "Doing matching for sector " << sec << "...";
-      if (mIsITSused) {
-        doMatching(sec);
-      } else {
-        doMatchingForTPC(sec);
-      }
-      LOG(INFO) << "...done. Now check the best matches";
-      selectBestMatches();
-    }
+    matchSectors();
   }
 
   // we do the matching per entry of the TPCITS matched tracks tree
@@ -110,16 +102,7 @@ void MatchTOF::run()
     LOGF(INFO, "Timing prepare tracks: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
     mTimerTot.Start();
 
-    for (int sec = o2::constants::math::NSectors; sec--;) {
-      LOG(INFO) << "Doing matching for sector " << sec << "...";
-      if (mIsITSused) {
-        doMatching(sec);
-      } else {
-        doMatchingForTPC(sec);
-      }
-      LOG(INFO) << "...done. Now check the best matches";
-      selectBestMatches();
-    }
+    matchSectors();
 
     mTimerTot.Stop();
     LOGF(INFO, "Timing Do Matching: Cpu: %.3e s Real: %.3e s in %d slots", mTimerTot.CpuTime(), mTimerTot.RealTime(), mTimerTot.Counter() - 1);
@@ -732,6 +715,25 @@ bool MatchTOF::prepareTOFClusters()
     });
   } // loop over TOF clusters of single sector
 
+  // index the time-ordered clusters of each sector by strip, keeping the time order within the strip
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    const auto& indexCache = mTOFClusSectIndexCache[sec];
+    auto& stripFirst = mTOFClusSectStripFirst[sec];
+    auto& stripCache = mTOFClusSectStripIndexCache[sec];
+    stripFirst.fill(0);
+    for (int idx : indexCache) {
+      stripFirst[mTOFClusWork[idx].getPadInSector() / Geo::NPADS + 1]++;
+    }
+    for (int istrip = 0; istrip < Geo::NSTRIPXSECTOR; istrip++) {
+      stripFirst[istrip + 1] += stripFirst[istrip];
+    }
+    auto stripFill = stripFirst;
+    stripCache.resize(indexCache.size());
+    for (int itof = 0; itof < indexCache.size(); itof++) {
+      stripCache[stripFill[mTOFClusWork[indexCache[itof]].getPadInSector() / Geo::NPADS]++] = itof;
+    }
+  }
+
   if (mMatchedClustersIndex) {
     delete[] mMatchedClustersIndex;
   }
@@ -800,24 +802,105 @@ bool MatchTOF::loadTOFClustersNextChunk()
   return false;
 }
 //______________________________________________
-void MatchTOF::doMatching(int sec)
+void MatchTOF::matchSectors()
 {
+  ///< do the matching in all sectors and select the best matches per sector
+  // the tracks of each sector are split in chunks which are matched independently, each track being
+  // propagated once in place and each chunk filling its own list of pairs, so the chunks can run in parallel
+  int nThreads = mNThreads;
+  if (nThreads > 1 && !o2::base::Propagator::Instance()->getMatLUT()) {
+    LOG(WARNING) << "No material LUT is set, the TGeo material queries are not thread-safe: matching with 1 thread";
+    nThreads = 1;
+  }
+#ifdef _ALLOW_TOF_DEBUG_
+  if (mDBGFlags) {
+    nThreads = 1; // debug tree filling is not thread-safe
+  }
+#endif
 
-  ///< do the real matching per sector
-  mMatchedTracksPairs.clear(); // new sector
+  std::vector<std::array<int, 3>> tasks; // sector, first and last+1 track of the chunk
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    int nTracks = mTracksSectIndexCache[sec].size(), nTOFCls = mTOFClusSectIndexCache[sec].size();
+    LOG(INFO) << "Matching sector " << sec << ": number of tracks: " << nTracks << ", number of TOF clusters: " << nTOFCls;
+    if (!nTOFCls) {
+      continue;
+    }
+    for (int itrk = 0; itrk < nTracks; itrk += NTRACKSPERTASK) {
+      tasks.push_back({sec, itrk, std::min(itrk + NTRACKSPERTASK, nTracks)});
+    }
+  }
+
+  if (nThreads > 1) { // the TOF geometry tables are initialized at the first query, do it before the threads start
+    float posDummy[3] = {Geo::RMIN, 0., 0.}, deltaPosDummy[3];
+    int detIdDummy[5];
+    Geo::getPadDxDyDz(posDummy, detIdDummy, deltaPosDummy);
+  }
 
+  int nTasks = tasks.size();
+  std::vector<std::vector<o2::dataformats::MatchInfoTOF>> tasksPairs(nTasks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int itask = 0; itask < nTasks; itask++) {
+    const auto& task = tasks[itask];
+    if (mIsITSused) {
+      doMatching(task[0], task[1], task[2], tasksPairs[itask]);
+    } else {
+      doMatchingForTPC(task[0], task[1], task[2], tasksPairs[itask]);
+    }
+  }
+
+  // collect the pairs of each sector in the track order and select the best matches in the same sector
+  // order as the serial processing, so that the result does not depend on the number of threads
+  int itask = 0;
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    mMatchedTracksPairs.clear(); // new sector
+    for (; itask < nTasks && tasks[itask][0] == sec; itask++) {
+      mMatchedTracksPairs.insert(mMatchedTracksPairs.end(), tasksPairs[itask].begin(), tasksPairs[itask].end());
+    }
+    selectBestMatches();
+  }
+}
+
+//______________________________________________
+void MatchTOF::findClustersInStrips(int sec, const std::array<std::array<int, 5>, 2>& detId, int nStrips, double minTime, double maxTime, std::vector<std::pair<int, int>>& candidates) const
+{
+  ///< get the (position in the sector cache, crossed strip) of the clusters of the sector in the strips crossed
+  ///< by the track and in the time window, in the time order of the sector cache
+  candidates.clear();
+  const auto& cacheTOF = mTOFClusSectIndexCache[sec];
+  const auto& stripCache = mTOFClusSectStripIndexCache[sec];
+  for (int iPropagation = 0; iPropagation < nStrips; iPropagation++) {
+    if (detId[iPropagation][0] != sec) { // clusters of the other sectors are not in this sector cache
+      continue;
+    }
+    int strip = Geo::getStripNumberPerSM(detId[iPropagation][1], detId[iPropagation][2]);
+    if (strip < 0) {
+      continue;
+    }
+    auto stripEnd = stripCache.begin() + mTOFClusSectStripFirst[sec][strip + 1];
+    auto it = std::lower_bound(stripCache.begin() + mTOFClusSectStripFirst[sec][strip], stripEnd, minTime, [this, &cacheTOF](int itof, double t) {
+      return mTOFClusWork[cacheTOF[itof]].getTime() < t;
+    });
+    for (; it != stripEnd && mTOFClusWork[cacheTOF[*it]].getTime() <= maxTime; it++) {
+      candidates.emplace_back(*it, iPropagation);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+}
+
+//______________________________________________
+void MatchTOF::doMatching(int sec, int itrkStart, int itrkEnd, std::vector<o2::dataformats::MatchInfoTOF>& matchedPairs)
+{
+
+  ///< do the real matching for the tracks [itrkStart, itrkEnd) of the sector
   auto& cacheTOF = mTOFClusSectIndexCache[sec]; // array of cached TOF cluster indices for this sector; reminder: they are ordered in time!
   auto& cacheTrk = mTracksSectIndexCache[sec];  // array of cached tracks indices for this sector; reminder: they are ordered in time!
-  int nTracks = cacheTrk.size(), nTOFCls = cacheTOF.size();
-  LOG(INFO) << "Matching sector " << sec << ": number of tracks: " << nTracks << ", number of TOF clusters: " << nTOFCls;
-  if (!nTracks || !nTOFCls) {
-    return;
-  }
-  int itof0 = 0;                          // starting index in TOF clusters for matching of the track
-  int detId[2][5];                        // at maximum one track can fall in 2 strips during the propagation; the second dimention of the array is the TOF det index
-  float deltaPos[2][3];                   // at maximum one track can fall in 2 strips during the propagation; the second dimention of the array is the residuals
-  o2::track::TrackLTIntegral trkLTInt[2]; // Here we store the integrated track length and time for the (max 2) matched strips
-  int nStepsInsideSameStrip[2] = {0, 0};  // number of propagation steps in the same strip (since we have maximum 2 strips, it has dimention = 2)
+  std::vector<std::pair<int, int>> candidates;  // TOF clusters in the crossed strips and in the time window of the track
+  std::array<std::array<int, 5>, 2> detId;      // at maximum one track can fall in 2 strips during the propagation; the second dimention of the array is the TOF det index
+  float deltaPos[2][3];                         // at maximum one track can fall in 2 strips during the propagation; the second dimention of the array is the residuals
+  o2::track::TrackLTIntegral trkLTInt[2];       // Here we store the integrated track length and time for the (max 2) matched strips
+  int nStepsInsideSameStrip[2] = {0, 0};        // number of propagation steps in the same strip (since we have maximum 2 strips, it has dimention = 2)
   float deltaPosTemp[3];
   std::array<float, 3> pos;
   std::array<float, 3> posBeforeProp;
@@ -825,8 +908,8 @@ void MatchTOF::doMatching(int sec)
 
   // prematching for TPC only tracks (identify BC candidate to correct z for TPC track accordingly to v_drift)
 
-  LOG(DEBUG) << "Trying to match %d tracks" << cacheTrk.size();
-  for (int itrk = 0; itrk < cacheTrk.size(); itrk++) {
+  LOG(DEBUG) << "Trying to match %d tracks" << itrkEnd - itrkStart;
+  for (int itrk = itrkStart; itrk < itrkEnd; itrk++) {
     for (int ii = 0; ii < 2; ii++) {
       detId[ii][2] = -1; // before trying to match, we need to inizialize the detId corresponding to the strip number to -1; this is the array that we will use to save the det id of the maximum 2 strips matched
       nStepsInsideSameStrip[ii] = 0;
@@ -983,20 +1066,11 @@ void MatchTOF::doMatching(int sec)
       continue; // the track never hit a TOF strip during the propagation
     }
     bool foundCluster = false;
-    for (auto itof = itof0; itof < nTOFCls; itof++) {
-      //      printf("itof = %d\n", itof);
+    // only the clusters in the strips crossed by the track and in its time window can be matched
+    findClustersInStrips(sec, detId, nStripsCrossedInPropagation, minTrkTime, maxTrkTime, candidates);
+    for (const auto& candidate : candidates) {
+      int itof = candidate.first, iPropagation = candidate.second;
       auto& trefTOF = mTOFClusWork[cacheTOF[itof]];
-      // compare the times of the track and the TOF clusters - remember that they both are ordered in time!
-      //Printf("trefTOF.getTime() = %f, maxTrkTime = %f, minTrkTime = %f", trefTOF.getTime(), maxTrkTime, minTrkTime);
-
-      if (trefTOF.getTime() < minTrkTime) { // this cluster has a time that is too small for the current track, we will get to the next one
-        //Printf("In trefTOF.getTime() < minTrkTime");
-        itof0 = itof + 1; // but for the next track that we will check, we will ignore this cluster (the time is anyway too small)
-        continue;
-      }
-      if (trefTOF.getTime() > maxTrkTime) { // no more TOF clusters can be matched to this track
-        break;
-      }
 
       int mainChannel = trefTOF.getMainContributingChannel();
       int indices[5];
@@ -1042,68 +1116,57 @@ void MatchTOF::doMatching(int sec)
       int trackIdTOF;
       int eventIdTOF;
       int sourceIdTOF;
-      for (auto iPropagation = 0; iPropagation < nStripsCrossedInPropagation; iPropagation++) {
-        LOG(DEBUG) << "TOF Cluster [" << itof << ", " << cacheTOF[itof] << "]:      indices   = " << indices[0] << ", " << indices[1] << ", " << indices[2] << ", " << indices[3] << ", " << indices[4];
-        LOG(DEBUG) << "Propagated Track [" << itrk << ", " << cacheTrk[itrk] << "]: detId[" << iPropagation << "]  = " << detId[iPropagation][0] << ", " << detId[iPropagation][1] << ", " << detId[iPropagation][2] << ", " << detId[iPropagation][3] << ", " << detId[iPropagation][4];
-        float resX = deltaPos[iPropagation][0] - (indices[4] - detId[iPropagation][4]) * Geo::XPAD + posCorr[0]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
-        float resZ = deltaPos[iPropagation][2] - (indices[3] - detId[iPropagation][3]) * Geo::ZPAD + posCorr[2]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
-        float res = TMath::Sqrt(resX * resX + resZ * resZ);
+      LOG(DEBUG) << "TOF Cluster [" << itof << ", " << cacheTOF[itof] << "]:      indices   = " << indices[0] << ", " << indices[1] << ", " << indices[2] << ", " << indices[3] << ", " << indices[4];
+      LOG(DEBUG) << "Propagated Track [" << itrk << ", " << cacheTrk[itrk] << "]: detId[" << iPropagation << "]  = " << detId[iPropagation][0] << ", " << detId[iPropagation][1] << ", " << detId[iPropagation][2] << ", " << detId[iPropagation][3] << ", " << detId[iPropagation][4];
+      float resX = deltaPos[iPropagation][0] - (indices[4] - detId[iPropagation][4]) * Geo::XPAD + posCorr[0]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
+      float resZ = deltaPos[iPropagation][2] - (indices[3] - detId[iPropagation][3]) * Geo::ZPAD + posCorr[2]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
+      float res = TMath::Sqrt(resX * resX + resZ * resZ);
 
-        LOG(DEBUG) << "resX = " << resX << ", resZ = " << resZ << ", res = " << res;
+      LOG(DEBUG) << "resX = " << resX << ", resZ = " << resZ << ", res = " << res;
 #ifdef _ALLOW_TOF_DEBUG_
-        fillTOFmatchTree("match0", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
-        int tofLabelTrackID[3] = {-1, -1, -1};
-        int tofLabelEventID[3] = {-1, -1, -1};
-        int tofLabelSourceID[3] = {-1, -1, -1};
-        if (mMCTruthON) {
-          const auto& labelsTOF = mTOFClusLabels.getLabels(mTOFClusSectIndexCache[indices[0]][itof]);
-          for (int ilabel = 0; ilabel < labelsTOF.size(); ilabel++) {
-            tofLabelTrackID[ilabel] = labelsTOF[ilabel].getTrackID();
-            tofLabelEventID[ilabel] = labelsTOF[ilabel].getEventID();
-            tofLabelSourceID[ilabel] = labelsTOF[ilabel].getSourceID();
-          }
-          auto labelTPC = mTPCLabels[mTracksSectIndexCache[sec][itrk]];
-          fillTOFmatchTreeWithLabels("matchPossibleWithLabels", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, labelTPC.getTrackID(), labelTPC.getEventID(), labelTPC.getSourceID(), tofLabelTrackID[0], tofLabelEventID[0], tofLabelSourceID[0], tofLabelTrackID[1], tofLabelEventID[1], tofLabelSourceID[1], tofLabelTrackID[2], tofLabelEventID[2], tofLabelSourceID[2], trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
+      fillTOFmatchTree("match0", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
+      int tofLabelTrackID[3] = {-1, -1, -1};
+      int tofLabelEventID[3] = {-1, -1, -1};
+      int tofLabelSourceID[3] = {-1, -1, -1};
+      if (mMCTruthON) {
+        const auto& labelsTOF = mTOFClusLabels.getLabels(mTOFClusSectIndexCache[indices[0]][itof]);
+        for (int ilabel = 0; ilabel < labelsTOF.size(); ilabel++) {
+          tofLabelTrackID[ilabel] = labelsTOF[ilabel].getTrackID();
+          tofLabelEventID[ilabel] = labelsTOF[ilabel].getEventID();
+          tofLabelSourceID[ilabel] = labelsTOF[ilabel].getSourceID();
         }
+        auto labelTPC = mTPCLabels[mTracksSectIndexCache[sec][itrk]];
+        fillTOFmatchTreeWithLabels("matchPossibleWithLabels", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, labelTPC.getTrackID(), labelTPC.getEventID(), labelTPC.getSourceID(), tofLabelTrackID[0], tofLabelEventID[0], tofLabelSourceID[0], tofLabelTrackID[1], tofLabelEventID[1], tofLabelSourceID[1], tofLabelTrackID[2], tofLabelEventID[2], tofLabelSourceID[2], trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
+      }
 #endif
-        if (indices[0] != detId[iPropagation][0]) {
-          continue;
-        }
-        if (indices[1] != detId[iPropagation][1]) {
-          continue;
-        }
-        if (indices[2] != detId[iPropagation][2]) {
-          continue;
-        }
-        float chi2 = res; // TODO: take into account also the time!
+      float chi2 = res; // TODO: take into account also the time!
 #ifdef _ALLOW_TOF_DEBUG_
-        fillTOFmatchTree("match1", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
-        if (mMCTruthON) {
-          auto labelTPC = mTPCLabels[mTracksSectIndexCache[sec][itrk]];
-          fillTOFmatchTreeWithLabels("matchOkWithLabels", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, labelTPC.getTrackID(), labelTPC.getEventID(), labelTPC.getSourceID(), tofLabelTrackID[0], tofLabelEventID[0], tofLabelSourceID[0], tofLabelTrackID[1], tofLabelEventID[1], tofLabelSourceID[1], tofLabelTrackID[2], tofLabelEventID[2], tofLabelSourceID[2], trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
-        }
+      fillTOFmatchTree("match1", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
+      if (mMCTruthON) {
+        auto labelTPC = mTPCLabels[mTracksSectIndexCache[sec][itrk]];
+        fillTOFmatchTreeWithLabels("matchOkWithLabels", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, labelTPC.getTrackID(), labelTPC.getEventID(), labelTPC.getSourceID(), tofLabelTrackID[0], tofLabelEventID[0], tofLabelSourceID[0], tofLabelTrackID[1], tofLabelEventID[1], tofLabelSourceID[1], tofLabelTrackID[2], tofLabelEventID[2], tofLabelSourceID[2], trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
+      }
 #endif
 
-        if (res < mSpaceTolerance) { // matching ok!
-          LOG(DEBUG) << "MATCHING FOUND: We have a match! between track " << mTracksSectIndexCache[indices[0]][itrk] << " and TOF cluster " << mTOFClusSectIndexCache[indices[0]][itof];
-          foundCluster = true;
-          // set event indexes (to be checked)
-          evIdx eventIndexTOFCluster(trefTOF.getEntryInTree(), mTOFClusSectIndexCache[indices[0]][itof]);
-          evGIdx eventIndexTracks(mCurrTracksTreeEntry, {uint32_t(mTracksSectIndexCache[indices[0]][itrk]), o2::dataformats::GlobalTrackID::ITSTPC});
-          mMatchedTracksPairs.emplace_back(eventIndexTOFCluster, chi2, trkLTInt[iPropagation], eventIndexTracks); // TODO: check if this is correct!
+      if (res < mSpaceTolerance) { // matching ok!
+        LOG(DEBUG) << "MATCHING FOUND: We have a match! between track " << mTracksSectIndexCache[indices[0]][itrk] << " and TOF cluster " << mTOFClusSectIndexCache[indices[0]][itof];
+        foundCluster = true;
+        // set event indexes (to be checked)
+        evIdx eventIndexTOFCluster(trefTOF.getEntryInTree(), mTOFClusSectIndexCache[indices[0]][itof]);
+        evGIdx eventIndexTracks(mCurrTracksTreeEntry, {uint32_t(mTracksSectIndexCache[indices[0]][itrk]), o2::dataformats::GlobalTrackID::ITSTPC});
+        matchedPairs.emplace_back(eventIndexTOFCluster, chi2, trkLTInt[iPropagation], eventIndexTracks); // TODO: check if this is correct!
 
 #ifdef _ALLOW_TOF_DEBUG_
-          if (mMCTruthON) {
-            const auto& labelsTOF = mTOFClusLabels.getLabels(mTOFClusSectIndexCache[indices[0]][itof]);
-            auto labelTPC = mTPCLabels[mTracksSectIndexCache[sec][itrk]];
-            for (int ilabel = 0; ilabel < labelsTOF.size(); ilabel++) {
-              LOG(DEBUG) << "TOF label " << ilabel << labelsTOF[ilabel];
-            }
-            LOG(DEBUG) << "TPC label " << labelTPC;
-            fillTOFmatchTreeWithLabels("matchOkWithLabelsInSpaceTolerance", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, labelTPC.getTrackID(), labelTPC.getEventID(), labelTPC.getSourceID(), tofLabelTrackID[0], tofLabelEventID[0], tofLabelSourceID[0], tofLabelTrackID[1], tofLabelEventID[1], tofLabelSourceID[1], tofLabelTrackID[2], tofLabelEventID[2], tofLabelSourceID[2], trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
+        if (mMCTruthON) {
+          const auto& labelsTOF = mTOFClusLabels.getLabels(mTOFClusSectIndexCache[indices[0]][itof]);
+          auto labelTPC = mTPCLabels[mTracksSectIndexCache[sec][itrk]];
+          for (int ilabel = 0; ilabel < labelsTOF.size(); ilabel++) {
+            LOG(DEBUG) << "TOF label " << ilabel << labelsTOF[ilabel];
           }
-#endif
+          LOG(DEBUG) << "TPC label " << labelTPC;
+          fillTOFmatchTreeWithLabels("matchOkWithLabelsInSpaceTolerance", cacheTOF[itof], indices[0], indices[1], indices[2], indices[3], indices[4], cacheTrk[itrk], iPropagation, detId[iPropagation][0], detId[iPropagation][1], detId[iPropagation][2], detId[iPropagation][3], detId[iPropagation][4], resX, resZ, res, trackWork, labelTPC.getTrackID(), labelTPC.getEventID(), labelTPC.getSourceID(), tofLabelTrackID[0], tofLabelEventID[0], tofLabelSourceID[0], tofLabelTrackID[1], tofLabelEventID[1], tofLabelSourceID[1], tofLabelTrackID[2], tofLabelEventID[2], tofLabelSourceID[2], trkLTInt[iPropagation].getL(), trkLTInt[iPropagation].getTOF(o2::track::PID::Pion), trefTOF.getTime());
         }
+#endif
       }
     }
     if (!foundCluster && mMCTruthON) {
@@ -1114,7 +1177,7 @@ void MatchTOF::doMatching(int sec)
   return;
 }
 //______________________________________________
-void MatchTOF::doMatchingForTPC(int sec)
+void MatchTOF::doMatchingForTPC(int sec, int itrkStart, int itrkEnd, std::vector<o2::dataformats::MatchInfoTOF>& matchedPairs)
 {
   auto& gasParam = o2::tpc::ParameterGas::Instance();
   float vdrift = gasParam.DriftV;
@@ -1125,17 +1188,11 @@ void MatchTOF::doMatchingForTPC(int sec)
   int bc_grouping_half = (bc_grouping + 1) / 2;
   double BCgranularity = Geo::BC_TIME_INPS * bc_grouping;
 
-  ///< do the real matching per sector
-  mMatchedTracksPairs.clear(); // new sector
-
+  ///< do the real matching for the tracks [itrkStart, itrkEnd) of the sector
   auto& cacheTOF = mTOFClusSectIndexCache[sec]; // array of cached TOF cluster indices for this sector; reminder: they are ordered in time!
   auto& cacheTrk = mTracksSectIndexCache[sec];  // array of cached tracks indices for this sector; reminder: they are ordered in time!
-  int nTracks = cacheTrk.size(), nTOFCls = cacheTOF.size();
-  LOG(INFO) << "Matching sector " << sec << ": number of tracks: " << nTracks << ", number of TOF clusters: " << nTOFCls;
-  if (!nTracks || !nTOFCls) {
-    return;
-  }
-  int itof0 = 0; // starting index in TOF clusters for matching of the track
+  int nTOFCls = cacheTOF.size();
+  std::vector<std::pair<int, int>> candidates; // TOF clusters in the crossed strips and in the time window of the BC candidate
   float deltaPosTemp[3];
   std::array<float, 3> pos;
   std::array<float, 3> posBeforeProp;
@@ -1151,9 +1208,9 @@ void MatchTOF::doMatchingForTPC(int sec)
   std::vector<std::array<std::array<float, 3>, 2>> deltaPos;
   std::vector<std::array<int, 2>> nStepsInsideSameStrip;
 
-  LOG(DEBUG) << "Trying to match %d tracks" << cacheTrk.size();
+  LOG(DEBUG) << "Trying to match %d tracks" << itrkEnd - itrkStart;
 
-  for (int itrk = 0; itrk < cacheTrk.size(); itrk++) {
+  for (int itrk = itrkStart; itrk < itrkEnd; itrk++) {
     auto& trackWork = mTracksWork[cacheTrk[itrk]];
     auto& trefTrk = trackWork.first;
     auto& intLT = mLTinfos[cacheTrk[itrk]];
@@ -1164,7 +1221,6 @@ void MatchTOF::doMatchingForTPC(int sec)
     int side = mSideTPC[cacheTrk[itrk]];
 
     // look at BC candidates for the track
-    itof0 = 0;
     double minTrkTime = (trackWork.second.getTimeStamp() - trackWork.second.getTimeStampError()) * 1.E6; // minimum time in ps
     minTrkTime = int(minTrkTime / BCgranularity) * BCgranularity;                                        // align min to a BC
     double maxTrkTime = (trackWork.second.getTimeStamp() + mExtraTPCFwdTime[cacheTrk[itrk]]) * 1.E6;     // maximum time in ps
@@ -1179,16 +1235,13 @@ void MatchTOF::doMatchingForTPC(int sec)
       }
     }
 
+    // first TOF cluster in the time window of the track
+    int itof0 = std::lower_bound(cacheTOF.begin(), cacheTOF.end(), minTrkTime, [this](int idx, double t) { return mTOFClusWork[idx].getTime() < t; }) - cacheTOF.begin();
     for (auto itof = itof0; itof < nTOFCls; itof++) {
       auto& trefTOF = mTOFClusWork[cacheTOF[itof]];
 
 //     printf("clus time = %f\n",trefTOF.getTime());
 
-      if (trefTOF.getTime() < minTrkTime) { // this cluster has a time that is too small for the current track, we will get to the next one
-        itof0 = itof + 1;
-        continue;
-      }
-
       if (trefTOF.getTime() > maxTrkTime) { // this cluster has a time that is too large for the current track, close loop
         break;
       }
@@ -1217,14 +1270,10 @@ void MatchTOF::doMatchingForTPC(int sec)
 
     //    printf("BC = %ld\n",BCcand.size());
 
-    detId.clear();
-    detId.reserve(BCcand.size());
-    trkLTInt.clear();
-    trkLTInt.reserve(BCcand.size());
-    deltaPos.clear();
-    deltaPos.reserve(BCcand.size());
-    nStepsInsideSameStrip.clear();
-    nStepsInsideSameStrip.reserve(BCcand.size());
+    detId.resize(BCcand.size());
+    trkLTInt.resize(BCcand.size());
+    deltaPos.resize(BCcand.size());
+    nStepsInsideSameStrip.resize(BCcand.size());
 
     // printf("%d) ts_error = %f -- z_error = %f\n", itrk, trackWork.second.getTimeStampError(), trackWork.second.getTimeStampError() * vdrift);
 
@@ -1346,19 +1395,11 @@ void MatchTOF::doMatchingForTPC(int sec)
       }
 
       bool foundCluster = false;
-      itof0 = 0;
-      for (auto itof = itof0; itof < nTOFCls; itof++) {
-        //      printf("itof = %d\n", itof);
+      // only the clusters in the strips crossed by the track and in the time window of the BC candidate can be matched
+      findClustersInStrips(sec, detId[ibc], nStripsCrossedInPropagation[ibc], minTime, maxTime, candidates);
+      for (const auto& candidate : candidates) {
+        int itof = candidate.first, iPropagation = candidate.second;
         auto& trefTOF = mTOFClusWork[cacheTOF[itof]];
-        // compare the times of the track and the TOF clusters - remember that they both are ordered in time!
-
-        if (trefTOF.getTime() < minTime) { // this cluster has a time that is too small for the current track, we will get to the next one
-          itof0 = itof + 1; // but for the next track that we will check, we will ignore this cluster (the time is anyway too small)
-          continue;
-        }
-        if (trefTOF.getTime() > maxTime) { // no more TOF clusters can be matched to this track
-          break;
-        }
         unsigned long bcClus = trefTOF.getTime() * Geo::BC_TIME_INPS_INV;
 
         int mainChannel = trefTOF.getMainContributingChannel();
@@ -1405,39 +1446,27 @@ void MatchTOF::doMatchingForTPC(int sec)
         int trackIdTOF;
         int eventIdTOF;
         int sourceIdTOF;
-        for (auto iPropagation = 0; iPropagation < nStripsCrossedInPropagation[ibc]; iPropagation++) {
-          LOG(DEBUG) << "TOF Cluster [" << itof << ", " << cacheTOF[itof] << "]:      indices   = " << indices[0] << ", " << indices[1] << ", " << indices[2] << ", " << indices[3] << ", " << indices[4];
-          LOG(DEBUG) << "Propagated Track [" << itrk << ", " << cacheTrk[itrk] << "]: detId[" << iPropagation << "]  = " << detId[ibc][iPropagation][0] << ", " << detId[ibc][iPropagation][1] << ", " << detId[ibc][iPropagation][2] << ", " << detId[ibc][iPropagation][3] << ", " << detId[ibc][iPropagation][4];
-          float resX = deltaPos[ibc][iPropagation][0] - (indices[4] - detId[ibc][iPropagation][4]) * Geo::XPAD + posCorr[0]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
-          float resZ = deltaPos[ibc][iPropagation][2] - (indices[3] - detId[ibc][iPropagation][3]) * Geo::ZPAD + posCorr[2]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
-          if (BCcand[ibc] > bcClus) {
-            resZ += (BCcand[ibc] - bcClus) * vdriftInBC * side; // add bc correction
-          } else {
-            resZ -= (bcClus - BCcand[ibc]) * vdriftInBC * side;
-          }
-          float res = TMath::Sqrt(resX * resX + resZ * resZ);
-
-          if (indices[0] != detId[ibc][iPropagation][0]) {
-            continue;
-          }
-          if (indices[1] != detId[ibc][iPropagation][1]) {
-            continue;
-          }
-          if (indices[2] != detId[ibc][iPropagation][2]) {
-            continue;
-          }
+        LOG(DEBUG) << "TOF Cluster [" << itof << ", " << cacheTOF[itof] << "]:      indices   = " << indices[0] << ", " << indices[1] << ", " << indices[2] << ", " << indices[3] << ", " << indices[4];
+        LOG(DEBUG) << "Propagated Track [" << itrk << ", " << cacheTrk[itrk] << "]: detId[" << iPropagation << "]  = " << detId[ibc][iPropagation][0] << ", " << detId[ibc][iPropagation][1] << ", " << detId[ibc][iPropagation][2] << ", " << detId[ibc][iPropagation][3] << ", " << detId[ibc][iPropagation][4];
+        float resX = deltaPos[ibc][iPropagation][0] - (indices[4] - detId[ibc][iPropagation][4]) * Geo::XPAD + posCorr[0]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
+        float resZ = deltaPos[ibc][iPropagation][2] - (indices[3] - detId[ibc][iPropagation][3]) * Geo::ZPAD + posCorr[2]; // readjusting the residuals due to the fact that the propagation fell in a pad that was not exactly the one of the cluster
+        if (BCcand[ibc] > bcClus) {
+          resZ += (BCcand[ibc] - bcClus) * vdriftInBC * side; // add bc correction
+        } else {
+          resZ -= (bcClus - BCcand[ibc]) * vdriftInBC * side;
+        }
+        float res = TMath::Sqrt(resX * resX + resZ * resZ);
 
-          LOG(DEBUG) << "resX = " << resX << ", resZ = " << resZ << ", res = " << res;
-          float chi2 = mIsCosmics ? resX : res; // TODO: take into account also the time!
+        LOG(DEBUG) << "resX = " << resX << ", resZ = " << resZ << ", res = " << res;
+        float chi2 = mIsCosmics ? resX : res; // TODO: take into account also the time!
 
-          if (res < mSpaceTolerance) { // matching ok!
-            LOG(DEBUG) << "MATCHING FOUND: We have a match! between track " << mTracksSectIndexCache[indices[0]][itrk] << " and TOF cluster " << mTOFClusSectIndexCache[indices[0]][itof];
-            foundCluster = true;
-            // set event indexes (to be checked)
-            evIdx eventIndexTOFCluster(trefTOF.getEntryInTree(), mTOFClusSectIndexCache[indices[0]][itof]);
-            evGIdx eventIndexTracks(mCurrTracksTreeEntry, {uint32_t(mTracksSectIndexCache[indices[0]][itrk]), o2::dataformats::GlobalTrackID::TPC});
-            mMatchedTracksPairs.emplace_back(eventIndexTOFCluster, chi2, trkLTInt[ibc][iPropagation], eventIndexTracks, resZ / vdrift * side, trefTOF.getZ()); // TODO: check if this is correct!
-          }
+        if (res < mSpaceTolerance) { // matching ok!
+          LOG(DEBUG) << "MATCHING FOUND: We have a match! between track " << mTracksSectIndexCache[indices[0]][itrk] << " and TOF cluster " << mTOFClusSectIndexCache[indices[0]][itof];
+          foundCluster = true;
+          // set event indexes (to be checked)
+          evIdx eventIndexTOFCluster(trefTOF.getEntryInTree(), mTOFClusSectIndexCache[indices[0]][itof]);
+          evGIdx eventIndexTracks(mCurrTracksTreeEntry, {uint32_t(mTracksSectIndexCache[indices[0]][itrk]), o2::dataformats::GlobalTrackID::TPC});
+          matchedPairs.emplace_back(eventIndexTOFCluster, chi2, trkLTInt[ibc][iPropagation], eventIndexTracks, resZ / vdrift * side, trefTOF.getZ()); // TODO: check if this is correct!
         }
       }
       if (!foundCluster && mMCTruthON) {
@@ -1628,6 +1657,16 @@ void MatchTOF::setDebugFlag(UInt_t flag, bool on)
   }
 }
 
+//_________________________________________________________
+void MatchTOF::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //_________________________________________________________
 void MatchTOF::fillTOFmatchTree(const char* trname, int cacheTOF, int sectTOF, int plateTOF, int stripTOF, int padXTOF, int padZTOF, int cacheeTrk, int crossedStrip, int sectPropagation, int platePropagation, int stripPropagation, int padXPropagation, int padZPropagation, float resX, float resZ, float res, matchTrack& trk, float intLength, float intTimePion, float timeTOF)
 {
@@ -265,9 +265,20 @@ void MatchTPCITS::run()
   }
 
   mTimer[SWDoMatching].Start(false);
-  for (int sec = o2::constants::math::NSectors; sec--;) {
+  // sectors are independent until the candidates are registered, so they can be processed in parallel
+  int nThreads = mParams->nThreads;
+#ifdef _ALLOW_DEBUG_TREES_
+  if (mDBGOut) {
+    nThreads = 1; // debug tree filling is not thread-safe
+  }
+#endif
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
     doMatching(sec);
   }
+  registerMatchCandidates();
   mTimer[SWDoMatching].Stop();
   if (0) { // enabling this creates very verbose output
     mTimer[SWTot].Stop();
@@ -316,6 +327,9 @@ void MatchTPCITS::clear()
   ///< clear results of previous TF reconstruction
   mMatchRecordsTPC.clear();
   mMatchRecordsITS.clear();
+  for (auto& candidates : mSectorMatchCandidates) {
+    candidates.clear();
+  }
   mWinnerChi2Refit.clear();
   mMatchedTracks.clear();
   if (mMCTruthON) {
@@ -809,6 +823,7 @@ void MatchTPCITS::doMatching(int sec)
   auto& cacheTPC = mTPCSectIndexCache[sec];   // array of cached ITS track indices for this sector
   auto& tbinStartTPC = mTPCTimeBinStart[sec]; // array of 1st TPC track with timeMax in ITS ROFrame
   auto& tbinStartITS = mITSTimeBinStart[sec];
+  auto& candidates = mSectorMatchCandidates[sec]; // matching candidates found in this sector
   int nTracksTPC = cacheTPC.size(), nTracksITS = cacheITS.size();
   if (!nTracksTPC || !nTracksITS) {
     LOG(INFO) << "Matchng sector " << sec << " : N tracks TPC:" << nTracksTPC << " ITS:" << nTracksITS << " in sector " << sec;
@@ -929,7 +944,7 @@ void MatchTPCITS::doMatching(int sec)
           continue;
         }
       }
-      registerMatchRecordTPC(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // register matching candidate
+      candidates.emplace_back(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // store matching candidate
       nMatchesControl++;
     }
   }
@@ -939,6 +954,18 @@ void MatchTPCITS::doMatching(int sec)
             << "), checks: " << nCheckITSControl << ", matches:" << nMatchesControl;
 }
 
+//______________________________________________
+void MatchTPCITS::registerMatchCandidates()
+{
+  ///< register matching candidates of all sectors in the MatchRecords. The sectors are processed in the
+  ///< same order as the serial matching did, so that the result does not depend on the number of threads
+  for (int sec = o2::constants::math::NSectors; sec--;) {
+    for (const auto& cand : mSectorMatchCandidates[sec]) {
+      registerMatchRecordTPC(cand.iITS, cand.iTPC, cand.chi2, cand.matchedIC);
+    }
+  }
+}
+
 //______________________________________________
 void MatchTPCITS::suppressMatchRecordITS(int itsID, int tpcID)
 {
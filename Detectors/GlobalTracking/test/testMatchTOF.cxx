@@ -0,0 +1,156 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MatchTOF class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "GlobalTracking/MatchTOF.h"
+#include "DetectorsBase/Propagator.h"
+#include "DetectorsBase/MatLayerCylSet.h"
+#include "Field/MagneticField.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "CommonConstants/MathConstants.h"
+#include "TOFBase/Geo.h"
+#include "MathUtils/Utils.h"
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <TGeoMaterial.h>
+#include <TGeoMedium.h>
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace globaltracking
+{
+
+using Geo = o2::tof::Geo;
+using Cluster = o2::tof::Cluster;
+
+struct MatchingResult {
+  std::vector<o2::dataformats::MatchInfoTOF> matches;
+  std::vector<o2::dataformats::CalibInfoTOF> calibInfos;
+};
+
+// the matching runs on several threads only with a material LUT: make one from an air world filling the TOF radii
+void setupPropagator(o2::base::MatLayerCylSet& lut)
+{
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(new o2::field::MagneticField("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  if (!gGeoManager) {
+    auto geom = new TGeoManager("matchtof", "air world");
+    auto air = new TGeoMedium("Air", 1, new TGeoMaterial("Air", 14.61, 7.3, 1.205e-3));
+    geom->SetTopVolume(geom->MakeTube("World", air, 0., 500., 500.));
+    geom->CloseGeometry();
+  }
+  lut.addLayer(360., 405., 400., 20., 20.);
+  lut.populateFromTGeo(2);
+  lut.optimizePhiSlices();
+  lut.flatten();
+  o2::base::Propagator::Instance()->setMatLUT(&lut);
+}
+
+// tracks at the outer TPC radius in all sectors, each with a TOF cluster in the pad it crosses, plus noise clusters
+void generateEvent(std::vector<o2::dataformats::TrackTPCITS>& tracks, std::vector<Cluster>& clusters)
+{
+  std::mt19937 gen(2020);
+  std::uniform_real_distribution<float> flat(-1.f, 1.f);
+  std::uniform_real_distribution<float> time(0.f, 20.f);
+  std::uniform_int_distribution<int> channel(0, Geo::NCHANNELS - 1);
+  auto prop = o2::base::Propagator::Instance();
+  std::array<float, 15> cov{1e-2, 0., 1e-2, 0., 0., 1e-4, 0., 0., 0., 1e-4, 0., 0., 0., 0., 1e-3};
+  const float tofShift = 13000.f; // rough time of flight in ps, the time cut is in units of the track time error anyway
+
+  auto addCluster = [&clusters](int ch, float timePS) {
+    Cluster cl;
+    cl.setMainContributingChannel(ch);
+    cl.setTime(timePS);
+    cl.setTimeRaw(timePS);
+    cl.setTot(10.f);
+    clusters.push_back(cl);
+  };
+
+  for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+    for (int itr = 0; itr < 150; itr++) {
+      std::array<float, 5> par{10.f * flat(gen), 300.f * flat(gen), 0.1f * flat(gen), 0.3f * flat(gen), flat(gen)};
+      o2::track::TrackParCov trc(365.f, o2::math_utils::sector2Angle(sec), par, cov);
+      o2::dataformats::TrackTPCITS trcTPCITS(trc, trc);
+      float trcTime = time(gen);
+      trcTPCITS.setTimeMUS(trcTime, 0.1f);
+      tracks.push_back(trcTPCITS);
+
+      // a cluster in the first pad crossed by the track, like the matching propagation does
+      for (float x = Geo::RMIN + 1.f; x < Geo::RMAX && prop->PropagateToXBxByBz(trc, x, 0.95f, 1.f); x += 1.f) {
+        std::array<float, 3> pos;
+        trc.getXYZGlo(pos);
+        float posFloat[3] = {pos[0], pos[1], pos[2]}, deltaPos[3];
+        int detId[5] = {-1, -1, -1, -1, -1};
+        Geo::getPadDxDyDz(posFloat, detId, deltaPos);
+        if (detId[2] != -1) {
+          addCluster(Geo::getIndex(detId), trcTime * 1.E6 + tofShift);
+          break;
+        }
+      }
+    }
+  }
+  for (int inoise = 0; inoise < 20000; inoise++) {
+    addCluster(channel(gen), time(gen) * 1.E6 + tofShift);
+  }
+}
+
+MatchingResult runMatching(int nThreads, const std::vector<o2::dataformats::TrackTPCITS>& tracks, const std::vector<Cluster>& clusters)
+{
+  MatchTOF matching;
+  matching.setNThreads(nThreads);
+  o2::dataformats::MCTruthContainer<o2::MCCompLabel> tofLabels;
+  std::vector<o2::MCCompLabel> tracksLabels;
+  matching.run(tracks, clusters, tofLabels, tracksLabels);
+  return {matching.getMatchedTrackVector(), matching.getCalibVector()};
+}
+
+// the matched pairs found with several threads must be identical to those found with one
+BOOST_AUTO_TEST_CASE(MatchTOF_Threads)
+{
+  o2::base::MatLayerCylSet lut;
+  setupPropagator(lut);
+
+  std::vector<o2::dataformats::TrackTPCITS> tracks;
+  std::vector<Cluster> clusters;
+  generateEvent(tracks, clusters);
+
+  auto serial = runMatching(1, tracks, clusters);
+  BOOST_CHECK(serial.matches.size() > 0);
+  for (int nThreads : {2, 4}) {
+    auto parallel = runMatching(nThreads, tracks, clusters);
+    BOOST_REQUIRE_EQUAL(serial.matches.size(), parallel.matches.size());
+    for (size_t im = 0; im < serial.matches.size(); im++) {
+      const auto &ms = serial.matches[im], &mp = parallel.matches[im];
+      BOOST_CHECK_EQUAL(ms.getTOFClIndex(), mp.getTOFClIndex());
+      BOOST_CHECK_EQUAL(ms.getTrackIndex(), mp.getTrackIndex());
+      BOOST_CHECK_EQUAL(ms.getChi2(), mp.getChi2());
+      BOOST_CHECK_EQUAL(ms.getLTIntegralOut().getL(), mp.getLTIntegralOut().getL());
+      BOOST_CHECK_EQUAL(ms.getLTIntegralOut().getTOF(o2::track::PID::Pion), mp.getLTIntegralOut().getTOF(o2::track::PID::Pion));
+    }
+    BOOST_REQUIRE_EQUAL(serial.calibInfos.size(), parallel.calibInfos.size());
+    for (size_t ic = 0; ic < serial.calibInfos.size(); ic++) {
+      const auto &cs = serial.calibInfos[ic], &cp = parallel.calibInfos[ic];
+      BOOST_CHECK_EQUAL(cs.getTOFChIndex(), cp.getTOFChIndex());
+      BOOST_CHECK_EQUAL(cs.getTimestamp(), cp.getTimestamp());
+      BOOST_CHECK_EQUAL(cs.getDeltaTimePi(), cp.getDeltaTimePi());
+    }
+  }
+}
+
+} // namespace globaltracking
+} // namespace o2
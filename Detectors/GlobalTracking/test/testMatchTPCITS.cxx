@@ -0,0 +1,216 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MatchTPCITS class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "GlobalTracking/MatchTPCITS.h"
+#include "DetectorsBase/Propagator.h"
+#include "DetectorsBase/GeometryManager.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include "CommonConstants/LHCConstants.h"
+#include "CommonConstants/MathConstants.h"
+#include "CommonDataFormat/BunchFilling.h"
+#include "CommonUtils/ConfigurableParam.h"
+#include "DataFormatsITS/TrackITS.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "DataFormatsTPC/ClusterNative.h"
+#include "DataFormatsTPC/TrackTPC.h"
+#include "TPCBase/ParameterElectronics.h"
+#include "Field/MagneticField.h"
+#include "MathUtils/Utils.h"
+#include <TGeoGlobalMagField.h>
+#include <TSystem.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace globaltracking
+{
+
+constexpr int NROFs = 20;            // number of ITS readout frames
+constexpr int NROFBC = 198;          // ITS readout frame length in BCs
+constexpr int NTracksPerSector = 10; // tracks per sector and readout frame
+constexpr int NClustersTPC = 30;     // TPC clusters per track, on the innermost pad rows
+
+struct TPCITSInput {
+  std::vector<o2::its::TrackITS> tracksITS;
+  std::vector<int> trackClusIdxITS;
+  std::vector<o2::itsmft::ROFRecord> trackROFsITS;
+  std::vector<o2::itsmft::ROFRecord> clusterROFsITS;
+  std::vector<MatchTPCITS::ITSCluster> clustersITS;
+  std::vector<o2::tpc::TrackTPC> tracksTPC;
+  std::vector<o2::tpc::TPCClRefElem> clusRefsTPC;
+  std::vector<o2::tpc::ClusterNative> clustersTPC;
+  std::vector<unsigned char> sharingMapTPC;
+  o2::tpc::ClusterNativeAccess clusterAccessTPC;
+};
+
+struct MatchingResult {
+  std::vector<MatchRecord> recordsTPC;
+  std::vector<MatchRecord> recordsITS;
+  std::vector<o2::dataformats::TrackTPCITS> matches;
+};
+
+// the ITS tracks and clusters need the full geometry, create it like the material LUT test does
+void setupPropagator()
+{
+  auto geomName = o2::base::NameConf::getGeomFileName();
+  if (gSystem->AccessPathName(geomName.c_str())) { // if needed, create geometry
+    gSystem->Exec("$O2_ROOT/bin/o2-sim -n 0");
+  }
+  o2::base::GeometryManager::loadGeometry();
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(new o2::field::MagneticField("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  o2::base::Propagator::Instance();
+}
+
+// ITS and TPC tracks of the same particles at the matching reference X, the TPC ones with the time of their ITS readout frame
+void generateInput(TPCITSInput& inp)
+{
+  std::mt19937 gen(2021);
+  std::uniform_real_distribution<float> flat(-1.f, 1.f);
+  std::normal_distribution<float> gaus(0.f, 1.f);
+  std::array<float, 15> cov{0.1, 0., 1., 0., 0., 1e-4, 0., 0., 0., 1e-4, 0., 0., 0., 0., 1e-3};
+  const float rof2TPCBin = NROFBC * o2::constants::lhc::LHCBunchSpacingNS * 1e-3 / o2::tpc::ParameterElectronics::Instance().ZbinWidth;
+
+  for (int rof = 0; rof < NROFs; rof++) {
+    o2::InteractionRecord ir;
+    ir.setFromLong(int64_t(rof) * NROFBC);
+    int firstTrack = inp.tracksITS.size();
+    for (int sec = 0; sec < o2::constants::math::NSectors; sec++) {
+      for (int itr = 0; itr < NTracksPerSector; itr++) {
+        std::array<float, 5> par{5.f * flat(gen), 50.f * flat(gen), 0.2f * flat(gen), 0.8f * flat(gen), 2.f * flat(gen)};
+        o2::track::TrackParCov trcITS(MatchTPCITS::XMatchingRef, o2::math_utils::sector2Angle(sec), par, cov);
+        inp.tracksITS.emplace_back(trcITS, 1.f, trcITS);
+        for (int i = 0; i < 5; i++) {
+          par[i] += 0.3f * std::sqrt(cov[o2::track::DiagMap[i]]) * gaus(gen);
+        }
+        auto& trcTPC = inp.tracksTPC.emplace_back(MatchTPCITS::XMatchingRef, o2::math_utils::sector2Angle(sec), par, cov);
+        trcTPC.setTime0((rof + 0.5f) * rof2TPCBin);
+        trcTPC.setDeltaTBwd(10.f);
+        trcTPC.setDeltaTFwd(10.f);
+        int sectorTPC = sec;
+        if (par[o2::track::kZ] > 0) {
+          trcTPC.setHasASideClusters();
+        } else {
+          trcTPC.setHasCSideClusters();
+          sectorTPC += o2::constants::math::NSectors;
+        }
+        // cluster indices, then sectors and rows, the last cluster being the innermost one
+        int firstRef = inp.clusRefsTPC.size();
+        trcTPC.setClusterRef(firstRef, NClustersTPC);
+        inp.clusRefsTPC.resize(firstRef + NClustersTPC + (2 * NClustersTPC + 3) / 4);
+        auto clusIdx = &inp.clusRefsTPC[firstRef];
+        auto sectorRow = reinterpret_cast<uint8_t*>(clusIdx + NClustersTPC);
+        for (int icl = 0; icl < NClustersTPC; icl++) {
+          clusIdx[icl] = 0;
+          sectorRow[icl] = sectorTPC;
+          sectorRow[icl + NClustersTPC] = NClustersTPC - 1 - icl;
+        }
+      }
+    }
+    inp.trackROFsITS.emplace_back(ir, rof, firstTrack, inp.tracksITS.size() - firstTrack);
+    inp.clusterROFsITS.emplace_back(ir, rof, 0, 0);
+  }
+
+  // one cluster per row on the rows used by the tracks, the refit outcome is irrelevant as long as it is deterministic
+  auto& access = inp.clusterAccessTPC;
+  for (int sector = 0; sector < o2::tpc::constants::MAXSECTOR; sector++) {
+    for (int row = 0; row < o2::tpc::constants::MAXGLOBALPADROW; row++) {
+      access.nClusters[sector][row] = row < NClustersTPC ? 1 : 0;
+      if (row < NClustersTPC) {
+        auto& cl = inp.clustersTPC.emplace_back();
+        cl.setTimeFlags(100.f + row, 0);
+        cl.setPad(30.f);
+        cl.setSigmaTime(1.f);
+        cl.setSigmaPad(1.f);
+        cl.qMax = 50;
+        cl.qTot = 100;
+      }
+    }
+  }
+  access.clustersLinear = inp.clustersTPC.data();
+  access.clustersMCTruth = nullptr;
+  access.setOffsetPtrs();
+  inp.sharingMapTPC.resize(access.nClustersTotal, 0);
+}
+
+MatchingResult runMatching(int nThreads, const TPCITSInput& inp)
+{
+  o2::conf::ConfigurableParam::updateFromString("tpcitsMatch.nThreads=" + std::to_string(nThreads));
+  MatchTPCITS matching;
+  matching.setITSTriggered(false);
+  matching.setITSROFrameLengthInBC(NROFBC);
+  o2::BunchFilling bunchFilling;
+  bunchFilling.setDefault();
+  matching.setBunchFilling(bunchFilling);
+  matching.init();
+
+  matching.setITSTracksInp(inp.tracksITS);
+  matching.setITSTrackClusIdxInp(inp.trackClusIdxITS);
+  matching.setITSTrackROFRecInp(inp.trackROFsITS);
+  matching.setITSClustersInp(inp.clustersITS);
+  matching.setITSClusterROFRecInp(inp.clusterROFsITS);
+  matching.setTPCTracksInp(inp.tracksTPC);
+  matching.setTPCTrackClusIdxInp(inp.clusRefsTPC);
+  matching.setTPCClustersInp(&inp.clusterAccessTPC);
+  matching.setTPCClustersSharingMap(inp.sharingMapTPC);
+  matching.run();
+  return {matching.getMatchRecordsTPC(), matching.getMatchRecordsITS(), matching.getMatchedTracks()};
+}
+
+void checkSame(const std::vector<MatchRecord>& serial, const std::vector<MatchRecord>& parallel)
+{
+  BOOST_REQUIRE_EQUAL(serial.size(), parallel.size());
+  for (size_t ir = 0; ir < serial.size(); ir++) {
+    BOOST_CHECK_EQUAL(serial[ir].chi2, parallel[ir].chi2);
+    BOOST_CHECK_EQUAL(serial[ir].partnerID, parallel[ir].partnerID);
+    BOOST_CHECK_EQUAL(serial[ir].nextRecID, parallel[ir].nextRecID);
+    BOOST_CHECK_EQUAL(serial[ir].matchedIC, parallel[ir].matchedIC);
+  }
+}
+
+// the matching candidates and the matched tracks found with several threads must be identical to those found with one
+BOOST_AUTO_TEST_CASE(MatchTPCITS_Threads)
+{
+  setupPropagator();
+  TPCITSInput inp;
+  generateInput(inp);
+
+  auto serial = runMatching(1, inp);
+  BOOST_CHECK(serial.recordsTPC.size() > 0);
+  for (int nThreads : {2, 4}) {
+    auto parallel = runMatching(nThreads, inp);
+    checkSame(serial.recordsTPC, parallel.recordsTPC);
+    checkSame(serial.recordsITS, parallel.recordsITS);
+    BOOST_REQUIRE_EQUAL(serial.matches.size(), parallel.matches.size());
+    for (size_t im = 0; im < serial.matches.size(); im++) {
+      const auto &ms = serial.matches[im], &mp = parallel.matches[im];
+      BOOST_CHECK_EQUAL(ms.getRefTPC().getRaw(), mp.getRefTPC().getRaw());
+      BOOST_CHECK_EQUAL(ms.getRefITS().getRaw(), mp.getRefITS().getRaw());
+      BOOST_CHECK_EQUAL(ms.getChi2Match(), mp.getChi2Match());
+      BOOST_CHECK_EQUAL(ms.getChi2Refit(), mp.getChi2Refit());
+      for (int i = 0; i < 5; i++) {
+        BOOST_CHECK_EQUAL(ms.getParam(i), mp.getParam(i));
+      }
+    }
+  }
+  o2::conf::ConfigurableParam::updateFromString("tpcitsMatch.nThreads=1");
+}
+
+} // namespace globaltracking
+} // namespace o2
@@ -62,6 +62,7 @@ void PrimaryVertexingSpec::init(InitContext& ic)
   mTimer.Stop();
   mTimer.Reset();
   mVertexer.setValidateWithIR(mValidateWithIR);
+  mVertexer.setNThreads(ic.options().get<int>("threads"));
 
   // set bunch filling. Eventually, this should come from CCDB
   const auto* digctx = o2::steer::DigitizationContext::loadFromFile("collisioncontext.root");
@@ -167,7 +168,8 @@ DataProcessorSpec getPrimaryVertexingSpec(GTrackID::mask_t src, bool validateWit
     dataRequestPV.inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<PrimaryVertexingSpec>(validateWithFT0, useMC)},
-    Options{{"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+    Options{{"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+            {"threads", VariantType::Int, 1, {"Number of threads"}}}};
 }
 
 } // namespace vertexing
@@ -66,6 +66,7 @@ class TOFDPLRecoWorkflowTask
     } else {
       LOG(INFO) << "Material LUT " << matLUTFile << " file is absent, only TGeo can be used";
     }
+    mMatcher.setNThreads(ic.options().get<int>("threads"));
 
     mTimer.Stop();
     mTimer.Reset();
@@ -165,7 +166,8 @@ o2::framework::DataProcessorSpec getTOFRecoWorkflowSpec(bool useMC, bool useFIT)
     outputs,
     AlgorithmSpec{adaptFromTask<TOFDPLRecoWorkflowTask>(useMC, useFIT)},
     Options{
-      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+      {"threads", VariantType::Int, 1, {"Number of threads for the matching (needs the material LUT)"}}}};
 }
 
 } // end namespace tof
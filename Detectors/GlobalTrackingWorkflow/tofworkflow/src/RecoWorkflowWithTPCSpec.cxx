@@ -68,6 +68,7 @@ class TOFDPLRecoWorkflowWithTPCTask
     } else {
       LOG(INFO) << "Material LUT " << matLUTFile << " file is absent, only TGeo can be used";
     }
+    mMatcher.setNThreads(ic.options().get<int>("threads"));
 
     mTimer.Stop();
     mTimer.Reset();
@@ -182,7 +183,8 @@ o2::framework::DataProcessorSpec getTOFRecoWorkflowWithTPCSpec(bool useMC, bool
     outputs,
     AlgorithmSpec{adaptFromTask<TOFDPLRecoWorkflowWithTPCTask>(useMC, useFIT, doTPCRefit, iscosmics)},
     Options{
-      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+      {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+      {"threads", VariantType::Int, 1, {"Number of threads for the matching (needs the material LUT)"}}}};
 }
 
 } // end namespace tof
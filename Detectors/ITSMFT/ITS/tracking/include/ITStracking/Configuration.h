@@ -105,6 +105,7 @@ struct VertexingParameters {
   int clusterContributorsCut = 16;
   int phiSpan = -1;
   int zSpan = -1;
+  int nThreads = 1;
 };
 
 struct VertexerHistogramsConfiguration {
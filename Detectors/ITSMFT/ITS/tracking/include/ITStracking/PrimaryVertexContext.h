@@ -50,6 +50,11 @@ class PrimaryVertexContext
   auto& getCells() { return mCells; }
   auto& getCellsLookupTable() { return mCellsLookupTable; }
   auto& getCellsNeighbours() { return mCellsNeighbours; }
+  auto& getCellsNeighboursLUT() { return mCellsNeighboursLUT; }
+  auto& getCellsNeighboursCandidates() { return mCellsNeighboursCandidates; }
+  int getCellNeighboursNum(int layer, int cellId) const;
+  int getCellNeighbour(int layer, int cellId, int iNeighbour) const;
+  void buildCellsNeighbours(int layer, int cellsNum);
   auto& getRoads() { return mRoads; }
 
   float getMinR(int layer) { return mMinR[layer]; }
@@ -77,7 +82,11 @@ class PrimaryVertexContext
   std::vector<std::vector<bool>> mUsedClusters;
   std::vector<std::vector<Cell>> mCells;
   std::vector<std::vector<int>> mCellsLookupTable;
-  std::vector<std::vector<std::vector<int>>> mCellsNeighbours;
+  /// Cell neighbours are stored per layer in CSR layout: the neighbours of cell i of layer l+1 are
+  /// mCellsNeighbours[l][mCellsNeighboursLUT[l][i]] ... mCellsNeighbours[l][mCellsNeighboursLUT[l][i + 1] - 1]
+  std::vector<std::vector<int>> mCellsNeighbours;
+  std::vector<std::vector<int>> mCellsNeighboursLUT;
+  std::vector<std::pair<int, int>> mCellsNeighboursCandidates; // (next layer cell, cell) pairs, reused across layers and ROFs
   std::vector<Road> mRoads;
 
   // std::array<std::array<int, constants::index_table::ZBins * constants::index_table::PhiBins + 1>,
@@ -87,11 +96,33 @@ class PrimaryVertexContext
   std::vector<std::vector<int>> mTrackletsLookupTable;
 
   std::vector<std::pair<unsigned long long, bool>> mRoadLabels;
+
+ private:
+  struct ClusterHelper {
+    float phi;
+    float r;
+    int bin;
+    int ind;
+  };
+  /// scratch buffers of initialise(), kept to reuse their capacity across ROFs and vertices
+  std::vector<ClusterHelper> mClusterHelpers;
+  std::vector<int> mClustersPerBin;
+  std::vector<int> mLUTPerBin;
 };
 
 
 inline void PrimaryVertexContext::markUsedCluster(int layer, int clusterId) { mUsedClusters[layer][clusterId] = true; }
 
+inline int PrimaryVertexContext::getCellNeighboursNum(int layer, int cellId) const
+{
+  return mCellsNeighboursLUT[layer][cellId + 1] - mCellsNeighboursLUT[layer][cellId];
+}
+
+inline int PrimaryVertexContext::getCellNeighbour(int layer, int cellId, int iNeighbour) const
+{
+  return mCellsNeighbours[layer][mCellsNeighboursLUT[layer][cellId] + iNeighbour];
+}
+
 inline void PrimaryVertexContext::initialiseRoadLabels()
 {
   mRoadLabels.clear();
@@ -31,6 +31,7 @@ struct VertexerParamConfig : public o2::conf::ConfigurableParamHelper<VertexerPa
   int clusterContributorsCut = 16;
   int phiSpan = -1;
   int zSpan = -1;
+  int nThreads = 1; // threads used to combine the lines in the histogram vertexer
 
   O2ParamDef(VertexerParamConfig, "ITSVertexerParam");
 };
@@ -25,18 +25,11 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const Tr
                                       const std::vector<std::vector<Cluster>>& cl, const std::array<float, 3>& pVtx, const int iteration)
 {
 
-  struct ClusterHelper {
-    float phi;
-    float r;
-    int bin;
-    int ind;
-  };
-
   mPrimaryVertex = {pVtx[0], pVtx[1], pVtx[2]};
 
   if (iteration == 0) {
 
-    std::vector<ClusterHelper> cHelper;
+    auto& cHelper = mClusterHelpers;
 
     mMinR.resize(trkParam.NLayers, 10000.);
     mMaxR.resize(trkParam.NLayers, -1.);
@@ -45,12 +38,16 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const Tr
     mCells.resize(trkParam.CellsPerRoad());
     mCellsLookupTable.resize(trkParam.CellsPerRoad() - 1);
     mCellsNeighbours.resize(trkParam.CellsPerRoad() - 1);
+    mCellsNeighboursLUT.resize(trkParam.CellsPerRoad() - 1);
     mIndexTables.resize(trkParam.TrackletsPerRoad(), std::vector<int>(trkParam.ZBins * trkParam.PhiBins + 1, 0));
     mTracklets.resize(trkParam.TrackletsPerRoad());
     mTrackletsLookupTable.resize(trkParam.CellsPerRoad());
     mIndexTableUtils.setTrackingParameters(trkParam);
 
-    std::vector<int> clsPerBin(trkParam.PhiBins * trkParam.ZBins, 0);
+    auto& clsPerBin = mClustersPerBin;
+    auto& lutPerBin = mLUTPerBin;
+    clsPerBin.resize(trkParam.PhiBins * trkParam.ZBins);
+    lutPerBin.resize(clsPerBin.size());
     for (unsigned int iLayer{0}; iLayer < mClusters.size(); ++iLayer) {
 
       const auto& currentLayer{cl[iLayer]};
@@ -86,7 +83,6 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const Tr
         h.ind = clsPerBin[bin]++;
       }
 
-      std::vector<int> lutPerBin(clsPerBin.size());
       lutPerBin[0] = 0;
       for (unsigned int iB{1}; iB < lutPerBin.size(); ++iB) {
         lutPerBin[iB] = lutPerBin[iB - 1] + clsPerBin[iB - 1];
@@ -137,6 +133,7 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const Tr
                                                    cl[iLayer + 2].size()),
                                        constants::its::UnusedIndex);
       mCellsNeighbours[iLayer].clear();
+      mCellsNeighboursLUT[iLayer].clear();
     }
   }
 
@@ -160,5 +157,31 @@ void PrimaryVertexContext::initialise(const MemoryParameters& memParam, const Tr
   }
 }
 
+void PrimaryVertexContext::buildCellsNeighbours(int layer, int cellsNum)
+{
+  /// Counting sort of the (next layer cell, cell) candidates found for this layer into the CSR tables.
+  /// The sort is stable, so the neighbours of each cell keep the order in which they were found.
+  auto& lut = mCellsNeighboursLUT[layer];
+  auto& neighbours = mCellsNeighbours[layer];
+  lut.clear();
+  lut.resize(cellsNum + 1, 0);
+  for (const auto& candidate : mCellsNeighboursCandidates) {
+    ++lut[candidate.first + 1];
+  }
+  for (int iCell{0}; iCell < cellsNum; ++iCell) {
+    lut[iCell + 1] += lut[iCell];
+  }
+  neighbours.resize(mCellsNeighboursCandidates.size());
+  for (const auto& candidate : mCellsNeighboursCandidates) {
+    neighbours[lut[candidate.first]++] = candidate.second;
+  }
+  // the fill loop moved every offset to the end of its range, shift them back to the range starts
+  for (int iCell{cellsNum}; iCell > 0; --iCell) {
+    lut[iCell] = lut[iCell - 1];
+  }
+  lut[0] = 0;
+  mCellsNeighboursCandidates.clear();
+}
+
 } // namespace its
 } // namespace o2
@@ -119,7 +119,8 @@ void Tracker::findCellsNeighbours(int& iteration)
 
     int layerCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer].size())};
     const int nextLayerCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer + 1].size())};
-    mPrimaryVertexContext->getCellsNeighbours()[iLayer].resize(nextLayerCellsNum);
+    auto& neighboursCandidates = mPrimaryVertexContext->getCellsNeighboursCandidates();
+    neighboursCandidates.clear();
 
     for (int iCell{0}; iCell < layerCellsNum; ++iCell) {
 
@@ -151,7 +152,7 @@ void Tracker::findCellsNeighbours(int& iteration)
           if (deltaNormalVectorsModulus < mTrkParams[iteration].NeighbourMaxDeltaN[iLayer] &&
               deltaCurvature < mTrkParams[iteration].NeighbourMaxDeltaCurvature[iLayer]) {
 
-            mPrimaryVertexContext->getCellsNeighbours()[iLayer][iNextLayerCell].push_back(iCell);
+            neighboursCandidates.emplace_back(iNextLayerCell, iCell);
 
             const int currentCellLevel{currentCell.getLevel()};
 
@@ -163,6 +164,7 @@ void Tracker::findCellsNeighbours(int& iteration)
         }
       }
     }
+    mPrimaryVertexContext->buildCellsNeighbours(iLayer, nextLayerCellsNum);
   }
 }
 
@@ -192,13 +194,12 @@ void Tracker::findRoads(int& iteration)
           continue;
         }
 
-        const int cellNeighboursNum{static_cast<int>(
-          mPrimaryVertexContext->getCellsNeighbours()[iLayer - 1][iCell].size())};
+        const int cellNeighboursNum{mPrimaryVertexContext->getCellNeighboursNum(iLayer - 1, iCell)};
         bool isFirstValidNeighbour = true;
 
         for (int iNeighbourCell{0}; iNeighbourCell < cellNeighboursNum; ++iNeighbourCell) {
 
-          const int neighbourCellId = mPrimaryVertexContext->getCellsNeighbours()[iLayer - 1][iCell][iNeighbourCell];
+          const int neighbourCellId = mPrimaryVertexContext->getCellNeighbour(iLayer - 1, iCell, iNeighbourCell);
           const Cell& neighbourCell = mPrimaryVertexContext->getCells()[iLayer - 1][neighbourCellId];
 
           if (iLevel - 1 != neighbourCell.getLevel()) {
@@ -447,14 +448,12 @@ void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerI
   mPrimaryVertexContext->getRoads().back().addCell(currentLayerId, currentCellId);
 
   if (currentLayerId > 0 && currentCellLevel > 1) {
-    const int cellNeighboursNum{static_cast<int>(
-      mPrimaryVertexContext->getCellsNeighbours()[currentLayerId - 1][currentCellId].size())};
+    const int cellNeighboursNum{mPrimaryVertexContext->getCellNeighboursNum(currentLayerId - 1, currentCellId)};
     bool isFirstValidNeighbour = true;
 
     for (int iNeighbourCell{0}; iNeighbourCell < cellNeighboursNum; ++iNeighbourCell) {
 
-      const int neighbourCellId =
-        mPrimaryVertexContext->getCellsNeighbours()[currentLayerId - 1][currentCellId][iNeighbourCell];
+      const int neighbourCellId = mPrimaryVertexContext->getCellNeighbour(currentLayerId - 1, currentCellId, iNeighbourCell);
       const Cell& neighbourCell = mPrimaryVertexContext->getCells()[currentLayerId - 1][neighbourCellId];
 
       if (currentCellLevel - 1 != neighbourCell.getLevel()) {
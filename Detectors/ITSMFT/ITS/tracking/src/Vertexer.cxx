@@ -72,6 +72,7 @@ void Vertexer::getGlobalConfiguration()
   verPar.tanLambdaCut = vc.tanLambdaCut;
   verPar.clusterContributorsCut = vc.clusterContributorsCut;
   verPar.phiSpan = vc.phiSpan;
+  verPar.nThreads = vc.nThreads;
 
   mTraits->updateVertexingParameters(verPar);
 }
@@ -12,7 +12,9 @@
 /// \brief
 /// \author matteo.concas@cern.ch
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 #include <ostream>
 #include <boost/histogram.hpp>
 #include <boost/format.hpp>
@@ -21,6 +23,11 @@
 #include "ITStracking/ROframe.h"
 #include "ITStracking/ClusterLines.h"
 #include "ITStracking/Tracklet.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 #ifdef _ALLOW_DEBUG_TREES_ITS_
 #include "ITStracking/StandaloneDebugger.h"
@@ -106,15 +113,54 @@ void trackletSelectionKernelSerial(
   const float phiCut = 0.005f,
   const int maxTracklets = static_cast<int>(1e2))
 {
+  // The tracklets01 of each layer 1 cluster are sorted in phi and stored in SoA form, so that each tracklet12 only
+  // checks the tracklets01 in its phi window with a branchless, vectorisable loop. The accepted pairs are emitted
+  // in the order of the plain nested loop, which keeps the result independent of the search strategy.
+  std::vector<int> sortedTracklets01;
+  std::vector<float> sortedPhi01;
+  std::vector<float> sortedTanLambda01;
+  std::vector<unsigned char> accepted;
+  std::vector<int> selectedTracklets01;
+  const float phiWindow{phiCut * (1.f + 1.e-3f)}; // loose window, the exact cut is applied on its content
   int offset01{0};
   int offset12{0};
   for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < clustersCurrentLayer.size(); ++iCurrentLayerClusterIndex) {
-    int validTracklets{0};
-    for (int iTracklet12{offset12}; iTracklet12 < offset12 + foundTracklets12[iCurrentLayerClusterIndex]; ++iTracklet12) {
-      for (int iTracklet01{offset01}; iTracklet01 < offset01 + foundTracklets01[iCurrentLayerClusterIndex]; ++iTracklet01) {
-        const float deltaTanLambda{o2::gpu::GPUCommonMath::Abs(tracklets01[iTracklet01].tanLambda - tracklets12[iTracklet12].tanLambda)};
-        const float deltaPhi{o2::gpu::GPUCommonMath::Abs(tracklets01[iTracklet01].phiCoordinate - tracklets12[iTracklet12].phiCoordinate)};
-        if (deltaTanLambda < tanLambdaCut && deltaPhi < phiCut && validTracklets != maxTracklets) {
+    const int nTracklets01{foundTracklets01[iCurrentLayerClusterIndex]};
+    const int nTracklets12{foundTracklets12[iCurrentLayerClusterIndex]};
+    if (nTracklets01 && nTracklets12) {
+      sortedTracklets01.resize(nTracklets01);
+      std::iota(sortedTracklets01.begin(), sortedTracklets01.end(), offset01);
+      std::sort(sortedTracklets01.begin(), sortedTracklets01.end(), [&tracklets01](const int i, const int j) {
+        return tracklets01[i].phiCoordinate < tracklets01[j].phiCoordinate || (tracklets01[i].phiCoordinate == tracklets01[j].phiCoordinate && i < j);
+      });
+      sortedPhi01.resize(nTracklets01);
+      sortedTanLambda01.resize(nTracklets01);
+      accepted.resize(nTracklets01);
+      for (int iSorted{0}; iSorted < nTracklets01; ++iSorted) {
+        sortedPhi01[iSorted] = tracklets01[sortedTracklets01[iSorted]].phiCoordinate;
+        sortedTanLambda01[iSorted] = tracklets01[sortedTracklets01[iSorted]].tanLambda;
+      }
+      int validTracklets{0};
+      for (int iTracklet12{offset12}; iTracklet12 < offset12 + nTracklets12 && validTracklets != maxTracklets; ++iTracklet12) {
+        const float phi12{tracklets12[iTracklet12].phiCoordinate};
+        const float tanLambda12{tracklets12[iTracklet12].tanLambda};
+        const int first{static_cast<int>(std::lower_bound(sortedPhi01.begin(), sortedPhi01.end(), phi12 - phiWindow) - sortedPhi01.begin())};
+        const int last{static_cast<int>(std::upper_bound(sortedPhi01.begin() + first, sortedPhi01.end(), phi12 + phiWindow) - sortedPhi01.begin())};
+        for (int iSorted{first}; iSorted < last; ++iSorted) {
+          accepted[iSorted] = (o2::gpu::GPUCommonMath::Abs(sortedTanLambda01[iSorted] - tanLambda12) < tanLambdaCut) &
+                              (o2::gpu::GPUCommonMath::Abs(sortedPhi01[iSorted] - phi12) < phiCut);
+        }
+        selectedTracklets01.clear();
+        for (int iSorted{first}; iSorted < last; ++iSorted) {
+          if (accepted[iSorted]) {
+            selectedTracklets01.push_back(sortedTracklets01[iSorted]);
+          }
+        }
+        std::sort(selectedTracklets01.begin(), selectedTracklets01.end());
+        for (const int iTracklet01 : selectedTracklets01) {
+          if (validTracklets == maxTracklets) {
+            break;
+          }
           assert(tracklets01[iTracklet01].secondClusterIndex == tracklets12[iTracklet12].firstClusterIndex);
 #ifdef _ALLOW_DEBUG_TREES_ITS_
           allowedTrackletPairs.push_back(std::array<int, 2>{iTracklet01, iTracklet12});
@@ -126,8 +172,8 @@ void trackletSelectionKernelSerial(
         }
       }
     }
-    offset01 += foundTracklets01[iCurrentLayerClusterIndex];
-    offset12 += foundTracklets12[iCurrentLayerClusterIndex];
+    offset01 += nTracklets01;
+    offset12 += nTracklets12;
   }
 }
 
@@ -251,46 +297,55 @@ void VertexerTraits::computeTrackletsPureMontecarlo()
 {
   assert(mEvent != nullptr);
 
-  std::vector<int> foundTracklets01;
-  std::vector<int> foundTracklets12;
-
-  for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < mClusters[0].size(); ++iCurrentLayerClusterIndex) {
-    auto& currentCluster{mClusters[0][iCurrentLayerClusterIndex]};
-    for (unsigned int iNextLayerClusterIndex = 0; iNextLayerClusterIndex < mClusters[1].size(); iNextLayerClusterIndex++) {
-      const Cluster& nextCluster{mClusters[1][iNextLayerClusterIndex]};
-      const auto& lblNext = mEvent->getClusterLabels(1, nextCluster.clusterId);
-      const auto& lblCurr = mEvent->getClusterLabels(0, currentCluster.clusterId);
-      if (lblNext.compare(lblCurr) == 1 && lblCurr.getSourceID() == 0) {
-        mComb01.emplace_back(iCurrentLayerClusterIndex, iNextLayerClusterIndex, currentCluster, nextCluster);
+  // Index the layer 1 clusters by MC label, so that the clusters of layers 0 and 2 are paired with a binary search
+  // instead of a loop over all the layer 1 clusters. Pairs are produced in the same order as with the full loop.
+  std::vector<std::pair<ULong64_t, int>> labelsLayer1;
+  labelsLayer1.reserve(mClusters[1].size());
+  for (unsigned int iClusterIndex{0}; iClusterIndex < mClusters[1].size(); ++iClusterIndex) {
+    const auto& lbl = mEvent->getClusterLabels(1, mClusters[1][iClusterIndex].clusterId);
+    labelsLayer1.emplace_back(lbl.getRawValue() & MCCompLabel::maskFull, iClusterIndex);
+  }
+  std::sort(labelsLayer1.begin(), labelsLayer1.end());
+
+  auto matchLayer = [&](const int layer, std::vector<Tracklet>& combinations) {
+    for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < mClusters[layer].size(); ++iCurrentLayerClusterIndex) {
+      auto& currentCluster{mClusters[layer][iCurrentLayerClusterIndex]};
+      const auto& lblCurr = mEvent->getClusterLabels(layer, currentCluster.clusterId);
+      if (lblCurr.getSourceID() != 0) {
+        continue;
       }
-    }
-  }
-
-  for (unsigned int iCurrentLayerClusterIndex{0}; iCurrentLayerClusterIndex < mClusters[2].size(); ++iCurrentLayerClusterIndex) {
-    auto& currentCluster{mClusters[2][iCurrentLayerClusterIndex]};
-    for (unsigned int iNextLayerClusterIndex = 0; iNextLayerClusterIndex < mClusters[1].size(); iNextLayerClusterIndex++) {
-      const Cluster& nextCluster{mClusters[1][iNextLayerClusterIndex]};
-      const auto& lblNext = mEvent->getClusterLabels(1, nextCluster.clusterId);
-      const auto& lblCurr = mEvent->getClusterLabels(2, currentCluster.clusterId);
-      if (lblNext.compare(lblCurr) == 1 && lblCurr.getSourceID() == 0) {
-        mComb12.emplace_back(iNextLayerClusterIndex, iCurrentLayerClusterIndex, nextCluster, currentCluster);
+      const ULong64_t key{lblCurr.getRawValue() & MCCompLabel::maskFull};
+      for (auto it = std::lower_bound(labelsLayer1.begin(), labelsLayer1.end(), std::make_pair(key, 0)); it != labelsLayer1.end() && it->first == key; ++it) {
+        const int iNextLayerClusterIndex{it->second};
+        const Cluster& nextCluster{mClusters[1][iNextLayerClusterIndex]};
+        const auto& lblNext = mEvent->getClusterLabels(1, nextCluster.clusterId);
+        if (lblNext.compare(lblCurr) == 1) {
+          if (layer == 0) {
+            combinations.emplace_back(iCurrentLayerClusterIndex, iNextLayerClusterIndex, currentCluster, nextCluster);
+          } else {
+            combinations.emplace_back(iNextLayerClusterIndex, iCurrentLayerClusterIndex, nextCluster, currentCluster);
+          }
+        }
       }
     }
-  }
+  };
+  matchLayer(0, mComb01);
+  matchLayer(2, mComb12);
 
   for (auto& trk : mComb01) {
     mTracklets.emplace_back(trk, mClusters[0].data(), mClusters[1].data()); // any check on the propagation to the third layer?
   }
 
 #ifdef _ALLOW_DEBUG_TREES_ITS_
+  // first tracklet12 attached to each layer 1 cluster
+  std::vector<int> firstTracklet12(mClusters[1].size(), -1);
+  for (int iTracklet12{static_cast<int>(mComb12.size()) - 1}; iTracklet12 >= 0; --iTracklet12) {
+    firstTracklet12[mComb12[iTracklet12].firstClusterIndex] = iTracklet12;
+  }
   for (int iTracklet01{0}; iTracklet01 < static_cast<int>(mComb01.size()); ++iTracklet01) {
-    auto& trklet01 = mComb01[iTracklet01];
-    for (int iTracklet12{0}; iTracklet12 < static_cast<int>(mComb12.size()); ++iTracklet12) {
-      auto& trklet12 = mComb12[iTracklet12];
-      if (trklet01.secondClusterIndex == trklet12.firstClusterIndex) {
-        mAllowedTrackletPairs.push_back(std::array<int, 2>{iTracklet01, iTracklet12});
-        break;
-      }
+    const int iTracklet12{firstTracklet12[mComb01[iTracklet01].secondClusterIndex]};
+    if (iTracklet12 >= 0) {
+      mAllowedTrackletPairs.push_back(std::array<int, 2>{iTracklet01, iTracklet12});
     }
   }
   if (isDebugFlag(VertexerDebug::CombinatoricsTreeAll)) {
@@ -506,18 +561,35 @@ void VertexerTraits::computeHistVertices()
   auto histY = boost::histogram::make_histogram(axes[1]);
   auto histZ = boost::histogram::make_histogram(axes[2]);
 
-  // Loop over lines, calculate transverse vertices within beampipe and fill XY histogram to find pseudobeam projection
-  for (size_t iTracklet1{0}; iTracklet1 < mTracklets.size(); ++iTracklet1) {
-    for (size_t iTracklet2{iTracklet1 + 1}; iTracklet2 < mTracklets.size(); ++iTracklet2) {
+  // Loop over lines, calculate transverse vertices within beampipe and fill XY histogram to find pseudobeam projection.
+  // The pairs are shared among threads, each one filling its own histograms which are summed afterwards.
+  const int nThreads{std::max(1, mVrtParams.nThreads)};
+  std::vector<decltype(histX)> threadHistX(nThreads, histX);
+  std::vector<decltype(histY)> threadHistY(nThreads, histY);
+  const int nTracklets{static_cast<int>(mTracklets.size())};
+#ifdef WITH_OPENMP
+  omp_set_num_threads(nThreads);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (int iTracklet1 = 0; iTracklet1 < nTracklets; ++iTracklet1) {
+    int iThread{0};
+#ifdef WITH_OPENMP
+    iThread = omp_get_thread_num();
+#endif
+    for (int iTracklet2{iTracklet1 + 1}; iTracklet2 < nTracklets; ++iTracklet2) {
       if (Line::getDCA(mTracklets[iTracklet1], mTracklets[iTracklet2]) < mVrtParams.histPairCut) {
         ClusterLines cluster{mTracklets[iTracklet1], mTracklets[iTracklet2]};
         if (cluster.getVertex()[0] * cluster.getVertex()[0] + cluster.getVertex()[1] * cluster.getVertex()[1] < 1.98f * 1.98f) {
-          histX(cluster.getVertex()[0]);
-          histY(cluster.getVertex()[1]);
+          threadHistX[iThread](cluster.getVertex()[0]);
+          threadHistY[iThread](cluster.getVertex()[1]);
         }
       }
     }
   }
+  for (int iThread{0}; iThread < nThreads; ++iThread) {
+    histX += threadHistX[iThread];
+    histY += threadHistY[iThread];
+  }
 
   // Try again to use std::max_element as soon as boost is upgraded to 1.71...
   // atm you can iterate over histograms, not really possible to get bin index. Need to use iterate(histogram)
@@ -0,0 +1,54 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS CellsNeighbours
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITStracking/PrimaryVertexContext.h"
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace o2::its;
+
+// the CSR tables must give the same neighbours, in the same order, as one vector per cell filled with push_back
+BOOST_AUTO_TEST_CASE(CellsNeighbours_CSR)
+{
+  std::mt19937 gen(1234);
+  PrimaryVertexContext context;
+  context.getCellsNeighbours().resize(1);
+  context.getCellsNeighboursLUT().resize(1);
+
+  for (const int cellsNum : {0, 1, 7, 1000}) {
+    std::uniform_int_distribution<int> cellDist(0, std::max(cellsNum - 1, 0));
+    const int candidatesNum{cellsNum ? 4 * cellsNum : 0};
+    std::vector<std::vector<int>> expected(cellsNum);
+    auto& candidates = context.getCellsNeighboursCandidates();
+    candidates.clear();
+    for (int iCandidate{0}; iCandidate < candidatesNum; ++iCandidate) {
+      const int nextLayerCell{cellDist(gen)};
+      const int cell{cellDist(gen)};
+      candidates.emplace_back(nextLayerCell, cell);
+      expected[nextLayerCell].push_back(cell);
+    }
+    context.buildCellsNeighbours(0, cellsNum);
+
+    BOOST_CHECK(context.getCellsNeighboursCandidates().empty());
+    BOOST_CHECK_EQUAL(context.getCellsNeighboursLUT()[0].size(), cellsNum + 1);
+    BOOST_CHECK_EQUAL(context.getCellsNeighbours()[0].size(), candidatesNum);
+    for (int iCell{0}; iCell < cellsNum; ++iCell) {
+      BOOST_REQUIRE_EQUAL(context.getCellNeighboursNum(0, iCell), expected[iCell].size());
+      for (int iNeighbour{0}; iNeighbour < context.getCellNeighboursNum(0, iCell); ++iNeighbour) {
+        BOOST_CHECK_EQUAL(context.getCellNeighbour(0, iCell, iNeighbour), expected[iCell][iNeighbour]);
+      }
+    }
+  }
+}
@@ -0,0 +1,142 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS VertexerTraits
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITStracking/ROframe.h"
+#include "ITStracking/VertexerTraits.h"
+#include "GPUCommonMath.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace o2::its;
+
+namespace
+{
+/// gives access to the intermediate products of the vertexer
+class TestVertexerTraits : public VertexerTraits
+{
+ public:
+  const std::vector<Line>& getLines() const { return mTracklets; }
+  const std::vector<Tracklet>& getComb01() const { return mComb01; }
+  const std::vector<Tracklet>& getComb12() const { return mComb12; }
+  const std::vector<int>& getFoundTracklets01() const { return mFoundTracklets01; }
+  const std::vector<int>& getFoundTracklets12() const { return mFoundTracklets12; }
+  const std::vector<Cluster>& getLayerClusters(int layer) const { return mClusters[layer]; }
+};
+
+/// tracks from a few primary vertices plus uniformly distributed noise on the three innermost layers
+void fillEvent(ROframe& event)
+{
+  std::mt19937 gen(4321);
+  std::uniform_real_distribution<float> phiDist(0.f, 2.f * M_PI);
+  std::uniform_real_distribution<float> tanLambdaDist(-1.f, 1.f);
+  std::uniform_real_distribution<float> zDist(-15.f, 15.f);
+  const VertexingParameters verPar;
+  for (const float vertexZ : {-5.f, 0.5f, 4.f}) {
+    for (int iTrack{0}; iTrack < 40; ++iTrack) {
+      const float phi{phiDist(gen)};
+      const float tanLambda{tanLambdaDist(gen)};
+      for (int iLayer{0}; iLayer < 3; ++iLayer) {
+        const float r{verPar.LayerRadii[iLayer]};
+        event.addClusterToLayer(iLayer, r * std::cos(phi), r * std::sin(phi), vertexZ + r * tanLambda,
+                                event.getClustersOnLayer(iLayer).size());
+      }
+    }
+  }
+  for (int iLayer{0}; iLayer < 3; ++iLayer) {
+    const float r{verPar.LayerRadii[iLayer]};
+    for (int iNoise{0}; iNoise < 300; ++iNoise) {
+      const float phi{phiDist(gen)};
+      event.addClusterToLayer(iLayer, r * std::cos(phi), r * std::sin(phi), zDist(gen),
+                              event.getClustersOnLayer(iLayer).size());
+    }
+  }
+}
+
+void runVertexer(TestVertexerTraits& traits, ROframe& event, const int nThreads)
+{
+  VertexingParameters verPar;
+  verPar.nThreads = nThreads;
+  traits.updateVertexingParameters(verPar);
+  traits.initialise(&event);
+  traits.computeTracklets();
+  traits.computeTrackletMatching();
+  traits.computeHistVertices();
+}
+} // namespace
+
+// the phi-sorted tracklet matching must select the same pairs, in the same order, as the plain nested loop
+BOOST_AUTO_TEST_CASE(VertexerTraits_TrackletMatching)
+{
+  ROframe event(0, 7);
+  fillEvent(event);
+  TestVertexerTraits traits;
+  runVertexer(traits, event, 1);
+
+  const auto& tracklets01 = traits.getComb01();
+  const auto& tracklets12 = traits.getComb12();
+  const auto& clusters0 = traits.getLayerClusters(0);
+  const auto& clusters1 = traits.getLayerClusters(1);
+  const VertexingParameters verPar{traits.getVertexingParameters()};
+  const int maxTracklets{static_cast<int>(1e2)};
+  std::vector<Line> expected;
+  int offset01{0};
+  int offset12{0};
+  for (unsigned int iCluster{0}; iCluster < clusters1.size(); ++iCluster) {
+    int validTracklets{0};
+    for (int iTracklet12{offset12}; iTracklet12 < offset12 + traits.getFoundTracklets12()[iCluster]; ++iTracklet12) {
+      for (int iTracklet01{offset01}; iTracklet01 < offset01 + traits.getFoundTracklets01()[iCluster]; ++iTracklet01) {
+        const float deltaTanLambda{o2::gpu::GPUCommonMath::Abs(tracklets01[iTracklet01].tanLambda - tracklets12[iTracklet12].tanLambda)};
+        const float deltaPhi{o2::gpu::GPUCommonMath::Abs(tracklets01[iTracklet01].phiCoordinate - tracklets12[iTracklet12].phiCoordinate)};
+        if (deltaTanLambda < verPar.tanLambdaCut && deltaPhi < verPar.phiCut && validTracklets != maxTracklets) {
+          expected.emplace_back(tracklets01[iTracklet01], clusters0.data(), clusters1.data());
+          ++validTracklets;
+        }
+      }
+    }
+    offset01 += traits.getFoundTracklets01()[iCluster];
+    offset12 += traits.getFoundTracklets12()[iCluster];
+  }
+
+  const auto& lines = traits.getLines();
+  BOOST_CHECK(!expected.empty());
+  BOOST_REQUIRE_EQUAL(lines.size(), expected.size());
+  for (size_t iLine{0}; iLine < lines.size(); ++iLine) {
+    for (int i{0}; i < 3; ++i) {
+      BOOST_CHECK_EQUAL(lines[iLine].originPoint[i], expected[iLine].originPoint[i]);
+      BOOST_CHECK_EQUAL(lines[iLine].cosinesDirector[i], expected[iLine].cosinesDirector[i]);
+    }
+  }
+}
+
+// the histogram vertexer must find the same vertices with one and several threads
+BOOST_AUTO_TEST_CASE(VertexerTraits_HistVerticesThreads)
+{
+  ROframe event(0, 7);
+  fillEvent(event);
+  TestVertexerTraits serial, parallel;
+  runVertexer(serial, event, 1);
+  runVertexer(parallel, event, 4);
+
+  const auto serialVertices = serial.getVertices();
+  const auto parallelVertices = parallel.getVertices();
+  BOOST_CHECK(!serialVertices.empty());
+  BOOST_REQUIRE_EQUAL(serialVertices.size(), parallelVertices.size());
+  for (size_t iVertex{0}; iVertex < serialVertices.size(); ++iVertex) {
+    BOOST_CHECK_EQUAL(serialVertices[iVertex].mX, parallelVertices[iVertex].mX);
+    BOOST_CHECK_EQUAL(serialVertices[iVertex].mY, parallelVertices[iVertex].mY);
+    BOOST_CHECK_EQUAL(serialVertices[iVertex].mZ, parallelVertices[iVertex].mZ);
+    BOOST_CHECK_EQUAL(serialVertices[iVertex].mContributors, parallelVertices[iVertex].mContributors);
+  }
+}
@@ -117,14 +117,15 @@ class AlpideCoder
   static void setNoisyPixels(const NoiseMap* noise) { mNoisyPixels = noise; }
 
   /// decode alpide data for the next non-empty chip from the buffer
-  template <class T, typename CG>
+  /// With ByteWise set, the data words are fetched byte by byte through the buffer (reference implementation)
+  template <bool ByteWise = false, class T, typename CG>
   static int decodeChip(ChipPixelData& chipData, T& buffer, CG cidGetter)
   {
     // read record for single non-empty chip, updating on change module and cycle.
     // return number of records filled (>0), EOFFlag or Error
     //
     uint8_t dataC = 0, timestamp = 0;
-    uint16_t dataS = 0, region = 0;
+    uint16_t region = 0;
     //
     int nRightCHits = 0;               // counter for the hits in the right column of the current double column
     std::uint16_t rightColHits[NRows]; // buffer for the accumulation of hits in the right column
@@ -204,76 +205,23 @@ class AlpideCoder
       // hit info ?
       if ((expectInp & ExpectData)) {
         if (isData(dataC)) { // region header was seen, expect data
-                             // note that here we are checking on the byte rather than the short, need complete to ushort
-          dataS = dataC << 8;
-          if (!buffer.next(dataC)) {
-#ifdef ALPIDE_DECODING_STAT
-            chipData.setError(ChipStat::TruncatedRegion);
-#endif
-            return unexpectedEOF("CHIPDATA");
-          }
-          dataS |= dataC;
-          // we are decoding the pixel addres, if this is a DATALONG, we will fetch the mask later
-          uint16_t dColID = (dataS & MaskEncoder) >> 10;
-          uint16_t pixID = dataS & MaskPixID;
-
-          // convert data to usual row/pixel format
-          uint16_t row = pixID >> 1;
-          // abs id of left column in double column
-          uint16_t colD = (region * NDColInReg + dColID) << 1; // TODO consider <<4 instead of *NDColInReg?
-
-          // if we start new double column, transfer the hits accumulated in the right column buffer of prev. double column
-          if (colD != colDPrev) {
-            colDPrev++;
-            for (int ihr = 0; ihr < nRightCHits; ihr++) {
-              addHit(chipData, rightColHits[ihr], colDPrev);
-            }
-            colDPrev = colD;
-            nRightCHits = 0; // reset the buffer
-          }
-
-          bool rightC = (row & 0x1) ? !(pixID & 0x1) : (pixID & 0x1); // true for right column / lalse for left
-
-          // we want to have hits sorted in column/row, so the hits in right column of given double column
-          // are first collected in the temporary buffer
-          // real columnt id is col = colD + 1;
-          if (rightC) {
-            rightColHits[nRightCHits++] = row; // col = colD+1
+          int res = 0;
+          if constexpr (ByteWise) {
+            res = decodeDataWordByteWise(chipData, buffer, dataC, region, colDPrev, rightColHits, nRightCHits);
           } else {
-            addHit(chipData, row, colD); // col = colD, left column hits are added directly to the container
+            // consume this and all following DATASHORT/DATALONG words directly from the buffer memory
+            const uint8_t* ptr = buffer.getPtr() - 1; // data word starts with the byte already fetched
+            res = decodeDataWords(chipData, ptr, buffer.getEnd(), region, colDPrev, rightColHits, nRightCHits);
+            buffer.setPtr(const_cast<uint8_t*>(ptr));
           }
-
-          if ((dataS & (~MaskDColID)) == DATALONG) { // multiple hits ?
-            uint8_t hitsPattern = 0;
-            if (!buffer.next(hitsPattern)) {
-#ifdef ALPIDE_DECODING_STAT
-              chipData.setError(ChipStat::TruncatedLondData);
-#endif
-              return unexpectedEOF("CHIP_DATA_LONG:Pattern");
-            }
-#ifdef ALPIDE_DECODING_STAT
-            if (hitsPattern & (~MaskHitMap)) {
-              chipData.setError(ChipStat::WrongDataLongPattern);
-            }
-#endif
-            for (int ip = 0; ip < HitMapSize; ip++) {
-              if (hitsPattern & (0x1 << ip)) {
-                uint16_t addr = pixID + ip + 1, rowE = addr >> 1;
-                rightC = ((rowE & 0x1) ? !(addr & 0x1) : (addr & 0x1)); // true for right column / lalse for left
-                // the real columnt is int colE = colD + rightC;
-                if (rightC) { // same as above
-                  rightColHits[nRightCHits++] = rowE;
-                } else {
-                  addHit(chipData, rowE, colD + rightC); // left column hits are added directly to the container
-                }
-              }
-            }
+          if (res != 0) {
+            return res;
           }
         } else {
 #ifdef ALPIDE_DECODING_STAT
           chipData.setError(ChipStat::NoDataFound);
 #endif
-          LOG(ERROR) << "Expected DataShort or DataLong mask, got : " << dataS;
+          LOG(ERROR) << "Expected DataShort or DataLong mask, got : " << int(dataC);
           return Error;
         }
         expectInp = ExpectChipTrailer | ExpectData | ExpectRegion;
@@ -330,6 +278,146 @@ class AlpideCoder
   void reset();
 
  private:
+  /// decode the sequence of DATASHORT/DATALONG words starting at ptr, stopping at the first non-data byte.
+  /// Hits of the left column go directly to the chip data, those of the right column are buffered until the
+  /// double column changes, so that the output stays sorted in column/row. Returns 0 or the decoding error.
+  static int decodeDataWords(ChipPixelData& chipData, const uint8_t*& ptr, const uint8_t* end, uint16_t region,
+                             uint16_t& colDPrev, uint16_t* rightColHits, int& nRightCHits)
+  {
+    while (ptr < end && isData(*ptr)) {
+      if (ptr + 1 == end) {
+        ptr = end;
+#ifdef ALPIDE_DECODING_STAT
+        chipData.setError(ChipStat::TruncatedRegion);
+#endif
+        return unexpectedEOF("CHIPDATA");
+      }
+      uint16_t dataS = (uint16_t(ptr[0]) << 8) | ptr[1];
+      ptr += 2;
+      // we are decoding the pixel addres, if this is a DATALONG, we will fetch the mask later
+      uint16_t dColID = (dataS & MaskEncoder) >> 10;
+      uint16_t pixID = dataS & MaskPixID;
+      uint16_t row = pixID >> 1;
+      // abs id of left column in double column
+      uint16_t colD = (region * NDColInReg + dColID) << 1;
+
+      // if we start new double column, transfer the hits accumulated in the right column buffer of prev. double column
+      if (colD != colDPrev) {
+        colDPrev++;
+        for (int ihr = 0; ihr < nRightCHits; ihr++) {
+          addHit(chipData, rightColHits[ihr], colDPrev);
+        }
+        colDPrev = colD;
+        nRightCHits = 0; // reset the buffer
+      }
+
+      // pixels are read in snake order: the column is the right one when the parities of row and address differ
+      if ((row ^ pixID) & 0x1) {
+        rightColHits[nRightCHits++] = row; // col = colD+1
+      } else {
+        addHit(chipData, row, colD); // col = colD, left column hits are added directly to the container
+      }
+
+      if ((dataS & (~MaskDColID)) == DATALONG) { // multiple hits ?
+        if (ptr == end) {
+#ifdef ALPIDE_DECODING_STAT
+          chipData.setError(ChipStat::TruncatedLondData);
+#endif
+          return unexpectedEOF("CHIP_DATA_LONG:Pattern");
+        }
+        uint8_t hitsPattern = *ptr++;
+#ifdef ALPIDE_DECODING_STAT
+        if (hitsPattern & (~MaskHitMap)) {
+          chipData.setError(ChipStat::WrongDataLongPattern);
+        }
+#endif
+        for (uint32_t bits = hitsPattern & MaskHitMap; bits; bits &= bits - 1) { // loop over set bits only
+          uint16_t addr = pixID + __builtin_ctz(bits) + 1, rowE = addr >> 1;
+          if ((rowE ^ addr) & 0x1) {
+            rightColHits[nRightCHits++] = rowE;
+          } else {
+            addHit(chipData, rowE, colD); // left column hits are added directly to the container
+          }
+        }
+      }
+    }
+    return 0;
+  }
+
+  /// decode a single DATASHORT/DATALONG word whose 1st byte dataC was already fetched, reading the rest byte by byte.
+  /// Slower than decodeDataWords, kept as the reference to validate it. Returns 0 or the decoding error.
+  template <class T>
+  static int decodeDataWordByteWise(ChipPixelData& chipData, T& buffer, uint8_t dataC, uint16_t region,
+                                    uint16_t& colDPrev, uint16_t* rightColHits, int& nRightCHits)
+  {
+    // note that here we are checking on the byte rather than the short, need complete to ushort
+    uint16_t dataS = dataC << 8;
+    if (!buffer.next(dataC)) {
+#ifdef ALPIDE_DECODING_STAT
+      chipData.setError(ChipStat::TruncatedRegion);
+#endif
+      return unexpectedEOF("CHIPDATA");
+    }
+    dataS |= dataC;
+    // we are decoding the pixel addres, if this is a DATALONG, we will fetch the mask later
+    uint16_t dColID = (dataS & MaskEncoder) >> 10;
+    uint16_t pixID = dataS & MaskPixID;
+
+    // convert data to usual row/pixel format
+    uint16_t row = pixID >> 1;
+    // abs id of left column in double column
+    uint16_t colD = (region * NDColInReg + dColID) << 1;
+
+    // if we start new double column, transfer the hits accumulated in the right column buffer of prev. double column
+    if (colD != colDPrev) {
+      colDPrev++;
+      for (int ihr = 0; ihr < nRightCHits; ihr++) {
+        addHit(chipData, rightColHits[ihr], colDPrev);
+      }
+      colDPrev = colD;
+      nRightCHits = 0; // reset the buffer
+    }
+
+    bool rightC = (row & 0x1) ? !(pixID & 0x1) : (pixID & 0x1); // true for right column / lalse for left
+
+    // we want to have hits sorted in column/row, so the hits in right column of given double column
+    // are first collected in the temporary buffer
+    // real columnt id is col = colD + 1;
+    if (rightC) {
+      rightColHits[nRightCHits++] = row; // col = colD+1
+    } else {
+      addHit(chipData, row, colD); // col = colD, left column hits are added directly to the container
+    }
+
+    if ((dataS & (~MaskDColID)) == DATALONG) { // multiple hits ?
+      uint8_t hitsPattern = 0;
+      if (!buffer.next(hitsPattern)) {
+#ifdef ALPIDE_DECODING_STAT
+        chipData.setError(ChipStat::TruncatedLondData);
+#endif
+        return unexpectedEOF("CHIP_DATA_LONG:Pattern");
+      }
+#ifdef ALPIDE_DECODING_STAT
+      if (hitsPattern & (~MaskHitMap)) {
+        chipData.setError(ChipStat::WrongDataLongPattern);
+      }
+#endif
+      for (int ip = 0; ip < HitMapSize; ip++) {
+        if (hitsPattern & (0x1 << ip)) {
+          uint16_t addr = pixID + ip + 1, rowE = addr >> 1;
+          rightC = ((rowE & 0x1) ? !(addr & 0x1) : (addr & 0x1)); // true for right column / lalse for left
+          // the real columnt is int colE = colD + rightC;
+          if (rightC) { // same as above
+            rightColHits[nRightCHits++] = rowE;
+          } else {
+            addHit(chipData, rowE, colD + rightC); // left column hits are added directly to the container
+          }
+        }
+      }
+    }
+    return 0;
+  }
+
   /// Output a non-noisy fired pixel
   static void addHit(ChipPixelData& chipData, short row, short col)
   {
@@ -0,0 +1,69 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file   bench_AlpideCoder.cxx
+/// \brief  Throughput of the ALPIDE decoder, byte-wise reference vs decoding of the data words from the buffer memory
+
+#include "benchmark/benchmark.h"
+#include "ITSMFTReconstruction/AlpideCoder.h"
+#include "ITSMFTReconstruction/PayLoadCont.h"
+#include "ITSMFTReconstruction/PixelData.h"
+#include <random>
+#include <set>
+
+using namespace o2::itsmft;
+
+// cable data of 9 chips with given number of fired pixels each, half of them in clusters (DATALONG words)
+PayLoadCont generateCableData(int nHits)
+{
+  std::mt19937 gen(nHits);
+  std::uniform_int_distribution<int> row(0, AlpideCoder::NRows - 2), col(0, AlpideCoder::NCols - 2);
+  AlpideCoder coder;
+  PayLoadCont buffer;
+  for (int ic = 0; ic < 9; ic++) {
+    std::set<std::pair<int, int>> pixels;
+    while (int(pixels.size()) < nHits) {
+      int r = row(gen), c = col(gen);
+      pixels.emplace(r, c);
+      if (pixels.size() & 0x1) {
+        pixels.emplace(r, c + 1);
+        pixels.emplace(r + 1, c);
+      }
+    }
+    ChipPixelData chipData;
+    for (const auto& pix : pixels) {
+      chipData.getData().emplace_back(pix.first, pix.second);
+    }
+    buffer.ensureFreeCapacity(40 * (2 + pixels.size()));
+    coder.encodeChip(buffer, chipData, ic, 0);
+  }
+  return buffer;
+}
+
+template <bool ByteWise>
+static void BM_DecodeChips(benchmark::State& state)
+{
+  auto data = generateCableData(state.range(0));
+  ChipPixelData chipData;
+  size_t nPixels = 0;
+  for (auto _ : state) {
+    data.rewind();
+    while (AlpideCoder::decodeChip<ByteWise>(chipData, data, [](uint16_t id) { return id; }) || chipData.isErrorSet()) {
+      nPixels += chipData.getData().size();
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * data.getSize());
+  state.counters["pixels"] = benchmark::Counter(nPixels, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK_TEMPLATE(BM_DecodeChips, true)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK_TEMPLATE(BM_DecodeChips, false)->RangeMultiplier(10)->Range(10, 10000);
+
+BENCHMARK_MAIN();
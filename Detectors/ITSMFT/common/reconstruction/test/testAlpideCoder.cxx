@@ -0,0 +1,190 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test AlpideCoder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ITSMFTReconstruction/AlpideCoder.h"
+#include "ITSMFTReconstruction/PayLoadCont.h"
+#include "ITSMFTReconstruction/PixelData.h"
+#include <algorithm>
+#include <random>
+#include <set>
+
+using namespace o2::itsmft;
+
+namespace
+{
+struct DecodedChip {
+  int result = 0;
+  uint16_t chipID = 0;
+  uint8_t roFlags = 0;
+  uint32_t errors = 0;
+  size_t offset = 0; // position in the buffer after decoding
+  std::vector<std::pair<uint16_t, uint16_t>> pixels;
+
+  bool operator==(const DecodedChip& other) const
+  {
+    return result == other.result && chipID == other.chipID && roFlags == other.roFlags && errors == other.errors &&
+           offset == other.offset && pixels == other.pixels;
+  }
+};
+
+// decode all chips of the cable data as RUDecodeData does
+template <bool ByteWise>
+std::vector<DecodedChip> decodeCable(const std::vector<uint8_t>& data)
+{
+  PayLoadCont buffer;
+  buffer.add(data.data(), data.size());
+  std::vector<DecodedChip> chips;
+  ChipPixelData chipData;
+  int res = 0;
+  while (((res = AlpideCoder::decodeChip<ByteWise>(chipData, buffer, [](uint16_t id) { return id; })) || chipData.isErrorSet()) &&
+         chips.size() <= data.size()) {
+    auto& chip = chips.emplace_back();
+    chip.result = res;
+    chip.chipID = chipData.getChipID();
+    chip.roFlags = chipData.getROFlags();
+    chip.errors = chipData.getErrorFlags();
+    chip.offset = buffer.getOffset();
+    for (const auto& pix : chipData.getData()) {
+      chip.pixels.emplace_back(pix.getRow(), pix.getCol());
+    }
+  }
+  return chips;
+}
+
+// encode the chips given as pixel sets in the cable data, the chips without pixels are encoded as empty
+std::vector<uint8_t> encodeCable(const std::vector<std::set<std::pair<uint16_t, uint16_t>>>& chips)
+{
+  AlpideCoder coder;
+  PayLoadCont buffer;
+  for (size_t ic = 0; ic < chips.size(); ic++) {
+    ChipPixelData chipData;
+    for (const auto& pix : chips[ic]) { // the encoder expects the pixels sorted in row/col
+      chipData.getData().emplace_back(pix.first, pix.second);
+    }
+    buffer.ensureFreeCapacity(40 * (2 + chips[ic].size()));
+    if (chips[ic].empty()) {
+      coder.addEmptyChip(buffer, ic & AlpideCoder::MaskChipID, 100);
+    } else {
+      coder.encodeChip(buffer, chipData, ic & AlpideCoder::MaskChipID, 100);
+    }
+  }
+  return std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.getSize());
+}
+
+std::set<std::pair<uint16_t, uint16_t>> randomChip(std::mt19937& gen, int nHits)
+{
+  std::uniform_int_distribution<uint16_t> row(0, AlpideCoder::NRows - 1), col(0, AlpideCoder::NCols - 1);
+  std::set<std::pair<uint16_t, uint16_t>> pixels;
+  while (int(pixels.size()) < nHits) {
+    pixels.emplace(row(gen), col(gen));
+  }
+  return pixels;
+}
+
+// clusters of fired pixels produce DATALONG words with various hit maps
+std::set<std::pair<uint16_t, uint16_t>> clusteredChip(std::mt19937& gen, int nClusters)
+{
+  std::uniform_int_distribution<int> row(0, AlpideCoder::NRows - 1), col(0, AlpideCoder::NCols - 1), size(1, 8), coin(0, 1);
+  std::set<std::pair<uint16_t, uint16_t>> pixels;
+  for (int i = 0; i < nClusters; i++) {
+    int r0 = row(gen), c0 = col(gen), nr = size(gen), nc = size(gen);
+    for (int r = r0; r < std::min(r0 + nr, AlpideCoder::NRows); r++) {
+      for (int c = c0; c < std::min(c0 + nc, AlpideCoder::NCols); c++) {
+        if (coin(gen) || nr * nc < 4) {
+          pixels.emplace(r, c);
+        }
+      }
+    }
+  }
+  return pixels;
+}
+
+void compareDecoders(const std::vector<uint8_t>& data)
+{
+  auto reference = decodeCable<true>(data);
+  auto decoded = decodeCable<false>(data);
+  BOOST_REQUIRE_EQUAL(reference.size(), decoded.size());
+  for (size_t i = 0; i < reference.size(); i++) {
+    BOOST_CHECK(reference[i] == decoded[i]);
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(AlpideCoder_decodeEncoded)
+{
+  std::mt19937 gen(12345);
+  std::vector<std::set<std::pair<uint16_t, uint16_t>>> chips;
+  chips.push_back(randomChip(gen, 1));
+  chips.emplace_back(); // empty chip
+  chips.push_back(randomChip(gen, 100));
+  chips.push_back(clusteredChip(gen, 50));
+  chips.push_back(randomChip(gen, 20000)); // high occupancy
+  chips.push_back(clusteredChip(gen, 2000));
+  std::set<std::pair<uint16_t, uint16_t>> doubleColumn, rightColumn, region;
+  for (uint16_t r = 0; r < AlpideCoder::NRows; r++) {
+    doubleColumn.emplace(r, 100);
+    doubleColumn.emplace(r, 101);
+    rightColumn.emplace(r, 1023); // every hit goes through the right column buffer
+    for (uint16_t c = 64; c < 96; c++) {
+      region.emplace(r, c);
+    }
+  }
+  chips.push_back(doubleColumn);
+  chips.push_back(rightColumn);
+  chips.push_back(region); // fully fired region
+
+  auto data = encodeCable(chips);
+  auto decoded = decodeCable<false>(data);
+  compareDecoders(data);
+
+  // the decoded pixels are those encoded, sorted in column/row
+  size_t nNonEmpty = std::count_if(chips.begin(), chips.end(), [](const auto& c) { return !c.empty(); });
+  BOOST_REQUIRE_EQUAL(decoded.size(), nNonEmpty);
+  size_t id = 0;
+  for (size_t ic = 0; ic < chips.size(); ic++) {
+    if (chips[ic].empty()) {
+      continue;
+    }
+    std::vector<std::pair<uint16_t, uint16_t>> expected(chips[ic].begin(), chips[ic].end());
+    std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+      return a.second < b.second || (a.second == b.second && a.first < b.first);
+    });
+    BOOST_CHECK_EQUAL(decoded[id].chipID, ic);
+    BOOST_CHECK(decoded[id].errors == 0);
+    BOOST_CHECK(decoded[id].pixels == expected);
+    id++;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AlpideCoder_decodeCorrupted)
+{
+  std::mt19937 gen(54321);
+  std::vector<std::set<std::pair<uint16_t, uint16_t>>> chips{randomChip(gen, 300), clusteredChip(gen, 100), {}, randomChip(gen, 5)};
+  auto data = encodeCable(chips);
+
+  // truncated at every position, which cuts DATASHORT, DATALONG and the hit maps
+  for (size_t size = 1; size < data.size(); size += 1 + size / 64) {
+    compareDecoders(std::vector<uint8_t>(data.begin(), data.begin() + size));
+  }
+  // random bytes replaced
+  std::uniform_int_distribution<size_t> pos(0, data.size() - 1);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (int i = 0; i < 200; i++) {
+    auto corrupted = data;
+    for (int j = 0; j < 3; j++) {
+      corrupted[pos(gen)] = byte(gen);
+    }
+    compareDecoders(corrupted);
+  }
+}
@@ -16,8 +16,10 @@
 /// @brief  Reader for (multiple) raw data files
 
 #include <cstdio>
+#include <functional>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include <tuple>
 #include <vector>
 #include <string>
@@ -49,6 +51,9 @@ struct ReaderInp {
   bool cache = false;
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
+  bool mmap = false;
+  int nThreads = 1;
+  std::string indexCacheDir{};
 };
 
 class RawFileReader
@@ -204,6 +209,11 @@ class RawFileReader
     size_t skipNextHBF();
     size_t skipNextTF();
 
+    // zero-copy access to the data of memory mapped files, nullptr is returned if the data is not contiguous in the mapped file.
+    // If the mapping is provided, it keeps the file mapped as long as the data is used, even after the reader is destroyed
+    const char* getNextHBFPtr(size_t& sz, std::shared_ptr<const char>* mapping = nullptr);
+    const char* getNextSuperPagePtr(size_t& sz, const PartStat* pstat = nullptr, std::shared_ptr<const char>* mapping = nullptr);
+
     bool rewindToTF(uint32_t tf);
     void print(bool verbose = false, const std::string& pref = "") const;
     std::string describe() const;
@@ -263,6 +273,16 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  bool getMemoryMapped() const { return mMemoryMapped; }
+  void setMemoryMapped(bool v) { mMemoryMapped = v; }
+
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
+  // directory to store the index of the links blocks obtained by the preprocessing, so that it is not repeated for the same inputs
+  void setIndexCacheDir(const std::string& d) { mIndexCacheDir = d; }
+  const std::string& getIndexCacheDir() const { return mIndexCacheDir; }
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -282,18 +302,34 @@ class RawFileReader
 
  private:
   int getLinkLocalID(const RDHAny& rdh, int fileID);
-  bool preprocessFile(int ifl);
+  bool scanFile(int ifl, const std::function<bool(const RDHAny&)>& processRDH) const;
+  bool preprocessFile(int ifl, const std::vector<RDHAny>* rdhs);
+  std::string getIndexCacheKey() const;
+  std::string getIndexCacheName(const std::string& key) const;
+  bool loadIndexCache(const std::string& key);
+  void storeIndexCache(const std::string& key) const;
+  bool mapFile(int ifl);
+  void adviseWillNeed(int ifl, size_t offset, size_t size) const;
+  const char* getMappedData(int ifl) const { return ifl < int(mFileMaps.size()) ? mFileMaps[ifl].data.get() : nullptr; }
+  bool isInMappedFile(int ifl, size_t offset, size_t size) const { return offset <= mFileMaps[ifl].size && size <= mFileMaps[ifl].size - offset; }
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
+  struct MappedFile {
+    std::shared_ptr<char> data; // unmapped when the last reference is released
+    size_t size = 0;
+  };
+
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
   static constexpr o2::header::DataDescription DEFDataDescription = o2::header::gDataDescriptionRawData;
   static constexpr ReadoutCardType DEFCardType = CRU;
+  static constexpr uint32_t IndexCacheVersion = 1;
   o2::header::DataOrigin mDefDataOrigin = DEFDataOrigin;                //!
   o2::header::DataDescription mDefDataDescription = DEFDataDescription; //!
   ReadoutCardType mDefCardType = CRU;                                   //!
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  std::vector<MappedFile> mFileMaps;                                    //! memory mapped input files
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
   bool mInitDone = false;
   bool mEmpty = true;
@@ -311,6 +347,9 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMemoryMapped = false;                                       //! map the files to memory rather than reading them via stdio
+  int mNThreads = 1;                                                //! number of threads for the files preprocessing
+  std::string mIndexCacheDir{};                                     //! directory for the block index cache, no caching if empty
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
   bool mPreferCalculatedTFStart = false;                            //! prefer TFstart calculated via HBFUtils
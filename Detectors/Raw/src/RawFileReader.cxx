@@ -13,11 +13,15 @@
 /// @brief  Reader for (multiple) raw data files
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <memory>
 #include <sstream>
+#include <type_traits>
 #include <iostream>
 #include "DetectorsRaw/RawFileReader.h"
 #include "Headers/DAQID.h"
@@ -29,6 +33,13 @@
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::raw;
 namespace o2h = o2::header;
@@ -132,6 +143,14 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
     ibl++;
     if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
+    } else if (const char* mapped = reader->getMappedData(blc.fileID)) {
+      if (reader->isInMappedFile(blc.fileID, blc.offset, blc.size)) {
+        memcpy(buff + sz, mapped + blc.offset, blc.size);
+      } else {
+        LOGF(ERROR, "Failed to read for the %s a bloc beyond the end of the mapped file:", describe());
+        blc.print();
+        error = true;
+      }
     } else {
       auto fl = reader->mFiles[blc.fileID];
       if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
@@ -232,6 +251,20 @@ bool RawFileReader::LinkData::rewindToTF(uint32_t tf)
   // go to given TF
   if (tf < tfStartBlock.size()) {
     nextBlock2Read = tfStartBlock[tf].first;
+    if (reader->mMemoryMapped) { // ask to prefetch the TF data, merging the blocks of the same file
+      int ibl = nextBlock2Read, nbl = blocks.size();
+      while (ibl < nbl && blocks[ibl].tfID == blocks[nextBlock2Read].tfID) {
+        int fileID = blocks[ibl].fileID;
+        size_t beg = blocks[ibl].offset, end = beg + blocks[ibl].size;
+        while (++ibl < nbl && blocks[ibl].tfID == blocks[nextBlock2Read].tfID && blocks[ibl].fileID == fileID) {
+          beg = std::min(beg, blocks[ibl].offset);
+          end = std::max(end, blocks[ibl].offset + blocks[ibl].size);
+        }
+        if (reader->getMappedData(fileID)) {
+          reader->adviseWillNeed(fileID, beg, end - beg);
+        }
+      }
+    }
   } else {
     LOG(WARNING) << "No TF " << tf << " for " << describe();
     nextBlock2Read = -1;
@@ -286,6 +319,14 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   if (sz) {
     if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
       memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
+    } else if (const char* mapped = reader->getMappedData(blocks[nextBlock2Read].fileID)) {
+      if (reader->isInMappedFile(blocks[nextBlock2Read].fileID, blocks[nextBlock2Read].offset, sz)) {
+        memcpy(buff, mapped + blocks[nextBlock2Read].offset, sz);
+      } else {
+        LOGF(ERROR, "Failed to read for the %s a bloc beyond the end of the mapped file:", describe());
+        blocks[nextBlock2Read].print();
+        error = true;
+      }
     } else {
       auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
       if (fseek(fl, blocks[nextBlock2Read].offset, SEEK_SET) || fread(buff, 1, sz, fl) != sz) {
@@ -302,6 +343,83 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+const char* RawFileReader::LinkData::getNextHBFPtr(size_t& sz, std::shared_ptr<const char>* mapping)
+{
+  // in the memory mapped mode provide the data of the next complete HB in place and advance as the readNextHBF.
+  // If the file is not mapped, the blocks of the HB are not contiguous in the file or exceed the mapped size,
+  // return nullptr w/o advancing, the readNextHBF will report the error of the latter
+  sz = 0;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return nullptr;
+  }
+  const auto& blc0 = blocks[nextBlock2Read];
+  const char* mapped = reader->getMappedData(blc0.fileID);
+  if (!mapped) {
+    return nullptr;
+  }
+  int ibl = nextBlock2Read, nbl = blocks.size();
+  size_t end = blc0.offset;
+  while (ibl < nbl && blocks[ibl].ir == blc0.ir) {
+    if (blocks[ibl].fileID != blc0.fileID || blocks[ibl].offset != end) {
+      return nullptr;
+    }
+    end += blocks[ibl++].size;
+  }
+  if (!reader->isInMappedFile(blc0.fileID, blc0.offset, end - blc0.offset)) {
+    return nullptr;
+  }
+  sz = end - blc0.offset;
+  nextBlock2Read = ibl;
+  if (mapping) {
+    *mapping = reader->mFileMaps[blc0.fileID].data;
+  }
+  return mapped + blc0.offset;
+}
+
+//____________________________________________
+const char* RawFileReader::LinkData::getNextSuperPagePtr(size_t& sz, const RawFileReader::PartStat* pstat, std::shared_ptr<const char>* mapping)
+{
+  // in the memory mapped mode provide the data of the next superpage in place and advance as the readNextSuperPage.
+  // If the file is not mapped, the blocks are not contiguous in the file or exceed the mapped size, return nullptr w/o advancing
+  sz = 0;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return nullptr;
+  }
+  const auto& blc0 = blocks[nextBlock2Read];
+  const char* mapped = reader->getMappedData(blc0.fileID);
+  if (!mapped) {
+    return nullptr;
+  }
+  int ibl = nextBlock2Read, nbl = blocks.size();
+  size_t end = blc0.offset;
+  while (ibl < nbl) {
+    const auto& blc = blocks[ibl];
+    if (pstat ? ibl - nextBlock2Read == pstat->nBlocks
+              : (ibl > nextBlock2Read && (blc.tfID != blc0.tfID || blc.testFlag(LinkBlock::StartSP) ||
+                                          (end - blc0.offset + blc.size) > reader->mNominalSPageSize))) {
+      break;
+    }
+    if (blc.fileID != blc0.fileID || blc.offset != end) {
+      if (pstat) { // the superpage is not contiguous
+        return nullptr;
+      }
+      break; // discontinuity defines the new superpage
+    }
+    end += blc.size;
+    ibl++;
+  }
+  if (!reader->isInMappedFile(blc0.fileID, blc0.offset, end - blc0.offset)) {
+    return nullptr;
+  }
+  sz = end - blc0.offset;
+  nextBlock2Read = ibl;
+  if (mapping) {
+    *mapping = reader->mFileMaps[blc0.fileID].data;
+  }
+  return mapped + blc0.offset;
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getLargestSuperPage() const
 {
@@ -560,66 +678,362 @@ int RawFileReader::getLinkLocalID(const RDHAny& rdh, int fileID)
 }
 
 //_____________________________________________________________________
-bool RawFileReader::preprocessFile(int ifl)
+bool RawFileReader::scanFile(int ifl, const std::function<bool(const RDHAny&)>& processRDH) const
+{
+  // pass the RDHs of the file to processRDH until it returns false, may be called concurrently for different files
+  size_t pos = 0, fileSize = 0, nRDH = 0;
+  struct stat st;
+  if (getMappedData(ifl)) {
+    fileSize = mFileMaps[ifl].size;
+  } else if (!fstat(fileno(mFiles[ifl]), &st)) {
+    fileSize = st.st_size;
+  } else {
+    LOGF(ERROR, "Failed to get the size of %s", mFileNames[ifl]);
+    return false;
+  }
+  auto addRDH = [&](const RDHAny& rdh) {
+    // register RDH, return its offset to the next one or 0 if no more data should be read
+    int offs = RDHUtils::getOffsetToNext(rdh);
+    if (!offs) {
+      LOGF(ERROR, "Zero offset to next RDH at position %zu of %s", pos, mFileNames[ifl]);
+      return 0;
+    }
+    if (pos + offs > fileSize) { // truncated page, its block would exceed the file
+      LOGF(ERROR, "RDH at position %zu of %s points to %d bytes beyond the end of file, discarding it", pos, mFileNames[ifl], int(pos + offs - fileSize));
+      return 0;
+    }
+    if (!processRDH(rdh)) {
+      return 0;
+    }
+    nRDH++;
+    pos += offs;
+    return offs;
+  };
+
+  if (const char* mapped = getMappedData(ifl)) { // memory mapped file: scan RDHs in place
+    const auto& fmap = mFileMaps[ifl];
+    while (pos + sizeof(RDHAny) <= fmap.size && addRDH(*reinterpret_cast<const RDHAny*>(mapped + pos))) {
+    }
+  } else {
+    FILE* fl = mFiles[ifl];
+    std::unique_ptr<char[]> buffer = std::make_unique<char[]>(mBufferSize);
+    rewind(fl);
+    size_t nr = 0;
+    bool readMore = true;
+    while (readMore && (nr = fread(buffer.get(), 1, mBufferSize, fl)) >= sizeof(RDHAny)) {
+      size_t boffs = 0;
+      while (1) {
+        auto offs = addRDH(*reinterpret_cast<const RDHAny*>(&buffer[boffs]));
+        if (!offs) {
+          readMore = false;
+          break;
+        }
+        boffs += offs;
+        if (boffs + sizeof(RDHAny) >= nr) {
+          if (fseek(fl, pos, SEEK_SET)) {
+            readMore = false;
+          }
+          break;
+        }
+      }
+    }
+  }
+  return nRDH > 0;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::preprocessFile(int ifl, const std::vector<RDHAny>* rdhs)
 {
-  // preprocess file, check RDH data, build statistics
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(mBufferSize);
-  FILE* fl = mFiles[ifl];
+  // preprocess RDHs of the file, check RDH data, build statistics.
+  // The RDHs are either collected in advance or, if rdhs is null, streamed from the file until the max TF is reached
   mCurrentFileID = ifl;
   LinkSpec_t specPrev = 0xffffffffffffffff;
   int lIDPrev = -1;
   mMultiLinkFile = false;
-  rewind(fl);
-  long int nr = 0;
   mPosInFile = 0;
-  size_t nRDHread = 0, boffs;
-  bool readMore = true;
-  while (readMore && (nr = fread(buffer.get(), 1, mBufferSize, fl))) {
-    boffs = 0;
-    while (1) {
-      auto& rdh = *reinterpret_cast<RDHUtils::RDHAny*>(&buffer[boffs]);
-      nRDHread++;
-      LinkSpec_t spec = createSpec(std::get<0>(mDataSpecs[mCurrentFileID]), RDHUtils::getSubSpec(rdh));
-      int lID = lIDPrev;
-      if (spec != specPrev) { // link has changed
-        specPrev = spec;
-        if (lIDPrev != -1) {
-          mMultiLinkFile = true;
-        }
-        lID = getLinkLocalID(rdh, mCurrentFileID);
-      }
-      bool newSPage = lID != lIDPrev;
-      mLinksData[lID].preprocessCRUPage(rdh, newSPage);
-      if (mLinksData[lID].nTimeFrames && (mLinksData[lID].nTimeFrames - 1 > mMaxTFToRead)) { // limit reached, discard the last read
-        mLinksData[lID].nTimeFrames--;
-        mLinksData[lID].blocks.pop_back();
-        if (mLinksData[lID].nHBFrames > 0) {
-          mLinksData[lID].nHBFrames--;
-        }
-        if (mLinksData[lID].nCRUPages > 0) {
-          mLinksData[lID].nCRUPages--;
-        }
-        lIDPrev = -1; // last block is closed
-        readMore = false;
-        break;
+  size_t nRDHread = 0;
+  auto processRDH = [&](const RDHAny& rdh) {
+    nRDHread++;
+    LinkSpec_t spec = createSpec(std::get<0>(mDataSpecs[mCurrentFileID]), RDHUtils::getSubSpec(rdh));
+    int lID = lIDPrev;
+    if (spec != specPrev) { // link has changed
+      specPrev = spec;
+      if (lIDPrev != -1) {
+        mMultiLinkFile = true;
       }
-      boffs += RDHUtils::getOffsetToNext(rdh);
-      mPosInFile += RDHUtils::getOffsetToNext(rdh);
-      lIDPrev = lID;
-      if (boffs + sizeof(RDHUtils::RDHAny) >= nr) {
-        if (fseek(fl, mPosInFile, SEEK_SET)) {
-          readMore = false;
-          break;
-        }
+      lID = getLinkLocalID(rdh, mCurrentFileID);
+    }
+    bool newSPage = lID != lIDPrev;
+    mLinksData[lID].preprocessCRUPage(rdh, newSPage);
+    if (mLinksData[lID].nTimeFrames && (mLinksData[lID].nTimeFrames - 1 > mMaxTFToRead)) { // limit reached, discard the last read
+      mLinksData[lID].nTimeFrames--;
+      mLinksData[lID].blocks.pop_back();
+      if (mLinksData[lID].nHBFrames > 0) {
+        mLinksData[lID].nHBFrames--;
+      }
+      if (mLinksData[lID].nCRUPages > 0) {
+        mLinksData[lID].nCRUPages--;
+      }
+      lIDPrev = -1; // last block is closed
+      return false;
+    }
+    mPosInFile += RDHUtils::getOffsetToNext(rdh);
+    lIDPrev = lID;
+    return true;
+  };
+  if (rdhs) {
+    for (const auto& rdh : *rdhs) {
+      if (!processRDH(rdh)) {
         break;
       }
     }
+  } else {
+    scanFile(ifl, processRDH);
+  }
+  if (mMultiLinkFile && getMappedData(ifl)) { // links will be read interleaved, the sequential read-ahead is not appropriate anymore
+    madvise(mFileMaps[ifl].data.get(), mFileMaps[ifl].size, MADV_NORMAL);
   }
   LOGF(INFO, "File %3d : %9li bytes scanned, %6d RDH read for %4d links from %s",
        mCurrentFileID, mPosInFile, nRDHread, int(mLinkEntries.size()), mFileNames[mCurrentFileID]);
   return nRDHread > 0;
 }
 
+//_____________________________________________________________________
+bool RawFileReader::mapFile(int ifl)
+{
+  // map the file to memory, on failure the file will be read via stdio
+  auto& fmap = mFileMaps[ifl];
+  int fd = fileno(mFiles[ifl]);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) || st.st_size <= 0) {
+    LOG(ERROR) << "Failed to get the size of " << mFileNames[ifl] << ", will not map it";
+    return false;
+  }
+  void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (ptr == MAP_FAILED) {
+    LOG(ERROR) << "Failed to map " << mFileNames[ifl] << " to memory: " << strerror(errno);
+    return false;
+  }
+  madvise(ptr, st.st_size, MADV_SEQUENTIAL); // the preprocessing scans the whole file
+  size_t size = st.st_size;
+  fmap.data.reset(reinterpret_cast<char*>(ptr), [size](char* data) { munmap(data, size); });
+  fmap.size = size;
+  LOGF(INFO, "File %3d : %zu bytes mapped to memory", ifl, fmap.size);
+  return true;
+}
+
+//_____________________________________________________________________
+void RawFileReader::adviseWillNeed(int ifl, size_t offset, size_t size) const
+{
+  // ask the kernel to prefetch the pages of the mapped file range
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const auto& fmap = mFileMaps[ifl];
+  if (offset >= fmap.size) {
+    return;
+  }
+  size_t beg = offset - offset % pageSize;
+  madvise(fmap.data.get() + beg, std::min(offset + size, fmap.size) - beg, MADV_WILLNEED);
+}
+
+//_____________________________________________________________________
+std::string RawFileReader::getIndexCacheKey() const
+{
+  // description of the input files and of the settings affecting the preprocessing, the cached index is valid only for the same key
+  std::stringstream key;
+  const auto& hbu = HBFUtils::Instance();
+  key << "maxTF:" << mMaxTFToRead << " errCheck:" << mCheckErrors << " calcTF:" << mPreferCalculatedTFStart
+      << " autodetect:" << int(mFirstTFAutodetect) << " orbitFirst:" << hbu.orbitFirst << " nHBFPerTF:" << hbu.nHBFPerTF;
+  for (int i = 0; i < int(mFiles.size()); i++) {
+    struct stat st;
+    if (fstat(fileno(mFiles[i]), &st)) {
+      return "";
+    }
+    key << '\n'
+        << mFileNames[i] << ' ' << std::get<0>(mDataSpecs[i]).as<std::string>() << ' ' << std::get<1>(mDataSpecs[i]).as<std::string>()
+        << ' ' << int(std::get<2>(mDataSpecs[i])) << " size:" << st.st_size << " mtime:" << st.st_mtim.tv_sec << '.' << st.st_mtim.tv_nsec;
+  }
+  return key.str();
+}
+
+//_____________________________________________________________________
+std::string RawFileReader::getIndexCacheName(const std::string& key) const
+{
+  // name of the index cache file for given set of inputs
+  if (mIndexCacheDir.empty() || key.empty()) {
+    return "";
+  }
+  std::stringstream fnm;
+  fnm << mIndexCacheDir << "/rawreader_" << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(key) << ".idx";
+  return fnm.str();
+}
+
+namespace
+{
+template <typename T>
+void writePOD(std::ostream& os, const T& v)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written");
+  os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+void readPOD(std::istream& is, T& v)
+{
+  static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read");
+  is.read(reinterpret_cast<char*>(&v), sizeof(T));
+}
+} // namespace
+
+//_____________________________________________________________________
+void RawFileReader::storeIndexCache(const std::string& key) const
+{
+  // store the links block index obtained by the preprocessing
+  auto fname = getIndexCacheName(key);
+  if (fname.empty()) {
+    return;
+  }
+  auto fnameTmp = fname + ".tmp";
+  std::ofstream os(fnameTmp, std::ios::binary);
+  writePOD(os, IndexCacheVersion);
+  writePOD(os, key.size());
+  os.write(key.data(), key.size());
+  writePOD(os, mEmpty);
+  uint32_t orbitFirst = HBFUtils::Instance().orbitFirst; // to impose if it was autodetected
+  writePOD(os, orbitFirst);
+  writePOD(os, mLinksData.size());
+  for (const auto& lnk : mLinksData) {
+    writePOD(os, lnk.rdhl);
+    writePOD(os, lnk.irOfSOX);
+    writePOD(os, lnk.spec);
+    writePOD(os, lnk.subspec);
+    writePOD(os, lnk.nTimeFrames);
+    writePOD(os, lnk.nHBFrames);
+    writePOD(os, lnk.nSPages);
+    writePOD(os, lnk.nCRUPages);
+    writePOD(os, lnk.cruDetector);
+    writePOD(os, lnk.continuousRO);
+    writePOD(os, lnk.origin);
+    writePOD(os, lnk.description);
+    writePOD(os, lnk.nErrors);
+    writePOD(os, lnk.blocks.size());
+    for (const auto& blc : lnk.blocks) {
+      writePOD(os, blc.offset);
+      writePOD(os, blc.size);
+      writePOD(os, blc.tfID);
+      writePOD(os, blc.ir);
+      writePOD(os, blc.fileID);
+      writePOD(os, blc.flags);
+    }
+    writePOD(os, lnk.tfStartBlock.size());
+    for (const auto& tfs : lnk.tfStartBlock) { // std::pair is not trivially copyable
+      writePOD(os, tfs.first);
+      writePOD(os, tfs.second);
+    }
+  }
+  os.close();
+  if (!os.good() || std::rename(fnameTmp.c_str(), fname.c_str())) {
+    LOG(ERROR) << "Failed to store the block index to " << fname;
+    std::remove(fnameTmp.c_str());
+    return;
+  }
+  LOG(INFO) << "Stored the block index of " << mLinksData.size() << " links to " << fname;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::loadIndexCache(const std::string& key)
+{
+  // load the links block index stored for the same inputs and settings instead of preprocessing the files
+  auto fname = getIndexCacheName(key);
+  if (fname.empty()) {
+    return false;
+  }
+  std::ifstream is(fname, std::ios::binary);
+  if (!is.good()) {
+    LOG(INFO) << "No block index cache " << fname << " was found, will preprocess the files";
+    return false;
+  }
+  auto version = IndexCacheVersion;
+  size_t keySize = 0;
+  readPOD(is, version);
+  readPOD(is, keySize);
+  if (!is.good() || version != IndexCacheVersion || keySize != key.size()) {
+    LOG(WARNING) << "Block index cache " << fname << " is incompatible, will preprocess the files";
+    return false;
+  }
+  std::string keyStored(keySize, ' ');
+  is.read(keyStored.data(), keySize);
+  if (keyStored != key) {
+    LOG(WARNING) << "Block index cache " << fname << " is for different inputs or settings, will preprocess the files";
+    return false;
+  }
+  bool empty = true;
+  uint32_t orbitFirst = 0;
+  size_t nLinks = 0;
+  readPOD(is, empty);
+  readPOD(is, orbitFirst);
+  readPOD(is, nLinks);
+  std::vector<LinkData> links;
+  int nErrors = 0;
+  for (size_t il = 0; is.good() && il < nLinks; il++) {
+    RDHAny rdh;
+    readPOD(is, rdh);
+    auto& lnk = links.emplace_back(rdh, this);
+    readPOD(is, lnk.irOfSOX);
+    readPOD(is, lnk.spec);
+    readPOD(is, lnk.subspec);
+    readPOD(is, lnk.nTimeFrames);
+    readPOD(is, lnk.nHBFrames);
+    readPOD(is, lnk.nSPages);
+    readPOD(is, lnk.nCRUPages);
+    readPOD(is, lnk.cruDetector);
+    readPOD(is, lnk.continuousRO);
+    readPOD(is, lnk.origin);
+    readPOD(is, lnk.description);
+    readPOD(is, lnk.nErrors);
+    size_t n = 0;
+    readPOD(is, n);
+    lnk.blocks.resize(is.good() ? n : 0);
+    for (auto& blc : lnk.blocks) {
+      readPOD(is, blc.offset);
+      readPOD(is, blc.size);
+      readPOD(is, blc.tfID);
+      readPOD(is, blc.ir);
+      readPOD(is, blc.fileID);
+      readPOD(is, blc.flags);
+    }
+    readPOD(is, n);
+    lnk.tfStartBlock.resize(is.good() ? n : 0);
+    for (auto& tfs : lnk.tfStartBlock) {
+      readPOD(is, tfs.first);
+      readPOD(is, tfs.second);
+    }
+    nErrors += lnk.nErrors;
+  }
+  if (!is.good()) {
+    LOG(ERROR) << "Failed to read block index cache " << fname << ", will preprocess the files";
+    return false;
+  }
+  mLinksData.swap(links);
+  mLinkEntries.clear();
+  for (int il = 0; il < int(mLinksData.size()); il++) {
+    mLinkEntries[mLinksData[il].spec] = il;
+  }
+  mEmpty = empty;
+  if (mFirstTFAutodetect == FirstTFDetection::Pending) {
+    imposeFirstTF(orbitFirst);
+  }
+  for (const auto& fmap : mFileMaps) { // the links will be read interleaved
+    if (fmap.data) {
+      madvise(fmap.data.get(), fmap.size, MADV_NORMAL);
+    }
+  }
+  LOG(INFO) << "Loaded the block index of " << mLinksData.size() << " links from " << fname;
+  if (nErrors) {
+    LOG(WARNING) << nErrors << " errors were detected when the index was built";
+  }
+  return true;
+}
+
 //_____________________________________________________________________
 void RawFileReader::printStat(bool verbose) const
 {
@@ -642,6 +1056,7 @@ void RawFileReader::clear()
     fclose(fl);
   }
   mFiles.clear();
+  mFileMaps.clear(); // the files stay mapped while their data is referred to by the zero-copy users
   mFileNames.clear();
 
   mCurrentFileID = 0;
@@ -699,11 +1114,47 @@ bool RawFileReader::init()
   }
 
   int nf = mFiles.size();
+  if (mMemoryMapped) {
+    if (mCacheData) {
+      LOG(WARNING) << "Data caching is redundant in the memory mapped mode, disabling it";
+      mCacheData = false;
+    }
+    mFileMaps.resize(nf);
+    for (int i = 0; i < nf; i++) {
+      mapFile(i);
+    }
+  }
   mEmpty = true;
-  for (int i = 0; i < nf; i++) {
-    if (preprocessFile(i)) {
-      mEmpty = false;
+  auto indexKey = mIndexCacheDir.empty() ? std::string{} : getIndexCacheKey(); // must be defined before the preprocessing may impose the 1st TF
+  if (!loadIndexCache(indexKey)) {
+    if (mMaxTFToRead < 0xffffffff) { // the RDHs are streamed to the preprocessing to stop reading the files at the max TF
+      for (int i = 0; i < nf; i++) {
+        if (preprocessFile(i, nullptr)) {
+          mEmpty = false;
+        }
+      }
+    } else {
+      // the files are scanned concurrently but their RDHs are processed in order since the link data may span several files
+#ifdef WITH_OPENMP
+#pragma omp parallel for ordered schedule(dynamic) num_threads(mNThreads)
+#endif
+      for (int i = 0; i < nf; i++) {
+        std::vector<RDHAny> rdhs;
+        scanFile(i, [&rdhs](const RDHAny& rdh) {
+          rdhs.push_back(rdh);
+          return true;
+        });
+#ifdef WITH_OPENMP
+#pragma omp ordered
+#endif
+        {
+          if (preprocessFile(i, &rdhs)) {
+            mEmpty = false;
+          }
+        }
+      }
     }
+    storeIndexCache(indexKey);
   }
   mOrderedIDs.resize(mLinksData.size());
   for (int i = mLinksData.size(); i--;) {
@@ -901,6 +1352,15 @@ RawFileReader::InputsMap RawFileReader::parseInput(const std::string& confUri)
   return entries;
 }
 
+void RawFileReader::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 void RawFileReader::imposeFirstTF(uint32_t orbit)
 {
   if (mFirstTFAutodetect != FirstTFDetection::Pending) {
@@ -32,6 +32,7 @@
 
 #include <unistd.h>
 #include <algorithm>
+#include <memory>
 #include <unordered_map>
 #include <cctype>
 #include <string>
@@ -75,6 +76,7 @@ class RawReaderSpecs : public o2f::Task
   size_t mLoopsDone = 0;
   size_t mSentSize = 0;
   size_t mSentMessages = 0;
+  size_t mSentZeroCopy = 0;
   bool mPartPerSP = true;                                          // fill part per superpage
   std::string mRawChannelName = "";                                // name of optional non-DPL channel
   std::unique_ptr<o2::raw::RawFileReader> mReader;                 // matching engine
@@ -95,6 +97,9 @@ RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMemoryMapped(rinp.mmap);
+  mReader->setNThreads(rinp.nThreads);
+  mReader->setIndexCacheDir(rinp.indexCacheDir);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
   LOG(INFO) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
@@ -202,7 +207,7 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
       LOG(INFO) << "Starting new loop " << mLoopsDone << " from the beginning of data";
     } else {
       mTimer[TimerTotal].Stop();
-      LOGF(INFO, "Finished: payload of %zu bytes in %zu messages sent for %d TFs", mSentSize, mSentMessages, mTFCounter);
+      LOGF(INFO, "Finished: payload of %zu bytes in %zu messages (%zu zero-copy) sent for %d TFs", mSentSize, mSentMessages, mSentZeroCopy, mTFCounter);
       for (int i = 0; i < NTimers; i++) {
         LOGF(INFO, "Timing for %15s: Cpu: %.3e Real: %.3e s in %d slots", TimerName[i], mTimer[i].CpuTime(), mTimer[i].RealTime(), mTimer[i].Counter() - 1);
       }
@@ -254,9 +259,23 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
       hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
       auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+      FairMQMessagePtr plMessage;
       mTimer[TimerIO].Start(false);
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      size_t bread = 0;
+      const char* mapped = nullptr;
+      std::shared_ptr<const char> mapping;
+      if (mReader->getMemoryMapped()) { // ship the pages of the mapped file w/o copying if the part is contiguous in the file
+        mapped = mPartPerSP ? link.getNextSuperPagePtr(bread, &partsSP[hdrTmpl.splitPayloadIndex], &mapping) : link.getNextHBFPtr(bread, &mapping);
+      }
+      if (mapped) { // the message holds a reference to the mapping, so the file stays mapped until it is freed, even w/o the reader
+        auto hint = new std::shared_ptr<const char>(std::move(mapping));
+        plMessage = fmqFactory->CreateMessage(
+          const_cast<char*>(mapped), bread, [](void*, void* hint) { delete static_cast<std::shared_ptr<const char>*>(hint); }, hint);
+        mSentZeroCopy++;
+      } else {
+        plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+        bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      }
       if (bread != hdrTmpl.payloadSize) {
         LOG(ERROR) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
                    << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
@@ -12,11 +12,16 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <memory>
 #include <TRandom.h>
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 #include "Steer/InteractionSampler.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "DetectorsRaw/RDHUtils.h"
@@ -188,6 +193,7 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
 
   std::unique_ptr<RawFileReader> reader;
   std::string confName;
+  bool memMapped = false;
 
   //_________________________________________________________________
   TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg") : confName(cfg) {}
@@ -199,6 +205,7 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
     uint32_t errCheck = 0xffffffff;
     errCheck ^= 0x1 << RawFileReader::ErrNoSuperPageForTF; // makes no sense for superpages not interleaved by others
     reader->setCheckErrors(errCheck);
+    reader->setMemoryMapped(memMapped);
     reader->init();
   }
 
@@ -306,6 +313,149 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
   } // run
 };
 
+void compareMappedReader(const std::string& cfg)
+{
+  // data provided in place by the reader of memory mapped files must be identical to the one read via stdio
+  RawFileReader rdStd(cfg), rdMap(cfg);
+  rdMap.setMemoryMapped(true);
+  rdStd.init();
+  rdMap.init();
+  BOOST_REQUIRE(rdStd.getNLinks() == rdMap.getNLinks());
+  std::vector<char> buff, buffMap;
+  int nHBF = 0, nZeroCopy = 0;
+  for (int il = 0; il < rdStd.getNLinks(); il++) {
+    auto& lnkStd = rdStd.getLink(il);
+    auto& lnkMap = rdMap.getLink(il);
+    while (auto sz = lnkStd.getNextHBFSize()) {
+      buff.resize(sz);
+      BOOST_CHECK(lnkStd.readNextHBF(buff.data()) == sz);
+      size_t szMap = 0;
+      const char* ptr = lnkMap.getNextHBFPtr(szMap);
+      if (ptr) {
+        BOOST_CHECK(szMap == sz && memcmp(ptr, buff.data(), sz) == 0);
+        nZeroCopy++;
+      } else { // HBF is not contiguous in the file
+        buffMap.resize(sz);
+        BOOST_CHECK(lnkMap.readNextHBF(buffMap.data()) == sz);
+        BOOST_CHECK(buffMap == buff);
+      }
+      nHBF++;
+    }
+  }
+  LOG(INFO) << nZeroCopy << " of " << nHBF << " HBFs were provided by the memory mapped reader w/o copying";
+
+  // the data provided in place together with its mapping stays valid after the reader is destroyed
+  std::shared_ptr<const char> mapping;
+  const char* ptr = nullptr;
+  size_t sz = 0;
+  {
+    RawFileReader rdTmp(cfg);
+    rdTmp.setMemoryMapped(true);
+    rdTmp.init();
+    auto& lnk = rdTmp.getLink(0);
+    buff.resize(lnk.getNextHBFSize());
+    ptr = lnk.getNextHBFPtr(sz, &mapping);
+    if (ptr) {
+      memcpy(buff.data(), ptr, sz);
+    }
+  }
+  if (ptr) {
+    BOOST_CHECK(mapping.use_count() == 1);
+    BOOST_CHECK(memcmp(ptr, buff.data(), sz) == 0);
+  }
+}
+
+void checkTruncatedFile(const std::string& cfg)
+{
+  // the page cut by the end of file must be discarded by the preprocessing, so that no block exceeds the mapped file
+  const auto& [spec, files] = *RawFileReader::parseInput(cfg).begin();
+  std::ifstream inp(files.front(), std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(inp)), std::istreambuf_iterator<char>());
+  const std::string truncName = "truncated_" + CFGName + ".raw";
+  {
+    std::ofstream out(truncName, std::ios::binary);
+    out.write(content.data(), content.size() - RDHUtils::GBTWord);
+  }
+  size_t totSize[2] = {0};
+  for (int mapped = 0; mapped < 2; mapped++) {
+    RawFileReader reader;
+    reader.addFile(truncName, std::get<0>(spec), std::get<1>(spec), std::get<2>(spec));
+    reader.setMemoryMapped(mapped);
+    reader.init();
+    std::vector<char> buff;
+    for (int il = 0; il < reader.getNLinks(); il++) {
+      auto& lnk = reader.getLink(il);
+      while (auto sz = lnk.getNextHBFSize()) {
+        buff.resize(sz);
+        BOOST_CHECK(lnk.readNextHBF(buff.data()) == sz);
+        totSize[mapped] += sz;
+      }
+    }
+  }
+  BOOST_CHECK(totSize[0] == totSize[1]);
+  BOOST_CHECK(totSize[1] > 0 && totSize[1] < content.size() - RDHUtils::GBTWord);
+  std::remove(truncName.c_str());
+}
+
+void checkMaxTF(const std::string& cfg, uint32_t maxTF)
+{
+  // the reader limited in TFs streams the RDHs to the preprocessing, its TFs must be the same as those of the full reader
+  RawFileReader rdFull(cfg), rdLim(cfg);
+  rdFull.init();
+  rdLim.setMaxTFToRead(maxTF);
+  rdLim.setMemoryMapped(true);
+  rdLim.init();
+  BOOST_REQUIRE(rdFull.getNLinks() == rdLim.getNLinks());
+  BOOST_REQUIRE(rdLim.getNTimeFrames() < rdFull.getNTimeFrames());
+  std::vector<char> buffFull, buffLim;
+  for (int il = 0; il < rdFull.getNLinks(); il++) {
+    auto& lnkFull = rdFull.getLink(il);
+    auto& lnkLim = rdLim.getLink(il);
+    BOOST_CHECK(lnkLim.nTimeFrames <= maxTF + 1);
+    for (uint32_t tf = 0; tf < lnkLim.nTimeFrames; tf++) {
+      buffFull.resize(lnkFull.getNextTFSize());
+      buffLim.resize(lnkLim.getNextTFSize());
+      BOOST_CHECK(lnkFull.readNextTF(buffFull.data()) == buffFull.size());
+      BOOST_CHECK(lnkLim.readNextTF(buffLim.data()) == buffLim.size());
+      BOOST_CHECK(buffFull == buffLim);
+    }
+  }
+}
+
+void checkIndexCache(const std::string& cfg)
+{
+  // the reader initialized from the cached block index must provide the same data as the one which preprocessed the files
+  auto cacheDir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("rawreader-%%%%-%%%%");
+  boost::filesystem::create_directories(cacheDir);
+  RawFileReader rdScan(cfg), rdCached(cfg);
+  rdScan.setIndexCacheDir(cacheDir.string());
+  rdScan.setNThreads(2);
+  rdScan.init(); // preprocesses the files and stores the index
+  rdCached.setIndexCacheDir(cacheDir.string());
+  rdCached.init(); // loads the index
+  BOOST_CHECK(!boost::filesystem::is_empty(cacheDir));
+  BOOST_REQUIRE(rdScan.getNLinks() == rdCached.getNLinks());
+  BOOST_CHECK(rdScan.getNTimeFrames() == rdCached.getNTimeFrames());
+  std::vector<char> buffScan, buffCached;
+  for (int il = 0; il < rdScan.getNLinks(); il++) {
+    auto& lnkScan = rdScan.getLink(il);
+    auto& lnkCached = rdCached.getLink(il);
+    BOOST_CHECK(lnkScan.spec == lnkCached.spec);
+    BOOST_CHECK(lnkScan.blocks.size() == lnkCached.blocks.size());
+    BOOST_CHECK(lnkScan.tfStartBlock == lnkCached.tfStartBlock);
+    for (uint32_t tf = 0; tf < lnkScan.nTimeFrames; tf++) { // read TFs in reverse order to test direct access
+      uint32_t tfr = lnkScan.nTimeFrames - 1 - tf;
+      BOOST_CHECK(lnkScan.rewindToTF(tfr) && lnkCached.rewindToTF(tfr));
+      buffScan.resize(lnkScan.getNextTFSize());
+      buffCached.resize(lnkCached.getNextTFSize());
+      BOOST_CHECK(lnkScan.readNextTF(buffScan.data()) == buffScan.size());
+      BOOST_CHECK(lnkCached.readNextTF(buffCached.data()) == buffCached.size());
+      BOOST_CHECK(buffScan == buffCached);
+    }
+  }
+  boost::filesystem::remove_all(cacheDir);
+}
+
 BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
 {
   TestRawWriter dw{"TST", true, "test_raw_conf_GBT.cfg"}; // this is a CRU detector with origin TST
@@ -316,6 +466,15 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
   dr.init();
   dr.run(); // read back and check
 
+  TestRawReader drm{"TST", "test_raw_conf_GBT.cfg"}; // same with memory mapped files
+  drm.memMapped = true;
+  drm.init();
+  drm.run();
+  compareMappedReader(dr.confName);
+  checkIndexCache(dr.confName);
+  checkTruncatedFile(dr.confName);
+  checkMaxTF(dr.confName, 0);
+
   // test SimpleReader
   int nLoops = 5;
   SimpleRawReader sr(dr.confName, false, nLoops);
@@ -16,6 +16,8 @@
 #define ALICEO2_TPC_DigitContainer_H_
 
 #include <deque>
+#include <memory>
+#include <vector>
 #include "TPCBase/CRU.h"
 #include "DataFormatsTPC/Defs.h"
 #include "TPCSimulation/DigitTime.h"
@@ -64,7 +66,8 @@ class DigitContainer
   /// \param globalPad Global pad number of the digit
   /// \param timeBin Time bin of the digit
   /// \param signal Charge of the digit in ADC counts
-  void addDigit(const MCCompLabel& label, const CRU& cru, TimeBin timeBin, GlobalPadNumber globalPad, float signal);
+  /// \param nContributions Number of electrons which contribute to the signal
+  void addDigit(const MCCompLabel& label, const CRU& cru, TimeBin timeBin, GlobalPadNumber globalPad, float signal, int nContributions = 1);
 
   /// Fill output vector
   /// \param output Output container
@@ -79,12 +82,23 @@ class DigitContainer
   /// Get the size of the container for one event
   size_t size() const { return mTimeBins.size(); }
 
+  /// Get the number of allocated time bin containers, either in use or waiting to be recycled
+  size_t getNumberOfAllocatedTimeBins() const { return mNAllocatedTimeBins; }
+
  private:
-  TimeBin mFirstTimeBin = 0;       ///< First time bin to consider
-  TimeBin mEffectiveTimeBin = 0;   ///< Effective time bin of that digit
-  TimeBin mTmaxTriggered = 0;      ///< Maximum time bin in case of triggered mode (hard cut at average drift speed with additional margin)
-  TimeBin mOffset;                 ///< Size of the container for one event
-  std::deque<DigitTime> mTimeBins; ///< Time bin Container for the ADC value
+  /// Get an empty time bin container, recycled from the pool if possible
+  std::unique_ptr<DigitTime> getTimeBinContainer();
+
+  /// Reset a time bin container and return it to the pool
+  void recycleTimeBinContainer(std::unique_ptr<DigitTime>& time);
+
+  TimeBin mFirstTimeBin = 0;                             ///< First time bin to consider
+  TimeBin mEffectiveTimeBin = 0;                         ///< Effective time bin of that digit
+  TimeBin mTmaxTriggered = 0;                            ///< Maximum time bin in case of triggered mode (hard cut at average drift speed with additional margin)
+  TimeBin mOffset;                                       ///< Size of the container for one event
+  size_t mNAllocatedTimeBins = 0;                        ///< Number of DigitTime objects created so far
+  std::deque<std::unique_ptr<DigitTime>> mTimeBins;      //! Time bin Container for the ADC value, empty for time bins without signal
+  std::vector<std::unique_ptr<DigitTime>> mTimeBinsPool; //! Reset time bin containers ready for reuse
 };
 
 inline DigitContainer::DigitContainer()
@@ -104,7 +118,9 @@ inline void DigitContainer::reset()
   mFirstTimeBin = 0;
   mEffectiveTimeBin = 0;
   for (auto& time : mTimeBins) {
-    time.reset();
+    if (time) {
+      recycleTimeBinContainer(time);
+    }
   }
 }
 
@@ -116,10 +132,31 @@ inline void DigitContainer::reserve(TimeBin eventTimeBin)
 }
 
 inline void DigitContainer::addDigit(const MCCompLabel& label, const CRU& cru, TimeBin timeBin, GlobalPadNumber globalPad,
-                                     float signal)
+                                     float signal, int nContributions)
 {
   mEffectiveTimeBin = timeBin - mFirstTimeBin;
-  mTimeBins[mEffectiveTimeBin].addDigit(label, cru, globalPad, signal);
+  auto& time = mTimeBins[mEffectiveTimeBin];
+  if (!time) {
+    time = getTimeBinContainer();
+  }
+  time->addDigit(label, cru, globalPad, signal, nContributions);
+}
+
+inline std::unique_ptr<DigitTime> DigitContainer::getTimeBinContainer()
+{
+  if (mTimeBinsPool.empty()) {
+    ++mNAllocatedTimeBins;
+    return std::make_unique<DigitTime>();
+  }
+  auto time = std::move(mTimeBinsPool.back());
+  mTimeBinsPool.pop_back();
+  return time;
+}
+
+inline void DigitContainer::recycleTimeBinContainer(std::unique_ptr<DigitTime>& time)
+{
+  time->reset();
+  mTimeBinsPool.emplace_back(std::move(time));
 }
 
 } // namespace tpc
@@ -62,8 +62,9 @@ class DigitGlobalPad
   /// \param eventID MC Event ID
   /// \param trackID MC Track ID
   /// \param signal Charge of the digit in ADC counts
+  /// \param nContributions Number of electrons which contribute to the signal
   void addDigit(const MCCompLabel& label, float signal,
-                o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false>&);
+                o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false>&, int nContributions = 1);
 
   void setID(int id) { mID = id; }
   int getID() const { return mID; }
@@ -94,13 +95,14 @@ class DigitGlobalPad
 };
 
 inline void DigitGlobalPad::addDigit(const MCCompLabel& label, float signal,
-                                     o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false>& labels)
+                                     o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false>& labels,
+                                     int nContributions)
 {
   bool isKnown = false;
   auto view = labels.getLabels(mID);
   for (auto& mcLabel : view) {
     if (compareMClabels(label, mcLabel.first)) {
-      ++mcLabel.second;
+      mcLabel.second += nContributions;
       isKnown = true;
       break;
     }
@@ -108,7 +110,7 @@ inline void DigitGlobalPad::addDigit(const MCCompLabel& label, float signal,
 
   //
   if (!isKnown) {
-    std::pair<MCCompLabel, int> newlabel(label, 1);
+    std::pair<MCCompLabel, int> newlabel(label, nContributions);
     labels.addLabel(mID, newlabel);
   }
   mChargePad += signal;
@@ -117,6 +119,7 @@ inline void DigitGlobalPad::addDigit(const MCCompLabel& label, float signal,
 inline void DigitGlobalPad::reset()
 {
   mChargePad = 0;
+  mID = -1;
 }
 
 inline bool DigitGlobalPad::compareMClabels(const MCCompLabel& label1, const MCCompLabel& label2) const
@@ -15,6 +15,8 @@
 #ifndef ALICEO2_TPC_DigitTime_H_
 #define ALICEO2_TPC_DigitTime_H_
 
+#include <algorithm>
+#include <vector>
 #include "TPCBase/Mapper.h"
 #include "TPCSimulation/DigitGlobalPad.h"
 #include "SimulationDataFormat/LabelContainer.h"
@@ -44,8 +46,12 @@ class DigitTime
   ~DigitTime() = default;
 
   /// Resets the container
+  /// Only the pads which received a signal are touched
   void reset();
 
+  /// Get the number of pads with signal in this time bin
+  size_t getNumberOfOccupiedPads() const { return mOccupiedPads.size(); }
+
   /// Get common mode for a given GEM stack
   /// \param gemstack GEM stack of the digit
   /// \return Common mode value in that time bin for a given GEM ROC
@@ -62,7 +68,8 @@ class DigitTime
   /// \param cru CRU of the digit
   /// \param globalPad Global pad number of the digit
   /// \param signal Charge of the digit in ADC counts
-  void addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal);
+  /// \param nContributions Number of electrons which contribute to the signal
+  void addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal, int nContributions = 1);
 
   /// Fill output vector
   /// \param output Output container
@@ -81,7 +88,7 @@ class DigitTime
   int mDigitCounter = 0;                                             ///< counts the number of digits in this timebin
 
   o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false> mLabels;
-  // std::deque<int> mOccupiedPads; // iterable container of occupied pads
+  std::vector<GlobalPadNumber> mOccupiedPads; ///< Pads which received a signal in this time bin
 };
 
 inline DigitTime::DigitTime() : mCommonMode(), mGlobalPads()
@@ -90,23 +97,26 @@ inline DigitTime::DigitTime() : mCommonMode(), mGlobalPads()
   mLabels.reserve(Mapper::getPadsInSector() / 3);
 }
 
-inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal)
+inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal, int nContributions)
 {
   auto& paddigit = mGlobalPads[globalPad];
   if (paddigit.getID() == -1) {
     // this means we have a new digit
     paddigit.setID(mDigitCounter++);
-    // could also register this pad in a vector of digits
+    mOccupiedPads.emplace_back(globalPad);
   }
-  paddigit.addDigit(label, signal, mLabels);
+  paddigit.addDigit(label, signal, mLabels, nContributions);
   mCommonMode[cru.gemStack()] += signal;
 }
 
 inline void DigitTime::reset()
 {
-  for (auto& pad : mGlobalPads) {
-    pad.reset();
+  for (const auto globalPad : mOccupiedPads) {
+    mGlobalPads[globalPad].reset();
   }
+  mOccupiedPads.clear();
+  mDigitCounter = 0;
+  mLabels.clear();
   mCommonMode.fill(0.f);
 }
 
@@ -124,19 +134,20 @@ inline void DigitTime::fillOutputContainer(std::vector<Digit>& output, dataforma
                                            float commonMode)
 {
   static Mapper& mapper = Mapper::instance();
-  GlobalPadNumber globalPad = 0;
   for (size_t i = 0; i < mCommonMode.size(); ++i) {
     const float cm = getCommonMode(GEMstack(i));
     if (cm > 0.) {
       commonModeOutput.push_back({cm, timeBin, static_cast<unsigned char>(i)});
     }
   }
-  for (auto& pad : mGlobalPads) {
+  // write out the digits in ascending pad order, as if the full sector was scanned
+  std::sort(mOccupiedPads.begin(), mOccupiedPads.end());
+  for (const auto globalPad : mOccupiedPads) {
+    auto& pad = mGlobalPads[globalPad];
     if (pad.getChargePad() > 0.) {
       const CRU cru = mapper.getCRU(sector, globalPad);
       pad.fillOutputContainer<MODE>(output, mcTruth, cru, timeBin, globalPad, mLabels, getCommonMode(cru));
     }
-    ++globalPad;
   }
 }
 } // namespace tpc
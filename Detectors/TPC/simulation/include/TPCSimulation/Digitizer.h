@@ -122,6 +122,20 @@ class Digitizer
   void setUseSCDistortions(TFile& finp);
 
  private:
+  /// Electron which arrived at a valid pad of the processed sector
+  struct ElectronArrival {
+    DigitPos digiPadPos; ///< Pad at which the electron arrives
+    float absoluteTime;  ///< Arrival time of the electron in us
+  };
+
+  /// Shaped signal of a single electron in one time bin of a pad
+  struct PadSignal {
+    TimeBin timeBin;           ///< Time bin of the signal
+    GlobalPadNumber globalPad; ///< Global pad number in the sector
+    CRU cru;                   ///< CRU of the pad
+    float signal;              ///< Signal in ADC counts
+  };
+
   DigitContainer mDigitContainer;   ///< Container for the Digits
   std::unique_ptr<SC> mSpaceCharge; ///< Handler of space-charge distortions
   Sector mSector = -1;              ///< ID of the currently processed sector
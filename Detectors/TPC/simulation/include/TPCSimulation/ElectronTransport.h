@@ -18,6 +18,8 @@
 #include "TPCBase/ParameterDetector.h"
 #include "TPCBase/ParameterGas.h"
 
+#include <vector>
+
 #include "TPCBase/Mapper.h"
 #include "MathUtils/RandomRing.h"
 
@@ -26,6 +28,29 @@ namespace o2
 namespace tpc
 {
 
+/// \struct DriftedElectrons
+/// Electrons of one hit after the drift, stored as structure of arrays to allow for vectorised processing.
+/// The arrays are padded to a multiple of the Vc vector size, only the first size entries are valid.
+struct DriftedElectrons {
+  std::vector<float> x;         ///< x position after diffusion
+  std::vector<float> y;         ///< y position after diffusion
+  std::vector<float> z;         ///< z position after diffusion
+  std::vector<float> driftTime; ///< Drift time taking into account diffusion in z direction
+  std::vector<char> isAttached; ///< Flag whether the electron is lost due to attachment
+  size_t size = 0;              ///< Number of electrons
+
+  void resize(size_t nElectrons)
+  {
+    size = nElectrons;
+    const size_t nPadded = (nElectrons + float_v::size() - 1) / float_v::size() * float_v::size();
+    x.resize(nPadded);
+    y.resize(nPadded);
+    z.resize(nPadded);
+    driftTime.resize(nPadded);
+    isAttached.resize(nPadded);
+  }
+};
+
 /// \class ElectronTransport
 /// This class handles the electron transport in the active volume of the TPC.
 /// In particular, in deals with the diffusion of the charge cloud while drifting towards the readout chambers and the
@@ -52,6 +77,13 @@ class ElectronTransport
   /// \return GlobalPosition3D with position of the electrons after the drift taking into account diffusion
   GlobalPosition3D getElectronDrift(GlobalPosition3D posEle, float& driftTime);
 
+  /// Drift of a group of electrons starting at the same position, taking into account diffusion
+  /// The random numbers for the diffusion are drawn and applied in Vc vectors
+  /// \param posEle GlobalPosition3D with start position of the electrons
+  /// \param nElectrons Number of electrons
+  /// \param electrons Output container with the positions and drift times of the electrons after the drift
+  void getElectronDrift(GlobalPosition3D posEle, int nElectrons, DriftedElectrons& electrons);
+
   /// Drift of electrons in electric field taking into account diffusion with 3 sigma of the width
   /// \param posEle GlobalPosition3D with start position of the electrons
   /// \return GlobalPosition3D with position of the electrons after the drift taking into account diffusion with
@@ -63,6 +95,10 @@ class ElectronTransport
   /// \return Boolean whether the electron is attached (and lost) or not
   bool isElectronAttachment(float driftTime);
 
+  /// Attachment for a group of electrons, using their drift times
+  /// \param electrons Drifted electrons, for which the attachment flag is set
+  void getElectronAttachment(DriftedElectrons& electrons);
+
   /// Compute electron drift time from z position
   /// \param zPos z position of the charge
   /// \param signChange If the zPosition of the charge is shifted to the other TPC side, the drift length needs to be
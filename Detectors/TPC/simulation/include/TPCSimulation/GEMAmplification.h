@@ -15,6 +15,7 @@
 #ifndef ALICEO2_TPC_GEMAmplification_H_
 #define ALICEO2_TPC_GEMAmplification_H_
 
+#include <vector>
 #include "MathUtils/RandomRing.h"
 #include "TPCBase/ParameterGas.h"
 #include "TPCBase/ParameterGEM.h"
@@ -58,6 +59,20 @@ class GEMAmplification
   /// \return Number of electrons after amplification in an  effective single-stage amplification
   int getEffectiveStackAmplification(int nElectrons = 1);
 
+  /// Compute the number of electrons after amplification in an effective single-stage amplification for a group of
+  /// single electrons, drawing the random numbers in Vc vectors
+  /// \param nElectrons Number of single electrons arriving at the first amplification stage (GEM1)
+  /// \param nElectronsGEM Output container with the number of electrons after amplification for each of the incoming
+  /// electrons, padded to a multiple of the Vc vector size
+  void getEffectiveStackAmplification(size_t nElectrons, std::vector<int>& nElectronsGEM);
+
+  /// Multiply the number of electrons after amplification with the local gain on the pad
+  /// \param nElectrons Number of electrons after amplification
+  /// \param cru CRU where the electrons arrive
+  /// \param pos PadPos where the electrons arrive
+  /// \return Number of electrons after taking into account the local variations of the amplification
+  int applyGainMap(int nElectrons, const CRU& cru, const PadPos& pos) const;
+
   /// Compute the number of electrons after amplification in a full stack of four GEM foils
   /// taking into account local variations of the electron amplification
   /// \param nElectrons Number of electrons arriving at the first amplification stage (GEM1)
@@ -112,18 +127,21 @@ inline int GEMAmplification::getStackAmplification(const CRU& cru, const PadPos&
   /// pad
   switch (mode) {
     case AmplificationMode::FullMode: {
-      return static_cast<int>(static_cast<float>(getStackAmplification(nElectrons)) *
-                              mGainMap->getValue(cru, pos.getRow(), pos.getPad()));
+      return applyGainMap(getStackAmplification(nElectrons), cru, pos);
       break;
     }
     case AmplificationMode::EffectiveMode: {
-      return static_cast<int>(static_cast<float>(getEffectiveStackAmplification(nElectrons)) *
-                              mGainMap->getValue(cru, pos.getRow(), pos.getPad()));
+      return applyGainMap(getEffectiveStackAmplification(nElectrons), cru, pos);
       break;
     }
   }
   return nElectrons;
 }
+
+inline int GEMAmplification::applyGainMap(int nElectrons, const CRU& cru, const PadPos& pos) const
+{
+  return static_cast<int>(static_cast<float>(nElectrons) * mGainMap->getValue(cru, pos.getRow(), pos.getPad()));
+}
 } // namespace tpc
 } // namespace o2
 
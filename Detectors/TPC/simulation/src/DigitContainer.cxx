@@ -36,21 +36,27 @@ void DigitContainer::fillOutputContainer(std::vector<Digit>& output,
       }
       ++nProcessedTimeBins;
 
+      /// time bins without any signal were never allocated and produce no output
+      if (!time) {
+        timeBin++;
+        continue;
+      }
+
       switch (digitizationMode) {
         case DigitzationMode::FullMode: {
-          time.fillOutputContainer<DigitzationMode::FullMode>(output, mcTruth, commonModeOutput, sector, timeBin);
+          time->fillOutputContainer<DigitzationMode::FullMode>(output, mcTruth, commonModeOutput, sector, timeBin);
           break;
         }
         case DigitzationMode::SubtractPedestal: {
-          time.fillOutputContainer<DigitzationMode::SubtractPedestal>(output, mcTruth, commonModeOutput, sector, timeBin);
+          time->fillOutputContainer<DigitzationMode::SubtractPedestal>(output, mcTruth, commonModeOutput, sector, timeBin);
           break;
         }
         case DigitzationMode::NoSaturation: {
-          time.fillOutputContainer<DigitzationMode::NoSaturation>(output, mcTruth, commonModeOutput, sector, timeBin);
+          time->fillOutputContainer<DigitzationMode::NoSaturation>(output, mcTruth, commonModeOutput, sector, timeBin);
           break;
         }
         case DigitzationMode::PropagateADC: {
-          time.fillOutputContainer<DigitzationMode::PropagateADC>(output, mcTruth, commonModeOutput, sector, timeBin);
+          time->fillOutputContainer<DigitzationMode::PropagateADC>(output, mcTruth, commonModeOutput, sector, timeBin);
           break;
         }
       }
@@ -62,6 +68,9 @@ void DigitContainer::fillOutputContainer(std::vector<Digit>& output,
   if (nProcessedTimeBins > 0) {
     mFirstTimeBin += nProcessedTimeBins;
     while (nProcessedTimeBins--) {
+      if (mTimeBins.front()) {
+        recycleTimeBinContainer(mTimeBins.front());
+      }
       mTimeBins.pop_front();
     }
   }
@@ -30,6 +30,8 @@
 
 #include "FairLogger.h"
 
+#include <algorithm>
+
 ClassImp(o2::tpc::Digitizer);
 
 using namespace o2::tpc;
@@ -62,7 +64,14 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
   const int nShapedPoints = eleParam.NShapedPoints;
   const auto amplificationMode = gemParam.AmplMode;
   static std::vector<float> signalArray;
-  signalArray.resize(nShapedPoints);
+  /// getShapedSignal fills the array in chunks of the Vc vector size
+  signalArray.resize((nShapedPoints + Vc::float_v::size() - 1) / Vc::float_v::size() * Vc::float_v::size());
+
+  /// Static workspace containers, reused for all hit groups
+  static DriftedElectrons driftedElectrons;
+  static std::vector<ElectronArrival> arrivals;
+  static std::vector<int> nElectronsGEM;
+  static std::vector<PadSignal> padSignals;
 
   /// Reserve space in the digit container for the current event
   mDigitContainer.reserve(sampaProcessing.getTimeBinFromTime(mEventTime));
@@ -72,6 +81,12 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
 
   for (auto& hitGroup : hits) {
     const int MCTrackID = hitGroup.GetTrackID();
+    const MCCompLabel label(MCTrackID, eventID, sourceID, false);
+
+    /// The signals of all electrons of the hit group are collected and summed up per pad and time bin before they are
+    /// added to the digit container
+    padSignals.clear();
+
     for (size_t hitindex = 0; hitindex < hitGroup.getSize(); ++hitindex) {
       const auto& eh = hitGroup.getHit(hitindex);
 
@@ -91,32 +106,35 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
       /// The energy loss stored corresponds to nElectrons
       const int nPrimaryElectrons = static_cast<int>(eh.GetEnergyLoss());
       const float hitTime = eh.GetTime() * 0.001; /// in us
-      float driftTime = 0.f;
 
       /// TODO: add primary ions to space-charge density
 
-      /// Loop over electrons
-      for (int iEle = 0; iEle < nPrimaryElectrons; ++iEle) {
+      /// Drift, diffusion and attachment of all electrons of the hit
+      electronTransport.getElectronDrift(posEle, nPrimaryElectrons, driftedElectrons);
+      electronTransport.getElectronAttachment(driftedElectrons);
 
-        /// Drift and Diffusion
-        const GlobalPosition3D posEleDiff = electronTransport.getElectronDrift(posEle, driftTime);
+      /// Loop over electrons to find the pads they arrive at
+      arrivals.clear();
+      for (int iEle = 0; iEle < nPrimaryElectrons; ++iEle) {
+        const float driftTime = driftedElectrons.driftTime[iEle];
         const float eleTime = driftTime + hitTime; /// in us
         if (eleTime > maxEleTime) {
           LOG(WARNING) << "Skipping electron with driftTime " << driftTime << " from hit at time " << hitTime;
           continue;
         }
-        const float absoluteTime = eleTime + mEventTime; /// in us
 
         /// Attachment
-        if (electronTransport.isElectronAttachment(driftTime)) {
+        if (driftedElectrons.isAttached[iEle]) {
           continue;
         }
 
         /// Remove electrons that end up outside the active volume
-        if (std::abs(posEleDiff.Z()) > detParam.TPClength) {
+        if (std::abs(driftedElectrons.z[iEle]) > detParam.TPClength) {
           continue;
         }
 
+        const GlobalPosition3D posEleDiff(driftedElectrons.x[iEle], driftedElectrons.y[iEle], driftedElectrons.z[iEle]);
+
         /// When the electron is not in the sector we're processing, abandon
         if (mapper.isOutOfSector(posEleDiff, mSector)) {
           continue;
@@ -133,24 +151,50 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
           continue;
         }
 
-        /// Electron amplification
-        const int nElectronsGEM = gemAmplification.getStackAmplification(digiPadPos.getCRU(), digiPadPos.getPadPos(), amplificationMode);
-        if (nElectronsGEM == 0) {
+        const float absoluteTime = eleTime + mEventTime; /// in us
+        arrivals.push_back({digiPadPos, absoluteTime});
+      }
+      /// end of loop over electrons
+
+      /// Electron amplification, in the effective mode the gain is drawn for all electrons at once
+      if (amplificationMode == AmplificationMode::EffectiveMode) {
+        gemAmplification.getEffectiveStackAmplification(arrivals.size(), nElectronsGEM);
+      }
+
+      for (size_t iArrival = 0; iArrival < arrivals.size(); ++iArrival) {
+        const auto& arrival = arrivals[iArrival];
+        const CRU cru = arrival.digiPadPos.getCRU();
+        const int nElectronsAmplified = (amplificationMode == AmplificationMode::EffectiveMode)
+                                          ? gemAmplification.applyGainMap(nElectronsGEM[iArrival], cru, arrival.digiPadPos.getPadPos())
+                                          : gemAmplification.getStackAmplification(cru, arrival.digiPadPos.getPadPos(), amplificationMode);
+        if (nElectronsAmplified == 0) {
           continue;
         }
 
-        const GlobalPadNumber globalPad = mapper.globalPadNumber(digiPadPos.getGlobalPadPos());
-        const float ADCsignal = sampaProcessing.getADCvalue(static_cast<float>(nElectronsGEM));
-        const MCCompLabel label(MCTrackID, eventID, sourceID, false);
-        sampaProcessing.getShapedSignal(ADCsignal, absoluteTime, signalArray);
-        for (float i = 0; i < nShapedPoints; ++i) {
-          const float time = absoluteTime + i * eleParam.ZbinWidth;
-          mDigitContainer.addDigit(label, digiPadPos.getCRU(), sampaProcessing.getTimeBinFromTime(time), globalPad,
-                                   signalArray[i]);
+        const GlobalPadNumber globalPad = mapper.globalPadNumber(arrival.digiPadPos.getGlobalPadPos());
+        const float ADCsignal = sampaProcessing.getADCvalue(static_cast<float>(nElectronsAmplified));
+        sampaProcessing.getShapedSignal(ADCsignal, arrival.absoluteTime, signalArray);
+        for (int i = 0; i < nShapedPoints; ++i) {
+          const float time = arrival.absoluteTime + i * eleParam.ZbinWidth;
+          padSignals.push_back({sampaProcessing.getTimeBinFromTime(time), globalPad, cru, signalArray[i]});
         }
         /// TODO: add ion backflow to space-charge density
       }
-      /// end of loop over electrons
+    }
+
+    /// Sum up the signals per time bin and pad and pass them to the digit container in one go
+    std::sort(padSignals.begin(), padSignals.end(), [](const PadSignal& a, const PadSignal& b) {
+      return (a.timeBin < b.timeBin) || (a.timeBin == b.timeBin && a.globalPad < b.globalPad);
+    });
+    for (size_t first = 0; first < padSignals.size();) {
+      const auto& padSignal = padSignals[first];
+      float signal = 0.f;
+      size_t last = first;
+      for (; last < padSignals.size() && padSignals[last].timeBin == padSignal.timeBin && padSignals[last].globalPad == padSignal.globalPad; ++last) {
+        signal += padSignals[last].signal;
+      }
+      mDigitContainer.addDigit(label, padSignal.cru, padSignal.timeBin, padSignal.globalPad, signal, static_cast<int>(last - first));
+      first = last;
     }
   }
 }
@@ -65,6 +65,53 @@ GlobalPosition3D ElectronTransport::getElectronDrift(GlobalPosition3D posEle, fl
   return posEleDiffusion;
 }
 
+void ElectronTransport::getElectronDrift(GlobalPosition3D posEle, int nElectrons, DriftedElectrons& electrons)
+{
+  electrons.resize(nElectrons);
+
+  /// For drift lengths shorter than 1 mm, the drift length is set to that value
+  float driftl = mDetParam->TPClength - std::abs(posEle.Z());
+  if (driftl < 0.01) {
+    driftl = 0.01;
+  }
+  driftl = std::sqrt(driftl);
+  const float_v sigT(driftl * mGasParam->DiffT);
+  const float_v sigL(driftl * mGasParam->DiffL);
+  const float_v posX(posEle.X());
+  const float_v posY(posEle.Y());
+  const float_v posZ(posEle.Z());
+  const float_v tpcLength(mDetParam->TPClength);
+  const float_v driftV(mGasParam->DriftV);
+
+  for (size_t i = 0; i < electrons.size; i += float_v::size()) {
+    const float_v x = (mRandomGaus.getNextValueVc() * sigT) + posX;
+    const float_v y = (mRandomGaus.getNextValueVc() * sigT) + posY;
+    float_v z = (mRandomGaus.getNextValueVc() * sigL) + posZ;
+
+    /// Same treatment of a sign change in the z position as for the single electron case
+    const auto sideChange = (posZ / z) < float_v::Zero();
+    const float_v signChange = Vc::iif(sideChange, float_v(-1.f), float_v(1.f));
+    const float_v driftTime = (tpcLength - signChange * Vc::abs(z)) / driftV;
+    z(sideChange) = posZ;
+
+    x.store(&electrons.x[i]);
+    y.store(&electrons.y[i]);
+    z.store(&electrons.z[i]);
+    driftTime.store(&electrons.driftTime[i]);
+  }
+}
+
+void ElectronTransport::getElectronAttachment(DriftedElectrons& electrons)
+{
+  const float_v attachment(mGasParam->AttCoeff * mGasParam->OxygenCont);
+  for (size_t i = 0; i < electrons.size; i += float_v::size()) {
+    const auto isAttached = mRandomFlat.getNextValueVc() < attachment * float_v(&electrons.driftTime[i]);
+    for (size_t j = 0; j < float_v::size(); ++j) {
+      electrons.isAttached[i + j] = isAttached[j];
+    }
+  }
+}
+
 bool ElectronTransport::isCompletelyOutOfSectorCoarseElectronDrift(GlobalPosition3D posEle, const Sector& sector) const
 {
   /// For drift lengths shorter than 1 mm, the drift length is set to that value
@@ -142,6 +142,22 @@ int GEMAmplification::getEffectiveStackAmplification(int nElectrons)
   return nElectronsGEM;
 }
 
+void GEMAmplification::getEffectiveStackAmplification(size_t nElectrons, std::vector<int>& nElectronsGEM)
+{
+  /// Same as for a single electron, but the collection efficiency and the gain fluctuations for all electrons are
+  /// drawn at once
+  nElectronsGEM.resize((nElectrons + float_v::size() - 1) / float_v::size() * float_v::size());
+  const float_v efficiency(mGEMParam->EfficiencyStack);
+  for (size_t i = 0; i < nElectrons; i += float_v::size()) {
+    const auto isLost = mRandomFlat.getNextValueVc() < efficiency;
+    float_v gain = mGainFullStack.getNextValueVc();
+    gain.setZero(isLost);
+    for (size_t j = 0; j < float_v::size(); ++j) {
+      nElectronsGEM[i + j] = static_cast<int>(gain[j]);
+    }
+  }
+}
+
 int GEMAmplification::getSingleGEMAmplification(int nElectrons, int GEM)
 {
   /// The effective gain of the GEM foil is given by three components
@@ -166,5 +166,53 @@ BOOST_AUTO_TEST_CASE(DigitContainer_test2)
     BOOST_CHECK_CLOSE(commonMode[i].getCommonMode(), chargeSum[i] / nPads, 1E-6);
   }
 }
+
+/// \brief Test of the DigitContainer
+/// Two events are filled into the same pads of the same time bin, with a flush in between, and we check that the
+/// recycled time bin containers do not carry over charge or MC labels from the first event
+BOOST_AUTO_TEST_CASE(DigitContainer_test3)
+{
+  auto& cdb = CDBInterface::instance();
+  cdb.setUseDefaults();
+  o2::conf::ConfigurableParam::updateFromString("TPCEleParam.DigiMode=3"); // propagate the ADC values, otherwise the computation get complicated
+  const Mapper& mapper = Mapper::instance();
+  DigitContainer digitContainer;
+  digitContainer.reset();
+
+  const std::vector<int> Row = {12, 5, 2};
+  const std::vector<int> Pad = {1, 15, 23};
+  const std::vector<int> nEle = {60, 100, 1023};
+  const int time = 100;
+
+  for (int event = 0; event < 2; ++event) {
+    dataformats::MCTruthContainer<MCCompLabel> mMCTruthArray;
+    std::vector<Digit> mDigitsArray;
+    std::vector<o2::tpc::CommonMode> commonMode;
+    digitContainer.setStartTime(0);
+    digitContainer.reserve(time);
+    for (int i = 0; i < Row.size(); ++i) {
+      const GlobalPadNumber globalPad = mapper.getPadNumberInROC(PadROCPos(CRU(0).roc(), PadPos(Row[i], Pad[i])));
+      digitContainer.addDigit(MCCompLabel(i, event, 0, false), 0, time, globalPad, nEle[i]);
+    }
+    digitContainer.fillOutputContainer(mDigitsArray, mMCTruthArray, commonMode, 0, 0, true, true);
+
+    // only a single time bin received signal, hence a single container is allocated
+    BOOST_CHECK(digitContainer.getNumberOfAllocatedTimeBins() == 1);
+    BOOST_CHECK(mDigitsArray.size() == Row.size());
+
+    // digits come out in ascending pad order, which is the reverse of the insertion order here
+    for (int i = 0; i < static_cast<int>(mDigitsArray.size()); ++i) {
+      const auto& digit = mDigitsArray[i];
+      const int trueDigit = Row.size() - 1 - i;
+      BOOST_CHECK(digit.getRow() == Row[trueDigit]);
+      BOOST_CHECK(digit.getPad() == Pad[trueDigit]);
+      BOOST_CHECK_CLOSE(digit.getChargeFloat(), nEle[trueDigit], 1E-6);
+      const auto& mcArray = mMCTruthArray.getLabels(i);
+      BOOST_CHECK(mcArray.size() == 1);
+      BOOST_CHECK(mcArray[0].getTrackID() == trueDigit);
+      BOOST_CHECK(mcArray[0].getEventID() == event);
+    }
+  }
+}
 } // namespace tpc
 } // namespace o2
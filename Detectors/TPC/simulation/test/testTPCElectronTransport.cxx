@@ -120,6 +120,54 @@ BOOST_AUTO_TEST_CASE(ElectronDiffusion_test2)
   BOOST_CHECK_CLOSE(gausZ.GetParameter(2), gasParam.DiffL, 0.5);
 }
 
+/// \brief Test 3 of the getElectronDrift function
+/// Same as test 1, but all electrons are drifted at once
+/// using the vectorised version of the function
+///
+/// Precision: 0.5 %.
+BOOST_AUTO_TEST_CASE(ElectronDiffusion_test3)
+{
+  auto& gasParam = ParameterGas::Instance();
+  auto& detParam = ParameterDetector::Instance();
+  const GlobalPosition3D posEle(10.f, 10.f, 10.f);
+  TH1D hTestDiffX("hTestDiffX", "", 500, posEle.X() - 10., posEle.X() + 10.);
+  TH1D hTestDiffY("hTestDiffY", "", 500, posEle.Y() - 10., posEle.Y() + 10.);
+  TH1D hTestDiffZ("hTestDiffZ", "", 500, posEle.Z() - 10., posEle.Z() + 10.);
+
+  TF1 gausX("gausX", "gaus");
+  TF1 gausY("gausY", "gaus");
+  TF1 gausZ("gausZ", "gaus");
+
+  static ElectronTransport& electronTransport = ElectronTransport::instance();
+  DriftedElectrons electrons;
+  electronTransport.getElectronDrift(posEle, 500001, electrons);
+  BOOST_CHECK_EQUAL(electrons.size, 500001);
+
+  for (size_t i = 0; i < electrons.size; ++i) {
+    hTestDiffX.Fill(electrons.x[i]);
+    hTestDiffY.Fill(electrons.y[i]);
+    hTestDiffZ.Fill(electrons.z[i]);
+    BOOST_CHECK_CLOSE(electrons.driftTime[i], electronTransport.getDriftTime(electrons.z[i]), 1E-3);
+  }
+
+  hTestDiffX.Fit("gausX", "Q0");
+  hTestDiffY.Fit("gausY", "Q0");
+  hTestDiffZ.Fit("gausZ", "Q0");
+
+  // check whether the mean of the gaussian fit matches the starting point
+  BOOST_CHECK_CLOSE(gausX.GetParameter(1), posEle.X(), 0.5);
+  BOOST_CHECK_CLOSE(gausY.GetParameter(1), posEle.Y(), 0.5);
+  BOOST_CHECK_CLOSE(gausZ.GetParameter(1), posEle.Z(), 0.5);
+
+  // check whether the width of the distribution matches the expected one
+  const float sigT = std::sqrt(detParam.TPClength - posEle.Z()) * gasParam.DiffT;
+  const float sigL = std::sqrt(detParam.TPClength - posEle.Z()) * gasParam.DiffL;
+
+  BOOST_CHECK_CLOSE(gausX.GetParameter(2), sigT, 0.5);
+  BOOST_CHECK_CLOSE(gausY.GetParameter(2), sigT, 0.5);
+  BOOST_CHECK_CLOSE(gausZ.GetParameter(2), sigL, 0.5);
+}
+
 /// \brief Test of the isElectronAttachment function
 /// We let the electrons drift for 100 us and compare the fraction
 /// of lost electrons to the expected value
@@ -67,6 +67,51 @@ struct TrackDeriv {
   }
 };
 
+///__________________________________________________________________________
+///< SoA container of the tracks parameters used for the batch pre-selection of 2-prong candidates:
+///  the circle parameters are calculated once per track rather than once per tested pair
+struct TrackBatchSoA {
+  std::vector<o2::track::TrackAuxPar> aux;     // circle and alpha parameters
+  std::vector<const o2::track::TrackPar*> trc; // original tracks, must stay alive while the batch is used
+  std::vector<float> x, z, snp, tgl, crv;      // parameters needed for the propagation to the seed
+
+  int size() const { return trc.size(); }
+
+  void clear()
+  {
+    aux.clear();
+    trc.clear();
+    x.clear();
+    z.clear();
+    snp.clear();
+    tgl.clear();
+    crv.clear();
+  }
+
+  void reserve(size_t n)
+  {
+    aux.reserve(n);
+    trc.reserve(n);
+    x.reserve(n);
+    z.reserve(n);
+    snp.reserve(n);
+    tgl.reserve(n);
+    crv.reserve(n);
+  }
+
+  ///< add track, the bz must be the same as the one of the fitter
+  void add(const o2::track::TrackPar& tr, float bz)
+  {
+    aux.emplace_back(tr, bz);
+    trc.push_back(&tr);
+    x.push_back(tr.getX());
+    z.push_back(tr.getZ());
+    snp.push_back(tr.getSnp());
+    tgl.push_back(tr.getTgl());
+    crv.push_back(tr.getCurvature(bz));
+  }
+};
+
 template <int N, typename... Args>
 class DCAFitterN
 {
@@ -177,6 +222,13 @@ class DCAFitterN
   int process(const Tr&... args);
   void print() const;
 
+  ///< batch pre-selection of 2-prong candidates made of the tracks idA[i] of batchA and idB[i] of batchB:
+  ///  the seeds are obtained as in the process() and both tracks are propagated to them in a vectorizable loop
+  ///  to apply the rough DZ cut. accept[i] is set to 0 only for the pairs for which the process() would find no
+  ///  candidate, so the full fit can be limited to the accepted ones. Returns the number of accepted pairs.
+  int preselectPairs(const TrackBatchSoA& batchA, const TrackBatchSoA& batchB, const int* idA, const int* idB,
+                     int nPairs, std::vector<uint8_t>& accept);
+
  protected:
   bool calcPCACoefs();
   bool calcInverseWeight();
@@ -247,6 +299,19 @@ class DCAFitterN
     pnt[2] = tr.getZ();
   }
 
+  ///< Z of the track propagated by dx in the linear approximation of the propagateTo, flag if the approximation is used and if the propagation is valid
+  static float propagateZLinear(float dx, float z, float f1, float tgl, float crv, bool& lin, bool& valid)
+  {
+    float x2r = crv * dx, f2 = f1 + x2r;
+    float r1 = std::sqrt(std::max(0.f, (1.f - f1) * (1.f + f1))), r2 = std::sqrt(std::max(0.f, (1.f - f2) * (1.f + f2)));
+    valid = std::abs(dx) < o2::constants::math::Almost0 ||
+            (std::abs(f1) <= o2::constants::math::Almost1 && std::abs(f2) <= o2::constants::math::Almost1 &&
+             r1 >= o2::constants::math::Almost0 && r2 >= o2::constants::math::Almost0);
+    lin = std::abs(x2r) < 0.05f;
+    float dy2dx = (f1 + f2) / (r1 + r2);
+    return z + dx * (r2 + f2 * dy2dx) * tgl;
+  }
+
  private:
   // vectors of 1st derivatives of track local residuals over X parameters
   std::array<std::array<Vec3D, N>, N> mDResidDx;
@@ -288,7 +353,16 @@ class DCAFitterN
   float mMaxChi2 = 100;             // abs cut on chi2 or abs distance
   float mMaxDist2ToMergeSeeds = 1.; // merge 2 seeds to their average if their distance^2 is below the threshold
 
-  ClassDefNV(DCAFitterN, 1);
+  // scratch space of the batch pre-selection: seeds of the tested pairs and the prongs parameters for them
+  std::vector<int> mBatchSeedPair;                 //! pair of each seed
+  std::array<std::vector<float>, N> mBatchSeedDX;  //! distance in X from the prong to the seed
+  std::array<std::vector<float>, N> mBatchSeedZ;   //! Z, snp, tgl and curvature of the prong
+  std::array<std::vector<float>, N> mBatchSeedSnp; //!
+  std::array<std::vector<float>, N> mBatchSeedTgl; //!
+  std::array<std::vector<float>, N> mBatchSeedCrv; //!
+  std::vector<uint8_t> mBatchSeedOK;               //! seed passes the cuts
+
+  ClassDefNV(DCAFitterN, 2);
 };
 
 ///_________________________________________________________________________
@@ -351,6 +425,88 @@ int DCAFitterN<N, Args...>::process(const Tr&... args)
   return mCurHyp;
 }
 
+///_________________________________________________________________________
+template <int N, typename... Args>
+int DCAFitterN<N, Args...>::preselectPairs(const TrackBatchSoA& batchA, const TrackBatchSoA& batchB, const int* idA, const int* idB,
+                                           int nPairs, std::vector<uint8_t>& accept)
+{
+  if (N != 2) {
+    throw std::runtime_error("batch pre-selection is implemented for 2 prongs only");
+  }
+  accept.clear();
+  accept.resize(nPairs, 0);
+  mBatchSeedPair.clear();
+  for (int i = 0; i < N; i++) {
+    mBatchSeedDX[i].clear();
+    mBatchSeedZ[i].clear();
+    mBatchSeedSnp[i].clear();
+    mBatchSeedTgl[i].clear();
+    mBatchSeedCrv[i].clear();
+  }
+  // seeds from the tracks crossings in XY with the same merging and radius cut as in the process()
+  const std::array<const TrackBatchSoA*, N> batch{&batchA, &batchB};
+  std::array<int, N> ids;
+  CrossInfo crossings;
+  for (int ip = 0; ip < nPairs; ip++) {
+    ids[0] = idA[ip];
+    ids[1] = idB[ip];
+    const auto &aux0 = batchA.aux[ids[0]], &aux1 = batchB.aux[ids[1]];
+    if (!crossings.set(aux0, *batchA.trc[ids[0]], aux1, *batchB.trc[ids[1]])) {
+      continue;
+    }
+    if (crossings.nDCA == MAXHYP) {
+      auto dst2 = (crossings.xDCA[0] - crossings.xDCA[1]) * (crossings.xDCA[0] - crossings.xDCA[1]) +
+                  (crossings.yDCA[0] - crossings.yDCA[1]) * (crossings.yDCA[0] - crossings.yDCA[1]);
+      if (dst2 < mMaxDist2ToMergeSeeds) {
+        crossings.nDCA = 1;
+        crossings.xDCA[0] = 0.5 * (crossings.xDCA[0] + crossings.xDCA[1]);
+        crossings.yDCA[0] = 0.5 * (crossings.yDCA[0] + crossings.yDCA[1]);
+      }
+    }
+    for (int ic = 0; ic < crossings.nDCA; ic++) {
+      if (crossings.xDCA[ic] * crossings.xDCA[ic] + crossings.yDCA[ic] * crossings.yDCA[ic] > mMaxR2) {
+        continue;
+      }
+      mBatchSeedPair.push_back(ip);
+      double xSeed = crossings.xDCA[ic], ySeed = crossings.yDCA[ic];
+      for (int i = 0; i < N; i++) {
+        const auto& bt = *batch[i];
+        int it = ids[i];
+        float x = bt.aux[it].c * xSeed + bt.aux[it].s * ySeed; // X of the seed in the track frame, as in the minimizeChi2
+        mBatchSeedDX[i].push_back(x - bt.x[it]);
+        mBatchSeedZ[i].push_back(bt.z[it]);
+        mBatchSeedSnp[i].push_back(bt.snp[it]);
+        mBatchSeedTgl[i].push_back(bt.tgl[it]);
+        mBatchSeedCrv[i].push_back(bt.crv[it]);
+      }
+    }
+  }
+
+  // branch-free propagation of both prongs to the seeds and rough DZ cut. The seed is rejected only if the propagation
+  // is impossible or the DZ is certainly above the cut, i.e. when the linear approximation is also used by the
+  // propagateTo and the margin covers the precision difference.
+  const int nSeeds = mBatchSeedPair.size();
+  mBatchSeedOK.resize(nSeeds);
+  const float maxDZ = mMaxDZIni > 0 ? mMaxDZIni + 1e-3f : o2::constants::math::VeryBig;
+  const float *dx0 = mBatchSeedDX[0].data(), *z0 = mBatchSeedZ[0].data(), *snp0 = mBatchSeedSnp[0].data(), *tgl0 = mBatchSeedTgl[0].data(), *crv0 = mBatchSeedCrv[0].data();
+  const float *dx1 = mBatchSeedDX[1].data(), *z1 = mBatchSeedZ[1].data(), *snp1 = mBatchSeedSnp[1].data(), *tgl1 = mBatchSeedTgl[1].data(), *crv1 = mBatchSeedCrv[1].data();
+  uint8_t* seedOK = mBatchSeedOK.data();
+  for (int is = 0; is < nSeeds; is++) {
+    bool lin0, lin1, valid0, valid1;
+    float zs0 = propagateZLinear(dx0[is], z0[is], snp0[is], tgl0[is], crv0[is], lin0, valid0);
+    float zs1 = propagateZLinear(dx1[is], z1[is], snp1[is], tgl1[is], crv1[is], lin1, valid1);
+    bool farDZ = lin0 & lin1 & (std::abs(zs0 - zs1) > maxDZ);
+    seedOK[is] = valid0 & valid1 & !farDZ;
+  }
+  int nAcc = 0;
+  for (int is = 0; is < nSeeds; is++) {
+    auto& acc = accept[mBatchSeedPair[is]];
+    nAcc += seedOK[is] & !acc;
+    acc |= seedOK[is];
+  }
+  return nAcc;
+}
+
 //__________________________________________________________________________
 template <int N, typename... Args>
 bool DCAFitterN<N, Args...>::calcPCACoefs()
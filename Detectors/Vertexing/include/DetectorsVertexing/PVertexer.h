@@ -80,6 +80,8 @@ class PVertexer
   void setBz(float bz) { mBz = bz; }
   void setValidateWithIR(bool v) { mValidateWithIR = v; }
   bool getValidateWithIR() const { return mValidateWithIR; }
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
 
   auto& getTracksPool() const { return mTracksPool; }
   auto& getTimeZClusters() const { return mTimeZClusters; }
@@ -101,8 +103,10 @@ class PVertexer
  private:
   static constexpr int DBS_UNDEF = -2, DBS_NOISE = -1, DBS_INCHECK = -10;
 
-  FitStatus fitIteration(const VertexingInput& input, VertexSeed& vtxSeed);
-  void accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const;
+  bool findVertex(const VertexingInput& input, PVertex& vtx, VertexingWorkspace& ws);
+  FitStatus fitIteration(VertexSeed& vtxSeed, VertexingWorkspace& ws) const;
+  void evalWeights(const VertexSeed& vtxSeed, VertexingWorkspace& ws) const;
+  void accountTrack(int itr, const VertexingWorkspace& ws, VertexSeed& vtxSeed) const;
   bool solveVertex(VertexSeed& vtxSeed) const;
   FitStatus evalIterations(VertexSeed& vtxSeed, PVertex& vtx) const;
   TimeEst timeEstimate(const VertexingInput& input) const;
@@ -114,7 +118,7 @@ class PVertexer
   template <typename TR>
   void createTracksPool(const TR& tracks, gsl::span<const o2d::GlobalTrackID> gids);
 
-  int findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
+  int findVertices(const VertexingInput& input, VertexingWorkspace& ws);
 
   std::pair<int, int> getBestIR(const PVertex& vtx, const gsl::span<o2::InteractionRecord> bcData, int& currEntry) const;
 
@@ -133,9 +137,11 @@ class PVertexer
   std::vector<int> mSortedTrackID;         ///< indices of tracks sorted in time
   std::vector<TimeZCluster> mTimeZClusters; ///< set of time clusters
   std::vector<int> mClusterTrackIDs;        ///< IDs of tracks making the clusters
+  std::vector<VertexingWorkspace> mWorkspaces; ///< per-thread workspaces for the clusters processing
 
   float mBz = 0.;                          ///< mag.field at beam line
   bool mValidateWithIR = false;            ///< require vertex validation with InteractionRecords (if available)
+  int mNThreads = 1;                       ///< number of threads to process the time-Z clusters
 
   o2::InteractionRecord mStartIR{0, 0}; ///< IR corresponding to the start of the TF
 
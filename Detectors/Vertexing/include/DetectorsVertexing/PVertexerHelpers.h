@@ -21,6 +21,7 @@
 #include "ReconstructionDataFormats/VtxTrackIndex.h"
 #include "ReconstructionDataFormats/VtxTrackRef.h"
 #include "CommonDataFormat/TimeStamp.h"
+#include <vector>
 
 namespace o2
 {
@@ -170,6 +171,54 @@ struct VertexingInput {
   bool fillErrors = true;
 };
 
+///< per-thread workspace for vertex finding in the time-Z cluster: structure-of-arrays copy of the
+///< tracks used in the current fit, so that their weights can be evaluated in a vectorized loop, and the found vertices
+struct VertexingWorkspace {
+  std::vector<int> poolIDs; // tracks pool IDs of the fit tracks
+  std::vector<float> x, y, z, sig2YI, sig2ZI, sigYZI, tgP, tgL, cosAlp, sinAlp, time, timeErr2I;
+  std::vector<float> chi2, wgh; // chi2 and weight of the track wrt current vertex seed
+
+  std::vector<PVertex> vertices;  // vertices found by this thread
+  std::vector<uint32_t> trackIDs; // contributors of the vertices
+  std::vector<V2TRef> v2tRefs;    // references from the vertices to their contributors
+
+  int getNTracks() const { return poolIDs.size(); }
+
+  void clearTracks()
+  {
+    for (auto* v : {&x, &y, &z, &sig2YI, &sig2ZI, &sigYZI, &tgP, &tgL, &cosAlp, &sinAlp, &time, &timeErr2I, &chi2, &wgh}) {
+      v->clear();
+    }
+    poolIDs.clear();
+  }
+
+  void addTrack(const TrackVF& trc, int poolID)
+  {
+    poolIDs.push_back(poolID);
+    x.push_back(trc.x);
+    y.push_back(trc.y);
+    z.push_back(trc.z);
+    sig2YI.push_back(trc.sig2YI);
+    sig2ZI.push_back(trc.sig2ZI);
+    sigYZI.push_back(trc.sigYZI);
+    tgP.push_back(trc.tgP);
+    tgL.push_back(trc.tgL);
+    cosAlp.push_back(trc.cosAlp);
+    sinAlp.push_back(trc.sinAlp);
+    time.push_back(trc.timeEst.getTimeStamp());
+    timeErr2I.push_back(1. / (trc.timeEst.getTimeStampError() * trc.timeEst.getTimeStampError()));
+    chi2.push_back(0.f);
+    wgh.push_back(0.f);
+  }
+
+  void clearVertices()
+  {
+    vertices.clear();
+    trackIDs.clear();
+    v2tRefs.clear();
+  }
+};
+
 struct SeedHisto {
   float range = 20;
   float binSize = 0.5;
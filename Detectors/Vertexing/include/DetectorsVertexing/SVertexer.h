@@ -86,6 +86,7 @@ class SVertexer
   int checkCascades(float r2v0, float p2v0, int avoidTrackID, int posneg, int ithread);
   void setupThreads();
   void buildT2V(const gsl::span<const GIndex>& trackIndex, const gsl::span<const VRef>& vtxRefs, const o2::globaltracking::RecoContainer& recoTracks);
+  void buildTracksBatch();
   void updateTimeDependentParams();
 
   uint64_t getPairIdx(GIndex id1, GIndex id2) const
@@ -103,6 +104,15 @@ class SVertexer
   std::array<SVertexHypothesis, NHypV0> mV0Hyps;
   std::array<SVertexHypothesis, NHypCascade> mCascHyps;
 
+  struct PairBatch { // per-thread buffers of the V0 candidates pre-selection
+    std::vector<int> idP, idN;
+    std::vector<uint8_t> accept;
+    size_t nTested = 0;
+    size_t nAccepted = 0;
+  };
+  std::array<TrackBatchSoA, 2> mTracksBatch{}; // SoA copies of the tracks pools for the batch pre-selection
+  std::vector<PairBatch> mPairBatch;
+
   std::vector<DCAFitterN<2>> mFitterV0;
   std::vector<DCAFitterN<2>> mFitterCasc;
   int mNThreads = 1;
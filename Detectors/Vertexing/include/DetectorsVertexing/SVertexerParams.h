@@ -34,6 +34,7 @@ struct SVertexerParams : public o2::conf::ConfigurableParamHelper<SVertexerParam
   float maxDZIni = 5.;          ///< don't consider as a seed (circles intersection) if Z distance exceeds this
   float maxRIni = 150;          ///< don't consider as a seed (circles intersection) if its R exceeds this
   bool useAbsDCA = true; ///< use abs dca minimization
+  bool batchPreselect = true; ///< pre-select V0 candidates in batches before the full fit
   //
   float minRToMeanVertex = 0.5;           ///< min radial distance of V0 from beam line (mean vertex)
   float maxDCAXYToMeanVertex = 0.2;       ///< max DCA of V0 from beam line (mean vertex) for prompt V0 candidates
@@ -19,6 +19,10 @@
 #include <unordered_map>
 #include <TStopwatch.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 using namespace o2::vertexing;
 
 constexpr float PVertexer::kAlmost0F;
@@ -37,13 +41,42 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
 
-  for (auto tc : mTimeZClusters) {
+  // time-Z clusters have no tracks in common and are processed independently, each thread collecting
+  // the vertices in its own workspace
+  int nClusters = mTimeZClusters.size(), nThreads = std::max(1, std::min(mNThreads, nClusters));
+  mWorkspaces.resize(nThreads);
+  for (auto& ws : mWorkspaces) {
+    ws.clearVertices();
+  }
+  std::vector<std::array<int, 3>> clusVertices(nClusters); // thread, first vertex and number of vertices of each cluster
+  float scaleSigma2 = 3. * estimateScale2();
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int ic = 0; ic < nClusters; ic++) {
+    const auto& tc = mTimeZClusters[ic];
+    int iThread = 0;
+#ifdef WITH_OPENMP
+    iThread = omp_get_thread_num();
+#endif
+    auto& ws = mWorkspaces[iThread];
     VertexingInput inp;
     //    inp.idRange = gsl::span<int>((int*)&mSortedTrackID[tc.first], tc.count);
     inp.idRange = gsl::span<int>((int*)&mClusterTrackIDs[tc.first], tc.count);
-    inp.scaleSigma2 = 3. * estimateScale2();
+    inp.scaleSigma2 = scaleSigma2;
     inp.timeEst = tc.timeEst;
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
+    int first = ws.vertices.size();
+    clusVertices[ic] = {iThread, first, findVertices(inp, ws)};
+  }
+  // merge in the order of clusters, as if they were processed sequentially
+  for (const auto& [iThread, first, nv] : clusVertices) {
+    const auto& ws = mWorkspaces[iThread];
+    for (int iv = first; iv < first + nv; iv++) {
+      const auto& ref = ws.v2tRefs[iv];
+      verticesLoc.push_back(ws.vertices[iv]);
+      v2tRefsLoc.emplace_back(trackIDs.size(), ref.getEntries());
+      trackIDs.insert(trackIDs.end(), ws.trackIDs.begin() + ref.getFirstEntry(), ws.trackIDs.begin() + ref.getFirstEntry() + ref.getEntries());
+    }
   }
 
   // sort in time
@@ -103,11 +136,11 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
 }
 
 //______________________________________________
-int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs)
+int PVertexer::findVertices(const VertexingInput& input, VertexingWorkspace& ws)
 {
   // find vertices using tracks with indices (sorted in time) from idRange from "tracks" pool. The pool may containt arbitrary number of tracks,
   // only those which are in the idRange and have canUse()==true, will be used.
-  // Results are placed in vertices and v2tRefs vectors
+  // Results are placed in vertices and v2tRefs vectors of the workspace
   int nfound = 0, ntr = input.idRange.size();
   if (ntr < mPVParams->minTracksPerVtx) {
     return nfound;
@@ -136,8 +169,8 @@ int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& v
     PVertex vtx;
     vtx.setXYZ(mMeanVertex.getX(), mMeanVertex.getY(), zv);
     vtx.setTimeStamp(input.timeEst);
-    if (findVertex(input, vtx)) {
-      finalizeVertex(input, vtx, vertices, v2tRefs, trackIDs, seedHisto);
+    if (findVertex(input, vtx, ws)) {
+      finalizeVertex(input, vtx, ws.vertices, ws.v2tRefs, ws.trackIDs, seedHisto);
       nfound++;
       nTrials = 0;
     } else {                                                                    // suppress failed seeding bin and its proximities
@@ -157,11 +190,24 @@ int PVertexer::findVertices(const VertexingInput& input, std::vector<PVertex>& v
 
 //______________________________________________
 bool PVertexer::findVertex(const VertexingInput& input, PVertex& vtx)
+{
+  VertexingWorkspace ws;
+  return findVertex(input, vtx, ws);
+}
+
+//______________________________________________
+bool PVertexer::findVertex(const VertexingInput& input, PVertex& vtx, VertexingWorkspace& ws)
 {
   // fit vertex taking provided vertex as a seed
   // tracks pool may contain arbitrary number of tracks, only those which are in
   // the idRange (indices of tracks sorted in time) will be used.
 
+  ws.clearTracks();
+  for (int i : input.idRange) {
+    if (mTracksPool[i].canUse()) {
+      ws.addTrack(mTracksPool[i], i);
+    }
+  }
   VertexSeed vtxSeed(vtx, input.useConstraint, input.fillErrors);
   vtxSeed.setScale(input.scaleSigma2, mTukey2I);
   vtxSeed.scaleSigma2Prev = input.scaleSigma2;
@@ -175,7 +221,7 @@ bool PVertexer::findVertex(const VertexingInput& input, PVertex& vtx)
     vtxSeed.resetForNewIteration();
     vtxSeed.nIterations++;
     LOG(DEBUG) << "iter " << vtxSeed.nIterations << " with scale=" << vtxSeed.scaleSigma2 << " prevScale=" << vtxSeed.scaleSigma2Prev;
-    result = fitIteration(input, vtxSeed);
+    result = fitIteration(vtxSeed, ws);
 
     if (result == FitStatus::OK) {
       result = evalIterations(vtxSeed, vtx);
@@ -194,6 +240,9 @@ bool PVertexer::findVertex(const VertexingInput& input, PVertex& vtx)
     }
   }
   LOG(DEBUG) << "Stopped with scale=" << vtxSeed.scaleSigma2 << " prevScale=" << vtxSeed.scaleSigma2Prev << " result = " << int(result);
+  for (int i = ws.getNTracks(); i--;) {
+    mTracksPool[ws.poolIDs[i]].wgh = ws.wgh[i]; // weights wrt the last iteration define the tracks to assign
+  }
 
   if (result != FitStatus::OK) {
     vtx.setChi2(vtxSeed.maxScaleSigma2Tested);
@@ -204,13 +253,13 @@ bool PVertexer::findVertex(const VertexingInput& input, PVertex& vtx)
 }
 
 //___________________________________________________________________
-PVertexer::FitStatus PVertexer::fitIteration(const VertexingInput& input, VertexSeed& vtxSeed)
+PVertexer::FitStatus PVertexer::fitIteration(VertexSeed& vtxSeed, VertexingWorkspace& ws) const
 {
-  int nTested = 0;
-  for (int i : input.idRange) {
-    if (mTracksPool[i].canUse()) {
-      nTested++;
-      accountTrack(mTracksPool[i], vtxSeed);
+  int nTested = ws.getNTracks();
+  evalWeights(vtxSeed, ws);
+  for (int i = 0; i < nTested; i++) {
+    if (ws.wgh[i] > 0.f) {
+      accountTrack(i, ws, vtxSeed);
     }
   }
   vtxSeed.maxScaleSigma2Tested = vtxSeed.scaleSigma2;
@@ -227,31 +276,37 @@ PVertexer::FitStatus PVertexer::fitIteration(const VertexingInput& input, Vertex
 }
 
 //___________________________________________________________________
-void PVertexer::accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const
+void PVertexer::evalWeights(const VertexSeed& vtxSeed, VertexingWorkspace& ws) const
 {
-  // deltas defined as track - vertex
-  float dt, trErr2I = 0, dy, dz, chi2T = trc.getResiduals(vtxSeed, dy, dz); // track-vertex residuals and chi2
-  auto& timeV = vtxSeed.getTimeStamp();
-  auto& timeT = trc.timeEst;
-  float ndff = 1. / 2;
-  bool noTime = false;
-  if (timeV.getTimeStampError() < 0.) {
-    noTime = true;
-  } else {
-    dt = timeT.getTimeStamp() - timeV.getTimeStamp();
-    trErr2I = 1. / (timeT.getTimeStampError() * timeT.getTimeStampError());
-    if (mPVParams->useTimeInChi2) {
-      chi2T += dt * dt * trErr2I;
-      ndff = 1. / 3.;
-    }
+  // chi2 and Tukey weights of all fit tracks wrt the current vertex, written branch-free to be vectorized
+  const float vx = vtxSeed.getX(), vy = vtxSeed.getY(), vz = vtxSeed.getZ(), vt = vtxSeed.getTimeStamp().getTimeStamp();
+  const bool useTime = mPVParams->useTimeInChi2 && vtxSeed.getTimeStamp().getTimeStampError() >= 0.;
+  const float ndff = useTime ? 1.f / 3.f : 1.f / 2.f, scale = vtxSeed.scaleSig2ITuk2I;
+  const float *x = ws.x.data(), *y = ws.y.data(), *z = ws.z.data(), *sig2YI = ws.sig2YI.data(), *sig2ZI = ws.sig2ZI.data(), *sigYZI = ws.sigYZI.data();
+  const float *tgP = ws.tgP.data(), *tgL = ws.tgL.data(), *cosAlp = ws.cosAlp.data(), *sinAlp = ws.sinAlp.data(), *time = ws.time.data(), *timeErr2I = ws.timeErr2I.data();
+  float *chi2 = ws.chi2.data(), *wgh = ws.wgh.data();
+  int ntr = ws.getNTracks();
+  for (int i = 0; i < ntr; i++) {
+    // deltas defined as track - vertex
+    float dx = vx * cosAlp[i] + vy * sinAlp[i] - x[i]; // VX rotated to track frame - trackX
+    float dy = y[i] + tgP[i] * dx - (-vx * sinAlp[i] + vy * cosAlp[i]);
+    float dz = z[i] + tgL[i] * dx - vz;
+    float dt = time[i] - vt;
+    float chi2Time = useTime ? dt * dt * timeErr2I[i] : 0.f;
+    float chi2T = (dy * dy * sig2YI[i] + dz * dz * sig2ZI[i] + 2.f * dy * dz * sigYZI[i] + chi2Time) * ndff;
+    float wghT = 1.f - chi2T * scale; // weighted distance to vertex
+    chi2[i] = chi2T;
+    wgh[i] = wghT < kAlmost0F ? 0.f : wghT;
   }
-  chi2T *= ndff;
-  float wghT = (1.f - chi2T * vtxSeed.scaleSig2ITuk2I); // weighted distance to vertex
-  if (wghT < kAlmost0F) {
-    trc.wgh = 0.f;
-    return;
-  }
-  float syyI(trc.sig2YI), szzI(trc.sig2ZI), syzI(trc.sigYZI);
+}
+
+//___________________________________________________________________
+void PVertexer::accountTrack(int itr, const VertexingWorkspace& ws, VertexSeed& vtxSeed) const
+{
+  // account in the vertex fit the track with the weight evaluated by evalWeights
+  float wghT = ws.wgh[itr], chi2T = ws.chi2[itr];
+  float syyI(ws.sig2YI[itr]), szzI(ws.sig2ZI[itr]), syzI(ws.sigYZI[itr]);
+  float cosAlp = ws.cosAlp[itr], sinAlp = ws.sinAlp[itr], tgP = ws.tgP[itr], tgL = ws.tgL[itr], x = ws.x[itr];
 
   //
   vtxSeed.wghSum += wghT;
@@ -260,13 +315,12 @@ void PVertexer::accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const
   syyI *= wghT;
   syzI *= wghT;
   szzI *= wghT;
-  trc.wgh = wghT;
   //
   // aux variables
-  double tmpSP = trc.sinAlp * trc.tgP, tmpCP = trc.cosAlp * trc.tgP,
-         tmpSC = trc.sinAlp + tmpCP, tmpCS = -trc.cosAlp + tmpSP,
-         tmpCL = trc.cosAlp * trc.tgL, tmpSL = trc.sinAlp * trc.tgL,
-         tmpYXP = trc.y - trc.tgP * trc.x, tmpZXL = trc.z - trc.tgL * trc.x,
+  double tmpSP = sinAlp * tgP, tmpCP = cosAlp * tgP,
+         tmpSC = sinAlp + tmpCP, tmpCS = -cosAlp + tmpSP,
+         tmpCL = cosAlp * tgL, tmpSL = sinAlp * tgL,
+         tmpYXP = ws.y[itr] - tgP * x, tmpZXL = ws.z[itr] - tgL * x,
          tmpCLzz = tmpCL * szzI, tmpSLzz = tmpSL * szzI, tmpSCyz = tmpSC * syzI,
          tmpCSyz = tmpCS * syzI, tmpCSyy = tmpCS * syyI, tmpSCyy = tmpSC * syyI,
          tmpSLyz = tmpSL * syzI, tmpCLyz = tmpCL * syzI;
@@ -274,7 +328,7 @@ void PVertexer::accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const
   // symmetric matrix equation
   vtxSeed.cxx += tmpCL * (tmpCLzz + tmpSCyz + tmpSCyz) + tmpSC * tmpSCyy;         // dchi^2/dx/dx
   vtxSeed.cxy += tmpCL * (tmpSLzz + tmpCSyz) + tmpSL * tmpSCyz + tmpSC * tmpCSyy; // dchi^2/dx/dy
-  vtxSeed.cxz += -trc.sinAlp * syzI - tmpCLzz - tmpCP * syzI;                     // dchi^2/dx/dz
+  vtxSeed.cxz += -sinAlp * syzI - tmpCLzz - tmpCP * syzI;                         // dchi^2/dx/dz
   vtxSeed.cx0 += -(tmpCLyz + tmpSCyy) * tmpYXP - (tmpCLzz + tmpSCyz) * tmpZXL;    // RHS
   //
   vtxSeed.cyy += tmpSL * (tmpSLzz + tmpCSyz + tmpCSyz) + tmpCS * tmpCSyy;      // dchi^2/dy/dy
@@ -284,9 +338,9 @@ void PVertexer::accountTrack(TrackVF& trc, VertexSeed& vtxSeed) const
   vtxSeed.czz += szzI;                          // dchi^2/dz/dz
   vtxSeed.cz0 += tmpZXL * szzI + tmpYXP * syzI; // RHS
   //
-  if (!noTime) {
-    trErr2I *= wghT;
-    vtxSeed.tMeanAcc += timeT.getTimeStamp() * trErr2I;
+  if (vtxSeed.getTimeStamp().getTimeStampError() >= 0.) {
+    float trErr2I = ws.timeErr2I[itr] * wghT;
+    vtxSeed.tMeanAcc += ws.time[itr] * trErr2I;
     vtxSeed.tMeanAccErr += trErr2I;
   }
   vtxSeed.addContributor();
@@ -418,6 +472,16 @@ TimeEst PVertexer::timeEstimate(const VertexingInput& input) const
   return {t, te2};
 }
 
+//___________________________________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //___________________________________________________________________
 void PVertexer::init()
 {
@@ -17,6 +17,7 @@
 #include "ReconstructionDataFormats/TrackTPCITS.h"
 #include "DataFormatsTPC/TrackTPC.h"
 #include "DataFormatsITS/TrackITS.h"
+#include <numeric>
 
 #ifdef WITH_OPENMP
 #include <omp.h>
@@ -42,25 +43,52 @@ void SVertexer::process(const gsl::span<const PVertex>& vertices,           // p
   int ntrP = mTracksPool[POS].size(), ntrN = mTracksPool[NEG].size(), iThread = 0;
   mV0sTmp[0].clear();
   mCascadesTmp[0].clear();
+  bool preselect = mSVParams->batchPreselect;
+  if (preselect) {
+    buildTracksBatch();
+  }
+  for (auto& pb : mPairBatch) {
+    pb.nTested = pb.nAccepted = 0;
+  }
 
 #ifdef WITH_OPENMP
   omp_set_num_threads(mNThreads);
   int dynGrp = std::min(4, std::max(1, mNThreads / 2));
-#pragma omp parallel for schedule(dynamic, dynGrp)
+#pragma omp parallel for schedule(dynamic, dynGrp) firstprivate(iThread)
 #endif
   for (int itp = 0; itp < ntrP; itp++) {
-    auto& seedP = mTracksPool[POS][itp];
-    for (int itn = mVtxFirstTrack[NEG][seedP.vBracket.getMin()]; itn < ntrN; itn++) { // start from the 1st negative track of lowest-ID vertex of positive
-      auto& seedN = mTracksPool[NEG][itn];
-      if (seedN.vBracket > seedP.vBracket) { // all vertices compatible with seedN are in future wrt that of seedP
-        break;
-      }
 #ifdef WITH_OPENMP
-      iThread = omp_get_thread_num();
+    iThread = omp_get_thread_num();
 #endif
-      checkV0(seedP, seedN, itp, itn, iThread);
+    auto& seedP = mTracksPool[POS][itp];
+    int itnFirst = mVtxFirstTrack[NEG][seedP.vBracket.getMin()], itnLast = itnFirst; // start from the 1st negative track of lowest-ID vertex of positive
+    while (itnLast < ntrN && !(mTracksPool[NEG][itnLast].vBracket > seedP.vBracket)) { // stop at the negative compatible only with the future vertices
+      itnLast++;
+    }
+    auto& pairBatch = mPairBatch[iThread];
+    if (preselect) { // discard in one go the pairs which certainly fail the seed cuts of the fitter
+      int nPairs = itnLast - itnFirst;
+      pairBatch.idP.assign(nPairs, itp);
+      pairBatch.idN.resize(nPairs);
+      std::iota(pairBatch.idN.begin(), pairBatch.idN.end(), itnFirst);
+      pairBatch.nTested += nPairs;
+      pairBatch.nAccepted += mFitterV0[iThread].preselectPairs(mTracksBatch[POS], mTracksBatch[NEG], pairBatch.idP.data(), pairBatch.idN.data(), nPairs, pairBatch.accept);
+    }
+    for (int itn = itnFirst; itn < itnLast; itn++) {
+      if (preselect && !pairBatch.accept[itn - itnFirst]) {
+        continue;
+      }
+      checkV0(seedP, mTracksPool[NEG][itn], itp, itn, iThread);
     }
   }
+  if (preselect) {
+    size_t nTested = 0, nAccepted = 0;
+    for (const auto& pb : mPairBatch) {
+      nTested += pb.nTested;
+      nAccepted += pb.nAccepted;
+    }
+    LOG(INFO) << "V0 pre-selection accepted " << nAccepted << " of " << nTested << " pairs for the fit";
+  }
 #ifdef WITH_OPENMP
   for (int i = 1; i < mNThreads; i++) { // merge results of all threads
     for (auto& casc : mCascadesTmp[i]) { // before merging fix cascades references on v0
@@ -123,6 +151,7 @@ void SVertexer::setupThreads()
   mV0sTmp.resize(mNThreads);
   mCascadesTmp.resize(mNThreads);
   mFitterV0.resize(mNThreads);
+  mPairBatch.resize(mNThreads);
   auto bz = o2::base::Propagator::Instance()->getNominalBz();
   for (auto& fitter : mFitterV0) {
     fitter.setBz(bz);
@@ -207,6 +236,21 @@ void SVertexer::buildT2V(const gsl::span<const GIndex>& trackIndex,           //
   LOG(INFO) << "Collected " << mTracksPool[POS].size() << " positive and " << mTracksPool[NEG].size() << " negative seeds";
 }
 
+//__________________________________________________________________
+void SVertexer::buildTracksBatch()
+{
+  // SoA copy of the tracks pools parameters for the batch pre-selection of the V0 candidates
+  auto bz = mFitterV0[0].getBz();
+  for (int pn = 0; pn < 2; pn++) {
+    auto& batch = mTracksBatch[pn];
+    batch.clear();
+    batch.reserve(mTracksPool[pn].size());
+    for (const auto& trc : mTracksPool[pn]) {
+      batch.add(trc, bz);
+    }
+  }
+}
+
 //__________________________________________________________________
 bool SVertexer::checkV0(TrackCand& seedP, TrackCand& seedN, int iP, int iN, int ithread)
 {
@@ -385,5 +385,82 @@ BOOST_AUTO_TEST_CASE(DCAFitterNProngs)
   outStream.Close();
 }
 
+BOOST_AUTO_TEST_CASE(DCAFitterBatchPreselection)
+{
+  // combinatorial pairing of the prongs of many decays, as in the V0 finding: the batch pre-selection
+  // must not lose any pair for which the fit finds a candidate
+  constexpr int NDecays = 400;
+  TGenPhaseSpace genPHS;
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  std::vector<double> k0dec = {pion, pion};
+  std::vector<int> forceQ{1, 1};
+  std::vector<o2::track::TrackParCov> vctracks, tracksP, tracksN;
+  Vec3D vtxGen;
+  double bz = 5.0;
+  for (int iev = 0; iev < NDecays; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, k0, k0dec, forceQ);
+    float dz = (gRandom->Rndm() - 0.5) * 20.; // spread the decays in Z as in the collisions of the time frame
+    for (auto& trc : vctracks) {
+      trc.setZ(trc.getZ() + dz);
+    }
+    tracksP.push_back(vctracks[0]);
+    tracksN.push_back(vctracks[1]);
+  }
+
+  o2::vertexing::DCAFitterN<2> ft;
+  ft.setBz(bz);
+  ft.setPropagateToPCA(false);
+  ft.setMaxR(150);
+  ft.setMaxDZIni(5);
+  ft.setUseAbsDCA(true);
+
+  TrackBatchSoA batchP, batchN;
+  for (const auto& trc : tracksP) {
+    batchP.add(trc, ft.getBz());
+  }
+  for (const auto& trc : tracksN) {
+    batchN.add(trc, ft.getBz());
+  }
+  int nPairs = NDecays * NDecays;
+  std::vector<int> idP(nPairs), idN(nPairs);
+  for (int ip = 0; ip < nPairs; ip++) {
+    idP[ip] = ip / NDecays;
+    idN[ip] = ip % NDecays;
+  }
+
+  // every pair is fitted
+  TStopwatch swAll;
+  std::vector<int> nCandAll(nPairs);
+  for (int ip = 0; ip < nPairs; ip++) {
+    nCandAll[ip] = ft.process(tracksP[idP[ip]], tracksN[idN[ip]]);
+  }
+  swAll.Stop();
+
+  // only the pre-selected pairs are fitted
+  TStopwatch swBatch;
+  std::vector<uint8_t> accept;
+  int nAcc = ft.preselectPairs(batchP, batchN, idP.data(), idN.data(), nPairs, accept);
+  std::vector<int> nCandBatch(nPairs);
+  for (int ip = 0; ip < nPairs; ip++) {
+    if (accept[ip]) {
+      nCandBatch[ip] = ft.process(tracksP[idP[ip]], tracksN[idN[ip]]);
+    }
+  }
+  swBatch.Stop();
+
+  int nFound = 0, nLost = 0;
+  for (int ip = 0; ip < nPairs; ip++) {
+    nFound += nCandAll[ip] > 0;
+    nLost += nCandAll[ip] != nCandBatch[ip];
+  }
+  double tAll = swAll.CpuTime(), tBatch = swBatch.CpuTime();
+  LOG(INFO) << "Batch pre-selection accepted " << nAcc << " of " << nPairs << " pairs, " << nFound << " with candidates";
+  LOG(INFO) << "Fit of all pairs: " << (tAll > 0. ? nPairs / tAll : -1) << " candidates/s, with pre-selection: "
+            << (tBatch > 0. ? nPairs / tBatch : -1) << " candidates/s";
+  BOOST_CHECK(nLost == 0);
+  BOOST_CHECK(nAcc < nPairs);
+}
+
 } // namespace vertexing
 } // namespace o2
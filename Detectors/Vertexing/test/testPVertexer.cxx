@@ -0,0 +1,120 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test PVertexer class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DetectorsVertexing/PVertexer.h"
+#include "DetectorsBase/Propagator.h"
+#include "Field/MagneticField.h"
+#include <TGeoGlobalMagField.h>
+#include <TGeoManager.h>
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace vertexing
+{
+
+using GTrackID = o2d::GlobalTrackID;
+
+struct VertexingResult {
+  std::vector<PVertex> vertices;
+  std::vector<o2d::VtxTrackIndex> vertexTrackIDs;
+  std::vector<V2TRef> v2tRefs;
+};
+
+// tracks from collisions well separated in time, so that each one makes its own time-Z cluster, plus some outliers
+void generateTracks(std::vector<TrackWithTimeStamp>& tracks, std::vector<GTrackID>& gids)
+{
+  std::mt19937 gen(2021);
+  std::uniform_real_distribution<float> flat(-1.f, 1.f);
+  std::normal_distribution<float> gaus(0.f, 1.f);
+  const float sigYZ = 0.01f, sigT = 0.1f;
+  std::array<float, 15> cov{sigYZ * sigYZ, 0., sigYZ * sigYZ, 0., 0., 1e-6, 0., 0., 0., 1e-6, 0., 0., 0., 0., 1e-4};
+  for (int icoll = 0; icoll < 16; icoll++) {
+    float tColl = 100.f + 25.f * icoll, zColl = 5.f * flat(gen);
+    int ntr = 5 + 5 * icoll;
+    for (int itr = 0; itr < ntr; itr++) {
+      bool outlier = itr % 10 == 9;
+      std::array<float, 5> par{sigYZ * gaus(gen) + (outlier ? 0.3f * flat(gen) : 0.f), zColl + sigYZ * gaus(gen), 0.2f * flat(gen), flat(gen), 2.f * flat(gen)};
+      TrackWithTimeStamp trc{o2::track::TrackParCov(0.f, 3.14f * flat(gen), par, cov), {tColl + sigT * gaus(gen), sigT}};
+      gids.emplace_back(tracks.size(), GTrackID::ITSTPC);
+      tracks.push_back(trc);
+    }
+  }
+}
+
+VertexingResult runVertexer(int nThreads, const std::vector<TrackWithTimeStamp>& tracks, std::vector<GTrackID> gids)
+{
+  PVertexer vertexer;
+  o2::BunchFilling bunchFilling;
+  bunchFilling.setDefault();
+  vertexer.setBunchFilling(bunchFilling);
+  vertexer.setNThreads(nThreads);
+  vertexer.init();
+
+  VertexingResult res;
+  std::vector<o2::InteractionRecord> bcData;
+  std::vector<o2::MCCompLabel> lblTracks;
+  std::vector<o2::MCEventLabel> lblVtx;
+  vertexer.process(tracks, gids, bcData, res.vertices, res.vertexTrackIDs, res.v2tRefs, lblTracks, lblVtx);
+  return res;
+}
+
+// the vertices found with several threads must be identical to those found with one
+BOOST_AUTO_TEST_CASE(PVertexer_Threads)
+{
+  // the vertexer needs only the field from the propagator
+  if (!TGeoGlobalMagField::Instance()->GetField()) {
+    TGeoGlobalMagField::Instance()->SetField(new o2::field::MagneticField("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG));
+    TGeoGlobalMagField::Instance()->Lock();
+  }
+  if (!gGeoManager) {
+    new TGeoManager("pvertexer", "empty geometry");
+  }
+  o2::base::Propagator::Instance();
+
+  std::vector<TrackWithTimeStamp> tracks;
+  std::vector<GTrackID> gids;
+  generateTracks(tracks, gids);
+
+  auto serial = runVertexer(1, tracks, gids);
+  BOOST_CHECK(serial.vertices.size() > 0);
+  for (int nThreads : {2, 4}) {
+    auto parallel = runVertexer(nThreads, tracks, gids);
+    BOOST_REQUIRE_EQUAL(serial.vertices.size(), parallel.vertices.size());
+    for (size_t iv = 0; iv < serial.vertices.size(); iv++) {
+      const auto &vs = serial.vertices[iv], &vp = parallel.vertices[iv];
+      BOOST_CHECK_EQUAL(vs.getX(), vp.getX());
+      BOOST_CHECK_EQUAL(vs.getY(), vp.getY());
+      BOOST_CHECK_EQUAL(vs.getZ(), vp.getZ());
+      for (int i = 0; i < 6; i++) {
+        BOOST_CHECK_EQUAL(vs.getCov()[i], vp.getCov()[i]);
+      }
+      BOOST_CHECK_EQUAL(vs.getChi2(), vp.getChi2());
+      BOOST_CHECK_EQUAL(vs.getNContributors(), vp.getNContributors());
+      BOOST_CHECK_EQUAL(vs.getTimeStamp().getTimeStamp(), vp.getTimeStamp().getTimeStamp());
+      BOOST_CHECK_EQUAL(vs.getTimeStamp().getTimeStampError(), vp.getTimeStamp().getTimeStampError());
+      BOOST_CHECK_EQUAL(serial.v2tRefs[iv].getFirstEntry(), parallel.v2tRefs[iv].getFirstEntry());
+      BOOST_CHECK_EQUAL(serial.v2tRefs[iv].getEntries(), parallel.v2tRefs[iv].getEntries());
+    }
+    BOOST_REQUIRE_EQUAL(serial.vertexTrackIDs.size(), parallel.vertexTrackIDs.size());
+    for (size_t it = 0; it < serial.vertexTrackIDs.size(); it++) {
+      BOOST_CHECK_EQUAL(serial.vertexTrackIDs[it].getRaw(), parallel.vertexTrackIDs[it].getRaw());
+    }
+  }
+}
+
+} // namespace vertexing
+} // namespace o2
@@ -25,6 +25,7 @@
 #include <arrow/compute/kernel.h>
 #include <arrow/compute/api_aggregate.h>
 #include <gandiva/selection_vector.h>
+#include <gsl/span>
 #include <cassert>
 #include <fmt/format.h>
 #include <typeinfo>
@@ -38,6 +39,15 @@ auto createSchemaFromColumns(framework::pack<C...>)
 }
 using SelectionVector = std::vector<int64_t>;
 
+/// Fill @a result with the sorted union of the sorted selections @a a and @a b.
+/// Dense selections are combined through a row bitmap, sparse ones by merging.
+void unionSelections(SelectionVector const& a, SelectionVector const& b, SelectionVector& result);
+/// Fill @a result with the sorted intersection of the sorted selections @a a and @a b.
+void intersectSelections(SelectionVector const& a, SelectionVector const& b, SelectionVector& result);
+/// Convert a gandiva selection to a SelectionVector in one bulk copy
+/// when the index widths match.
+SelectionVector copySelection(gandiva::SelectionVector const& sel);
+
 template <typename, typename = void>
 constexpr bool is_index_column_v = false;
 
@@ -519,8 +529,9 @@ struct FilteredIndexPolicy : IndexPolicyBase {
   // invalid. What will validate the index is the this->setCursor()
   // which happens below which will properly setup the first index
   // by remapping the filtered index 0 to whatever unfiltered index
-  // it belongs to.
-  FilteredIndexPolicy(SelectionVector selection, uint64_t offset = 0)
+  // it belongs to. The selection is not owned: it is kept alive by the
+  // FilteredPolicy table which created the iterator.
+  FilteredIndexPolicy(gsl::span<int64_t const> selection, uint64_t offset = 0)
     : IndexPolicyBase{-1, offset},
       mSelectedRows(selection),
       mMaxSelection(selection.size())
@@ -605,6 +616,16 @@ struct FilteredIndexPolicy : IndexPolicyBase {
     return mMaxSelection;
   }
 
+  /// Point the policy to a different storage for the selection, keeping
+  /// the current position. Needed when the owning table is copied or its
+  /// selection is recomputed.
+  void resetSelection(gsl::span<int64_t const> selection)
+  {
+    mSelectedRows = selection;
+    mMaxSelection = selection.size();
+    updateRow();
+  }
+
  private:
   inline void updateRow()
   {
@@ -614,7 +635,7 @@ struct FilteredIndexPolicy : IndexPolicyBase {
     //  (mSelectionRow < mMaxSelection ? mSelectedRows[mSelectionRow] : -1)
     //  : mSelectionRow;
   }
-  SelectionVector mSelectedRows;
+  gsl::span<int64_t const> mSelectedRows;
   int64_t mSelectionRow = 0;
   int64_t mMaxSelection = 0;
 };
@@ -1034,7 +1055,7 @@ class Table
     return RowViewSentinel{mEnd};
   }
 
-  filtered_iterator filtered_begin(SelectionVector selection)
+  filtered_iterator filtered_begin(gsl::span<int64_t const> selection)
   {
     // Note that the FilteredIndexPolicy will never outlive the selection which
     // is held by the table, so we are safe passing the bare pointer. If it does it
@@ -1669,6 +1690,29 @@ class FilteredPolicy : public T
     resetRanges();
   }
 
+  FilteredPolicy(FilteredPolicy<T> const& other)
+    : T{static_cast<T const&>(other)},
+      mSelectedRows{other.mSelectedRows},
+      mFilteredBegin{other.mFilteredBegin},
+      mFilteredEnd{other.mFilteredEnd}
+  {
+    mFilteredBegin.resetSelection(mSelectedRows);
+  }
+
+  FilteredPolicy(FilteredPolicy<T>&&) = default;
+
+  FilteredPolicy<T>& operator=(FilteredPolicy<T> const& other)
+  {
+    T::operator=(static_cast<T const&>(other));
+    mSelectedRows = other.mSelectedRows;
+    mFilteredBegin = other.mFilteredBegin;
+    mFilteredEnd = other.mFilteredEnd;
+    mFilteredBegin.resetSelection(mSelectedRows);
+    return *this;
+  }
+
+  FilteredPolicy<T>& operator=(FilteredPolicy<T>&&) = default;
+
   iterator begin()
   {
     return iterator(mFilteredBegin);
@@ -1711,11 +1755,7 @@ class FilteredPolicy : public T
 
   static inline SelectionVector copySelection(framework::expressions::Selection const& sel)
   {
-    SelectionVector rows;
-    for (auto i = 0; i < sel->GetNumSlots(); ++i) {
-      rows.push_back(sel->GetIndex(i));
-    }
-    return rows;
+    return soa::copySelection(*sel);
   }
 
   /// Bind the columns which refer to other tables
@@ -1748,20 +1788,28 @@ class FilteredPolicy : public T
   void sumWithSelection(SelectionVector const& selection)
   {
     SelectionVector rowsUnion;
-    std::set_union(mSelectedRows.begin(), mSelectedRows.end(), selection.begin(), selection.end(), std::back_inserter(rowsUnion));
-    mSelectedRows = rowsUnion;
-    resetRanges();
+    unionSelections(mSelectedRows, selection, rowsUnion);
+    mSelectedRows.swap(rowsUnion);
+    updateSelection();
   }
 
   void intersectWithSelection(SelectionVector const& selection)
   {
     SelectionVector intersection;
-    std::set_intersection(mSelectedRows.begin(), mSelectedRows.end(), selection.begin(), selection.end(), std::back_inserter(intersection));
-    mSelectedRows = intersection;
-    resetRanges();
+    intersectSelections(mSelectedRows, selection, intersection);
+    mSelectedRows.swap(intersection);
+    updateSelection();
   }
 
  private:
+  /// Re-point the cached begin iterator to the new selection. Unlike
+  /// resetRanges() this keeps the external index bindings.
+  void updateSelection()
+  {
+    mFilteredEnd.reset(new RowViewSentinel{mSelectedRows.size()});
+    mFilteredBegin.resetSelection(mSelectedRows);
+  }
+
   void resetRanges()
   {
     mFilteredEnd.reset(new RowViewSentinel{mSelectedRows.size()});
@@ -1802,13 +1850,13 @@ class Filtered : public FilteredPolicy<T>
     return operator+(other.getSelectedRows());
   }
 
-  Filtered<T> operator+=(SelectionVector const& selection)
+  Filtered<T>& operator+=(SelectionVector const& selection)
   {
     this->sumWithSelection(selection);
     return *this;
   }
 
-  Filtered<T> operator+=(Filtered<T> const& other)
+  Filtered<T>& operator+=(Filtered<T> const& other)
   {
     return operator+=(other.getSelectedRows());
   }
@@ -1825,13 +1873,13 @@ class Filtered : public FilteredPolicy<T>
     return operator*(other.getSelectedRows());
   }
 
-  Filtered<T> operator*=(SelectionVector const& selection)
+  Filtered<T>& operator*=(SelectionVector const& selection)
   {
     this->intersectWithSelection(selection);
     return *this;
   }
 
-  Filtered<T> operator*=(Filtered<T> const& other)
+  Filtered<T>& operator*=(Filtered<T> const& other)
   {
     return operator*=(other.getSelectedRows());
   }
@@ -1879,13 +1927,13 @@ class Filtered<Filtered<T>> : public FilteredPolicy<typename T::table_t>
     return operator+(other.getSelectedRows());
   }
 
-  Filtered<Filtered<T>> operator+=(SelectionVector const& selection)
+  Filtered<Filtered<T>>& operator+=(SelectionVector const& selection)
   {
     this->sumWithSelection(selection);
     return *this;
   }
 
-  Filtered<Filtered<T>> operator+=(Filtered<T> const& other)
+  Filtered<Filtered<T>>& operator+=(Filtered<T> const& other)
   {
     return operator+=(other.getSelectedRows());
   }
@@ -1893,7 +1941,7 @@ class Filtered<Filtered<T>> : public FilteredPolicy<typename T::table_t>
   Filtered<Filtered<T>> operator*(SelectionVector const& selection)
   {
     Filtered<Filtered<T>> copy(*this);
-    copy.intersectionWithSelection(selection);
+    copy.intersectWithSelection(selection);
     return copy;
   }
 
@@ -1902,13 +1950,13 @@ class Filtered<Filtered<T>> : public FilteredPolicy<typename T::table_t>
     return operator*(other.getSelectedRows());
   }
 
-  Filtered<Filtered<T>> operator*=(SelectionVector const& selection)
+  Filtered<Filtered<T>>& operator*=(SelectionVector const& selection)
   {
     this->intersectWithSelection(selection);
     return *this;
   }
 
-  Filtered<Filtered<T>> operator*=(Filtered<T> const& other)
+  Filtered<Filtered<T>>& operator*=(Filtered<T> const& other)
   {
     return operator*=(other.getSelectedRows());
   }
@@ -397,8 +397,8 @@ struct AnalysisDataProcessorBuilder {
             auto start_iterator = std::lower_bound(starts[index], selections[index]->end(), (offsets[index])[pos]);
             auto stop_iterator = std::lower_bound(start_iterator, selections[index]->end(), (offsets[index])[pos + 1]);
             starts[index] = stop_iterator;
-            soa::SelectionVector slicedSelection{start_iterator, stop_iterator};
-            std::transform(slicedSelection.begin(), slicedSelection.end(), slicedSelection.begin(),
+            soa::SelectionVector slicedSelection(std::distance(start_iterator, stop_iterator));
+            std::transform(start_iterator, stop_iterator, slicedSelection.begin(),
                            [&](int64_t idx) {
                              return idx - static_cast<int64_t>((offsets[index])[pos]);
                            });
@@ -11,6 +11,7 @@
 #define O2_FRAMEWORK_CONCRETEDATAMATCHER_H_
 
 #include "Headers/DataHeader.h"
+#include <functional>
 
 namespace o2::framework
 {
@@ -81,4 +82,24 @@ struct ConcreteDataMatcher {
 };
 
 } // namespace o2::framework
+
+namespace std
+{
+/// allows to use ConcreteDataMatcher as a key of unordered containers
+template <>
+struct hash<o2::framework::ConcreteDataMatcher> {
+  size_t operator()(o2::framework::ConcreteDataMatcher const& matcher) const noexcept
+  {
+    size_t result = std::hash<uint64_t>{}(matcher.origin.itg[0]);
+    auto combine = [&result](uint64_t value) {
+      result ^= std::hash<uint64_t>{}(value) + 0x9e3779b97f4a7c15ULL + (result << 6) + (result >> 2);
+    };
+    for (auto itg : matcher.description.itg) {
+      combine(itg);
+    }
+    combine(matcher.subSpec);
+    return result;
+  }
+};
+} // namespace std
 #endif
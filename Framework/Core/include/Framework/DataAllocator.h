@@ -373,6 +373,12 @@ class DataAllocator
   void snapshot(const Output& spec, const char* payload, size_t payloadSize,
                 o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
 
+  /// Send the payload of a received message (e.g. from InputRecord::getPayloadMessage) without
+  /// copying it: the new message shares the buffer of the received one (reference counted),
+  /// which stays untouched. Falls back to a copy if the output channel uses another transport.
+  void forward(const Output& spec, FairMQMessage& payload,
+               o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
+
   /// make an object of type T and route to output specified by OutputRef
   /// The object is owned by the framework, returned reference can be used to fill the object.
   ///
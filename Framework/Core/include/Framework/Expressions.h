@@ -357,6 +357,21 @@ std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Sc
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Projector&& p,
                                                     gandiva::FieldPtr result);
+/// Function to create gandiva projector from a set of gandiva expressions
+std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
+                                                    gandiva::ExpressionVector const& expressions);
+
+/// Statistics of the process-wide cache of compiled filters and projectors.
+/// createFilter and createProjector compile each distinct (schema, expression) pair only once.
+struct CompiledExpressionCacheStats {
+  size_t filters = 0;
+  size_t projectors = 0;
+  size_t hits = 0;
+  size_t misses = 0;
+};
+CompiledExpressionCacheStats getCompiledExpressionCacheStats();
+/// Drop all the cached filters and projectors
+void clearCompiledExpressionCache();
 /// Function for attaching gandiva filters to to compatible task inputs
 void updateExpressionInfos(expressions::Filter const& filter, std::vector<ExpressionInfo>& eInfos);
 /// Function to create gandiva condition expression from generic gandiva expression tree
@@ -369,20 +384,13 @@ void updatePlaceholders(Filter& filter, InitContext& context);
 template <typename... C>
 std::shared_ptr<gandiva::Projector> createProjectors(framework::pack<C...>, gandiva::SchemaPtr schema)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(
+  return createProjector(
     schema,
     {makeExpression(
       framework::expressions::createExpressionTree(
         framework::expressions::createOperations(C::Projector()),
         schema),
-      C::asArrowField())...},
-    &projector);
-  if (s.ok()) {
-    return projector;
-  } else {
-    throw o2::framework::runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
+      C::asArrowField())...});
 }
 } // namespace o2::framework::expressions
 
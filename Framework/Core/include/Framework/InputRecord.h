@@ -201,6 +201,16 @@ class InputRecord
     return mSpan.getNofParts(pos);
   }
 
+  /// Get the message holding the payload of the part at the position, in order to
+  /// forward it without copying. Returns nullptr if it is not available.
+  FairMQMessage* getPayloadMessage(int pos, int part = 0) const
+  {
+    if (pos < 0 || pos >= mSpan.size() || part >= getNofParts(pos)) {
+      return nullptr;
+    }
+    return mSpan.payloadMessage(pos, part);
+  }
+
   /// Get the object of specified type T for the binding R.
   /// If R is a string like object, we look up by name the InputSpec and
   /// return the data associated to the given label.
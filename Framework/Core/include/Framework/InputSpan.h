@@ -13,6 +13,8 @@
 #include "Framework/DataRef.h"
 #include <functional>
 
+class FairMQMessage;
+
 namespace o2
 {
 namespace framework
@@ -58,6 +60,18 @@ class InputSpan
   {
   }
 
+  /// @a getter is the mapping between an element of the span referred by
+  /// index and the buffer associated.
+  /// @nofPartsGetter is the getter for the number of parts associated with an index
+  /// @payloadMessageGetter is the getter of the message holding the payload of a part,
+  /// which allows to forward the payload without copying it.
+  /// @a size is the number of elements in the span.
+  InputSpan(std::function<DataRef(size_t, size_t)> getter, std::function<size_t(size_t)> nofPartsGetter,
+            std::function<FairMQMessage*(size_t, size_t)> payloadMessageGetter, size_t size)
+    : mGetter{getter}, mNofPartsGetter{nofPartsGetter}, mPayloadMessageGetter{payloadMessageGetter}, mSize{size}
+  {
+  }
+
   /// @a i-th element of the InputSpan
   DataRef get(size_t i, size_t partidx = 0) const
   {
@@ -76,6 +90,16 @@ class InputSpan
     return mNofPartsGetter(i);
   }
 
+  /// the message holding the payload of the part in the i-th element of the InputSpan,
+  /// nullptr if not available from the input store
+  FairMQMessage* payloadMessage(size_t i, size_t partidx = 0) const
+  {
+    if (i >= mSize || !mPayloadMessageGetter) {
+      return nullptr;
+    }
+    return mPayloadMessageGetter(i, partidx);
+  }
+
   /// Number of elements in the InputSpan
   size_t size() const
   {
@@ -247,6 +271,7 @@ class InputSpan
  private:
   std::function<DataRef(size_t, size_t)> mGetter;
   std::function<size_t(size_t)> mNofPartsGetter;
+  std::function<FairMQMessage*(size_t, size_t)> mPayloadMessageGetter;
   size_t mSize;
 };
 
@@ -10,6 +10,7 @@
 
 #include "Framework/ASoA.h"
 #include "ArrowDebugHelpers.h"
+#include <cstring>
 
 namespace o2::soa
 {
@@ -81,6 +82,96 @@ std::shared_ptr<arrow::Table> ArrowHelpers::concatTables(std::vector<std::shared
   return result;
 }
 
+namespace
+{
+/// Use a row bitmap when it has no more words than there are input rows,
+/// otherwise a plain merge is cheaper.
+bool useBitmap(SelectionVector const& a, SelectionVector const& b, int64_t& maxRow)
+{
+  maxRow = std::max(a.back(), b.back()) + 1;
+  return (maxRow + 63) / 64 <= static_cast<int64_t>(a.size() + b.size());
+}
+
+inline void fillBitmap(std::vector<uint64_t>& bitmap, SelectionVector const& rows)
+{
+  for (auto row : rows) {
+    bitmap[row >> 6] |= uint64_t{1} << (row & 63);
+  }
+}
+} // namespace
+
+void unionSelections(SelectionVector const& a, SelectionVector const& b, SelectionVector& result)
+{
+  result.clear();
+  if (a.empty() || b.empty()) {
+    result = a.empty() ? b : a;
+    return;
+  }
+  int64_t maxRow;
+  if (!useBitmap(a, b, maxRow)) {
+    result.reserve(a.size() + b.size());
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return;
+  }
+  std::vector<uint64_t> bitmap((maxRow + 63) / 64, 0);
+  fillBitmap(bitmap, a);
+  fillBitmap(bitmap, b);
+  size_t count = 0;
+  for (auto word : bitmap) {
+    count += __builtin_popcountll(word);
+  }
+  result.resize(count);
+  auto out = result.data();
+  for (size_t w = 0; w < bitmap.size(); ++w) {
+    for (auto word = bitmap[w]; word != 0; word &= word - 1) {
+      *out++ = (w << 6) + __builtin_ctzll(word);
+    }
+  }
+}
+
+void intersectSelections(SelectionVector const& a, SelectionVector const& b, SelectionVector& result)
+{
+  result.clear();
+  if (a.empty() || b.empty()) {
+    return;
+  }
+  int64_t maxRow;
+  if (!useBitmap(a, b, maxRow)) {
+    result.reserve(std::min(a.size(), b.size()));
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return;
+  }
+  // mark the shorter selection and stream the longer one through the bitmap,
+  // which keeps the output sorted without a data-dependent merge
+  auto const& marked = a.size() < b.size() ? a : b;
+  auto const& probed = a.size() < b.size() ? b : a;
+  std::vector<uint64_t> bitmap((maxRow + 63) / 64, 0);
+  fillBitmap(bitmap, marked);
+  result.resize(marked.size() + 1);
+  size_t count = 0;
+  int64_t previous = -1;
+  for (auto row : probed) {
+    result[count] = row;
+    count += ((bitmap[row >> 6] >> (row & 63)) & 1) & (row != previous);
+    previous = row;
+  }
+  result.resize(count);
+}
+
+SelectionVector copySelection(gandiva::SelectionVector const& sel)
+{
+  auto nSlots = sel.GetNumSlots();
+  SelectionVector rows(nSlots);
+  if (sel.GetMode() == gandiva::SelectionVector::MODE_UINT64) {
+    std::memcpy(rows.data(), sel.GetBuffer().data(), nSlots * sizeof(int64_t));
+  } else {
+    for (auto i = 0; i < nSlots; ++i) {
+      rows[i] = sel.GetIndex(i);
+    }
+  }
+  return rows;
+}
+
 arrow::ChunkedArray* getIndexFromLabel(arrow::Table* table, const char* label)
 {
   auto index = table->schema()->GetAllFieldIndices(label);
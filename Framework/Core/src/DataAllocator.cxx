@@ -255,6 +255,24 @@ void DataAllocator::snapshot(const Output& spec, const char* payload, size_t pay
   addPartToContext(std::move(payloadMessage), spec, serializationMethod);
 }
 
+void DataAllocator::forward(const Output& spec, FairMQMessage& payload,
+                            o2::header::SerializationMethod serializationMethod)
+{
+  std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
+  auto& proxy = mRegistry->get<MessageContext>().proxy();
+  auto* transport = proxy.getTransport(channel, 0);
+  FairMQMessagePtr payloadMessage;
+  if (transport->GetType() == payload.GetType()) {
+    payloadMessage = transport->CreateMessage();
+    payloadMessage->Copy(payload);
+  } else {
+    payloadMessage = transport->CreateMessage(payload.GetSize());
+    memcpy(payloadMessage->GetData(), payload.GetData(), payload.GetSize());
+  }
+
+  addPartToContext(std::move(payloadMessage), spec, serializationMethod);
+}
+
 Output DataAllocator::getOutputByBind(OutputRef&& ref)
 {
   if (ref.label.empty()) {
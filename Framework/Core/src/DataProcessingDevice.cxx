@@ -838,7 +838,13 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     auto nofPartsGetter = [&currentSetOfInputs](size_t i) -> size_t {
       return currentSetOfInputs[i].size();
     };
-    InputSpan span{getter, nofPartsGetter, currentSetOfInputs.size()};
+    auto payloadMessageGetter = [&currentSetOfInputs](size_t i, size_t partindex) -> FairMQMessage* {
+      if (currentSetOfInputs[i].size() > partindex) {
+        return currentSetOfInputs[i].at(partindex).payload.get();
+      }
+      return nullptr;
+    };
+    InputSpan span{getter, nofPartsGetter, payloadMessageGetter, currentSetOfInputs.size()};
     return InputRecord{spec->inputs, std::move(span)};
   };
 
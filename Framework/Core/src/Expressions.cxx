@@ -20,6 +20,7 @@
 #include <unordered_map>
 #include <set>
 #include <algorithm>
+#include <mutex>
 
 using namespace o2::framework;
 
@@ -313,43 +314,126 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(node, result);
 }
 
+namespace
+{
+/// Process-wide store of compiled gandiva objects. Building a filter or a projector runs the LLVM
+/// code generation, so each distinct (schema, expression) pair is compiled only once per process,
+/// no matter how many tasks or dataframes request it.
+template <typename T>
+struct CompiledExpressionCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, std::shared_ptr<T>> objects;
+  size_t hits = 0;
+  size_t misses = 0;
+
+  template <typename M>
+  std::shared_ptr<T> get(std::string const& key, M&& make)
+  {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      auto it = objects.find(key);
+      if (it != objects.end()) {
+        ++hits;
+        return it->second;
+      }
+      ++misses;
+    }
+    // compile without holding the lock, a concurrent compilation of the same key is harmless
+    auto object = make();
+    std::lock_guard<std::mutex> lock{mutex};
+    return objects.emplace(key, std::move(object)).first->second;
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock{mutex};
+    objects.clear();
+    hits = 0;
+    misses = 0;
+  }
+};
+
+CompiledExpressionCache<gandiva::Filter>& filterCache()
+{
+  static CompiledExpressionCache<gandiva::Filter> cache;
+  return cache;
+}
+
+CompiledExpressionCache<gandiva::Projector>& projectorCache()
+{
+  static CompiledExpressionCache<gandiva::Projector> cache;
+  return cache;
+}
+} // namespace
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 condition,
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+  return filterCache().get(Schema->ToString() + "\n" + condition->ToString(), [&]() {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(Schema,
+                                   condition,
+                                   &filter);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+    }
+    return filter;
+  });
+}
+
+std::shared_ptr<gandiva::Projector>
+  createProjector(gandiva::SchemaPtr const& Schema, gandiva::ExpressionVector const& expressions)
+{
+  std::string key = Schema->ToString();
+  for (auto& expression : expressions) {
+    key += "\n" + expression->ToString() + " -> " + expression->result()->ToString();
   }
-  return filter;
+  return projectorCache().get(key, [&]() {
+    std::shared_ptr<gandiva::Projector> projector;
+    auto s = gandiva::Projector::Make(Schema,
+                                      expressions,
+                                      &projector);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+    }
+    return projector;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), result)},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+  return createProjector(Schema, {makeExpression(createExpressionTree(opSpecs, Schema), result)});
+}
+
+CompiledExpressionCacheStats getCompiledExpressionCacheStats()
+{
+  CompiledExpressionCacheStats stats;
+  {
+    std::lock_guard<std::mutex> lock{filterCache().mutex};
+    stats.filters = filterCache().objects.size();
+    stats.hits += filterCache().hits;
+    stats.misses += filterCache().misses;
   }
-  return projector;
+  {
+    std::lock_guard<std::mutex> lock{projectorCache().mutex};
+    stats.projectors = projectorCache().objects.size();
+    stats.hits += projectorCache().hits;
+    stats.misses += projectorCache().misses;
+  }
+  return stats;
+}
+
+void clearCompiledExpressionCache()
+{
+  filterCache().clear();
+  projectorCache().clear();
 }
 
 std::shared_ptr<gandiva::Projector>
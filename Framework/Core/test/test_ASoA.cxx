@@ -574,6 +574,59 @@ BOOST_AUTO_TEST_CASE(TestFilteredOperators)
   BOOST_CHECK_EQUAL(i, 3);
 }
 
+BOOST_AUTO_TEST_CASE(TestFilteredCopies)
+{
+  TableBuilder builderA;
+  auto rowWriterA = builderA.persist<int32_t, int32_t>({"x", "y"});
+  for (auto i = 0; i < 200; ++i) {
+    rowWriterA(0, i, i + 8);
+  }
+  auto tableA = builderA.finalize();
+  BOOST_REQUIRE_EQUAL(tableA->num_rows(), 200);
+
+  using TestA = o2::soa::Table<o2::soa::Index<>, test::X, test::Y>;
+  using FilteredTest = Filtered<TestA>;
+  using namespace o2::framework;
+
+  expressions::Filter f1 = test::x < 150;
+  expressions::Filter f2 = test::y > 57;
+
+  TestA testA{tableA};
+  FilteredTest filtered1{{testA.asArrowTable()}, expressions::createSelection(testA.asArrowTable(), f1)};
+  FilteredTest filtered2{{testA.asArrowTable()}, expressions::createSelection(testA.asArrowTable(), f2)};
+  BOOST_CHECK_EQUAL(150, filtered1.size());
+  BOOST_CHECK_EQUAL(150, filtered2.size());
+
+  // the copy must iterate over its own selection, also once the original changed
+  FilteredTest copy{filtered1};
+  filtered1 *= filtered2;
+  BOOST_CHECK_EQUAL(100, filtered1.size());
+  BOOST_CHECK_EQUAL(150, copy.size());
+  auto i = 0;
+  for (auto& f : copy) {
+    BOOST_CHECK_EQUAL(i, f.x());
+    BOOST_CHECK_EQUAL(i, f.index());
+    i++;
+  }
+  BOOST_CHECK_EQUAL(i, 150);
+
+  i = 50;
+  for (auto& f : filtered1) {
+    BOOST_CHECK_EQUAL(i, f.x());
+    i++;
+  }
+  BOOST_CHECK_EQUAL(i, 150);
+
+  copy += filtered2;
+  BOOST_CHECK_EQUAL(200, copy.size());
+  i = 0;
+  for (auto& f : copy) {
+    BOOST_CHECK_EQUAL(i, f.x());
+    i++;
+  }
+  BOOST_CHECK_EQUAL(i, 200);
+}
+
 BOOST_AUTO_TEST_CASE(TestNestedFiltering)
 {
   TableBuilder builderA;
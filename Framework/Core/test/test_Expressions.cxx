@@ -202,3 +202,29 @@ BOOST_AUTO_TEST_CASE(TestGandivaTreeCreation)
   BOOST_REQUIRE(s.ok());
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(TestCompiledExpressionCache)
+{
+  clearCompiledExpressionCache();
+  auto schema = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Signed1Pt::asArrowField(), o2::aod::track::Tgl::asArrowField()});
+
+  Filter f1 = o2::aod::track::signed1Pt > 0.5f;
+  Filter f2 = o2::aod::track::signed1Pt > 0.5f;
+  Filter f3 = o2::aod::track::signed1Pt > 1.5f;
+  auto filter1 = createFilter(schema, createOperations(f1));
+  auto filter2 = createFilter(schema, createOperations(f2));
+  auto filter3 = createFilter(schema, createOperations(f3));
+  BOOST_CHECK_EQUAL(filter1.get(), filter2.get());
+  BOOST_CHECK_NE(filter1.get(), filter3.get());
+
+  auto resfield = o2::aod::track::Pze::asArrowField();
+  auto projector1 = createProjector(schema, o2::aod::track::Pze::Projector(), resfield);
+  auto projector2 = createProjector(schema, o2::aod::track::Pze::Projector(), resfield);
+  BOOST_CHECK_EQUAL(projector1.get(), projector2.get());
+
+  auto stats = getCompiledExpressionCacheStats();
+  BOOST_CHECK_EQUAL(stats.filters, 2);
+  BOOST_CHECK_EQUAL(stats.projectors, 1);
+  BOOST_CHECK_EQUAL(stats.hits, 2);
+  BOOST_CHECK_EQUAL(stats.misses, 3);
+}
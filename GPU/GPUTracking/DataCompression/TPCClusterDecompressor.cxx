@@ -16,8 +16,14 @@
 #include "GPUParam.h"
 #include "GPUTPCCompressionTrackModel.h"
 #include <algorithm>
-#include <cstring>
-#include <atomic>
+#include <vector>
+
+#if defined(WITH_OPENMP) || defined(_OPENMP)
+#include <omp.h>
+#else
+static inline int omp_get_thread_num() { return 0; }
+static inline int omp_get_max_threads() { return 1; }
+#endif
 
 using namespace GPUCA_NAMESPACE::gpu;
 using namespace o2::tpc;
@@ -37,24 +43,40 @@ int TPCClusterDecompressor::decompress(const CompressedClustersFlat* clustersCom
 
 int TPCClusterDecompressor::decompress(const CompressedClusters* clustersCompressed, o2::tpc::ClusterNativeAccess& clustersNative, std::function<o2::tpc::ClusterNative*(size_t)> allocator, const GPUParam& param)
 {
-  std::vector<ClusterNative> clusters[NSLICES][GPUCA_ROW_COUNT];
-  std::atomic_flag locks[NSLICES][GPUCA_ROW_COUNT];
-  for (unsigned int i = 0; i < NSLICES * GPUCA_ROW_COUNT; i++) {
-    (&locks[0][0])[i].clear();
+  // The attached clusters are decoded in two passes without any locking:
+  // 1. Each thread decodes its tracks into a private buffer and counts the clusters per slice and row.
+  // 2. From the counts the output ranges of each (slice, row, thread) are derived, and the private buffers are
+  //    scattered directly into the final cluster buffer, followed by the unattached clusters and a per-row sort.
+  static constexpr unsigned int NSLICEROWS = NSLICES * GPUCA_ROW_COUNT;
+  const unsigned int nThreads = omp_get_max_threads();
+
+  std::vector<unsigned int> trackOffsets(clustersCompressed->nTracks);
+  unsigned int trackOffset = 0;
+  for (unsigned int i = 0; i < clustersCompressed->nTracks; i++) {
+    trackOffsets[i] = trackOffset;
+    trackOffset += clustersCompressed->nTrackClusters[i];
   }
-  unsigned int offset = 0, lasti = 0;
-  GPUCA_OPENMP(parallel for firstprivate(offset, lasti))
+
+  std::vector<std::vector<ClusterNative>> threadClusters(nThreads);
+  std::vector<std::vector<unsigned short>> threadSliceRows(nThreads);
+  std::vector<unsigned int> threadCounts(nThreads * NSLICEROWS, 0);
+  for (unsigned int iThread = 0; iThread < nThreads; iThread++) {
+    threadClusters[iThread].reserve(clustersCompressed->nAttachedClusters / nThreads);
+    threadSliceRows[iThread].reserve(clustersCompressed->nAttachedClusters / nThreads);
+  }
+
+  GPUCA_OPENMP(parallel for num_threads(nThreads))
   for (unsigned int i = 0; i < clustersCompressed->nTracks; i++) {
-    while (lasti < i) {
-      offset += clustersCompressed->nTrackClusters[lasti++];
-    }
-    lasti++;
+    const int iThread = omp_get_thread_num();
+    auto& clusterVector = threadClusters[iThread];
+    auto& sliceRowVector = threadSliceRows[iThread];
+    unsigned int* counts = &threadCounts[iThread * NSLICEROWS];
+    unsigned int offset = trackOffsets[i];
     float zOffset = 0;
     unsigned int slice = clustersCompressed->sliceA[i];
     unsigned int row = clustersCompressed->rowA[i];
     GPUTPCCompressionTrackModel track;
-    unsigned int j;
-    for (j = 0; j < clustersCompressed->nTrackClusters[i]; j++) {
+    for (unsigned int j = 0; j < clustersCompressed->nTrackClusters[i]; j++) {
       unsigned int pad = 0, time = 0;
       if (j) {
         unsigned char tmpSlice = clustersCompressed->sliceLegDiffA[offset - i - 1];
@@ -92,15 +114,13 @@ int TPCClusterDecompressor::decompress(const CompressedClusters* clustersCompres
         time = clustersCompressed->timeA[i];
         pad = clustersCompressed->padA[i];
       }
-      std::vector<ClusterNative>& clusterVector = clusters[slice][row];
-      auto& lock = locks[slice][row];
-      while (lock.test_and_set(std::memory_order_acquire)) {
-      }
+      const unsigned int sliceRow = slice * GPUCA_ROW_COUNT + row;
       clusterVector.emplace_back(time, clustersCompressed->flagsA[offset], pad, clustersCompressed->sigmaTimeA[offset], clustersCompressed->sigmaPadA[offset], clustersCompressed->qMaxA[offset], clustersCompressed->qTotA[offset]);
-      auto& cluster = clusterVector.back();
+      sliceRowVector.emplace_back(sliceRow);
+      counts[sliceRow]++;
+      const auto& cluster = clusterVector.back();
       float y = param.tpcGeometry.LinearPad2Y(slice, row, cluster.getPad());
       float z = param.tpcGeometry.LinearTime2Z(slice, cluster.getTime());
-      lock.clear(std::memory_order_release);
       if (j == 0) {
         zOffset = z;
         track.Init(param.tpcGeometry.Row2X(row), y, z - zOffset, param.SliceParam[slice].Alpha, clustersCompressed->qPtA[i], param);
@@ -110,47 +130,72 @@ int TPCClusterDecompressor::decompress(const CompressedClusters* clustersCompres
       }
       offset++;
     }
-    offset += clustersCompressed->nTrackClusters[i] - j;
   }
+
   ClusterNative* clusterBuffer = allocator(clustersCompressed->nAttachedClusters + clustersCompressed->nUnattachedClusters);
-  unsigned int offsets[NSLICES][GPUCA_ROW_COUNT];
-  offset = 0;
+  unsigned int unattachedOffsets[NSLICES][GPUCA_ROW_COUNT];
+  unsigned int offset = 0;
   for (unsigned int i = 0; i < NSLICES; i++) {
     for (unsigned int j = 0; j < GPUCA_ROW_COUNT; j++) {
-      clustersNative.nClusters[i][j] = clusters[i][j].size() + clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
-      offsets[i][j] = offset;
-      offset += clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
+      const unsigned int sliceRow = i * GPUCA_ROW_COUNT + j;
+      unsigned int nAttached = 0;
+      for (unsigned int iThread = 0; iThread < nThreads; iThread++) {
+        nAttached += threadCounts[iThread * NSLICEROWS + sliceRow];
+      }
+      clustersNative.nClusters[i][j] = nAttached + clustersCompressed->nSliceRowClusters[sliceRow];
+      unattachedOffsets[i][j] = offset;
+      offset += clustersCompressed->nSliceRowClusters[sliceRow];
     }
   }
   clustersNative.clustersLinear = clusterBuffer;
   clustersNative.setOffsetPtrs();
-  GPUCA_OPENMP(parallel for)
-  for (unsigned int i = 0; i < NSLICES; i++) {
-    for (unsigned int j = 0; j < GPUCA_ROW_COUNT; j++) {
-      ClusterNative* buffer = &clusterBuffer[clustersNative.clusterOffset[i][j]];
-      if (clusters[i][j].size()) {
-        memcpy((void*)buffer, (const void*)clusters[i][j].data(), clusters[i][j].size() * sizeof(clusterBuffer[0]));
-      }
-      unsigned int time = 0;
-      unsigned short pad = 0;
-      ClusterNative* cl = buffer + clusters[i][j].size();
-      unsigned int end = offsets[i][j] + clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
-      for (unsigned int k = offsets[i][j]; k < end; k++) {
-        if (clustersCompressed->nComppressionModes & GPUSettings::CompressionDifferences) {
-          unsigned int timeTmp = clustersCompressed->timeDiffU[k];
-          if (timeTmp & 800000) {
-            timeTmp |= 0xFF000000;
-          }
-          time += timeTmp;
-          pad += clustersCompressed->padDiffU[k];
-        } else {
-          time = clustersCompressed->timeDiffU[k];
-          pad = clustersCompressed->padDiffU[k];
+
+  // Convert the counts into the write positions of each thread: within a row the attached clusters of thread 0
+  // come first, followed by those of thread 1, etc., and finally the unattached clusters
+  for (unsigned int sliceRow = 0; sliceRow < NSLICEROWS; sliceRow++) {
+    unsigned int writePos = clustersNative.clusterOffset[sliceRow / GPUCA_ROW_COUNT][sliceRow % GPUCA_ROW_COUNT];
+    for (unsigned int iThread = 0; iThread < nThreads; iThread++) {
+      unsigned int& count = threadCounts[iThread * NSLICEROWS + sliceRow];
+      const unsigned int nThreadClusters = count;
+      count = writePos;
+      writePos += nThreadClusters;
+    }
+  }
+
+  GPUCA_OPENMP(parallel for num_threads(nThreads))
+  for (unsigned int iThread = 0; iThread < nThreads; iThread++) {
+    unsigned int* writePos = &threadCounts[iThread * NSLICEROWS];
+    const auto& clusterVector = threadClusters[iThread];
+    const auto& sliceRowVector = threadSliceRows[iThread];
+    for (size_t k = 0; k < clusterVector.size(); k++) {
+      clusterBuffer[writePos[sliceRowVector[k]]++] = clusterVector[k];
+    }
+  }
+
+  GPUCA_OPENMP(parallel for num_threads(nThreads) schedule(dynamic))
+  for (unsigned int sliceRow = 0; sliceRow < NSLICEROWS; sliceRow++) {
+    const unsigned int i = sliceRow / GPUCA_ROW_COUNT;
+    const unsigned int j = sliceRow % GPUCA_ROW_COUNT;
+    ClusterNative* buffer = &clusterBuffer[clustersNative.clusterOffset[i][j]];
+    unsigned int time = 0;
+    unsigned short pad = 0;
+    ClusterNative* cl = buffer + clustersNative.nClusters[i][j] - clustersCompressed->nSliceRowClusters[sliceRow];
+    unsigned int end = unattachedOffsets[i][j] + clustersCompressed->nSliceRowClusters[sliceRow];
+    for (unsigned int k = unattachedOffsets[i][j]; k < end; k++) {
+      if (clustersCompressed->nComppressionModes & GPUSettings::CompressionDifferences) {
+        unsigned int timeTmp = clustersCompressed->timeDiffU[k];
+        if (timeTmp & 800000) {
+          timeTmp |= 0xFF000000;
         }
-        *(cl++) = ClusterNative(time, clustersCompressed->flagsU[k], pad, clustersCompressed->sigmaTimeU[k], clustersCompressed->sigmaPadU[k], clustersCompressed->qMaxU[k], clustersCompressed->qTotU[k]);
+        time += timeTmp;
+        pad += clustersCompressed->padDiffU[k];
+      } else {
+        time = clustersCompressed->timeDiffU[k];
+        pad = clustersCompressed->padDiffU[k];
       }
-      std::sort(buffer, buffer + clustersNative.nClusters[i][j]);
+      *(cl++) = ClusterNative(time, clustersCompressed->flagsU[k], pad, clustersCompressed->sigmaTimeU[k], clustersCompressed->sigmaPadU[k], clustersCompressed->qMaxU[k], clustersCompressed->qTotU[k]);
     }
+    std::sort(buffer, buffer + clustersNative.nClusters[i][j]);
   }
 
   return 0;
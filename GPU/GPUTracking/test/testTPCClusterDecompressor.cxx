@@ -0,0 +1,151 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCClusterDecompressor.cxx
+/// \brief Check that the TPC cluster decompression does not depend on the number of threads
+
+#define BOOST_TEST_MODULE Test TPC Cluster Decompressor
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "GPUO2Interface.h" // Needed for propper settings in GPUParam.h
+#include "GPUParam.h"
+#include "GPUO2DataTypes.h"
+#include "TPCClusterDecompressor.h"
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include <omp.h>
+
+namespace o2::gpu
+{
+
+namespace
+{
+/// Backing storage of a CompressedClusters with random tracks and unattached clusters
+struct CompressedClustersStorage {
+  std::vector<unsigned short> qTotA, qMaxA, padResA, padA, qTotU, qMaxU, padDiffU, nTrackClusters;
+  std::vector<unsigned char> flagsA, rowDiffA, sliceLegDiffA, sigmaPadA, sigmaTimeA, qPtA, rowA, sliceA, flagsU, sigmaPadU, sigmaTimeU;
+  std::vector<unsigned int> timeResA, timeA, timeDiffU, nSliceRowClusters;
+  o2::tpc::CompressedClusters clusters;
+
+  CompressedClustersStorage(unsigned int nTracks, unsigned int seed)
+  {
+    constexpr unsigned int NSLICES = TPCClusterDecompressor::NSLICES;
+    std::mt19937 gen(seed);
+    auto rnd = [&gen](unsigned int max) { return std::uniform_int_distribution<unsigned int>(0, max)(gen); };
+    for (unsigned int i = 0; i < nTracks; i++) {
+      const unsigned int nCl = 1 + rnd(30);
+      nTrackClusters.push_back(nCl);
+      qPtA.push_back(rnd(255));
+      rowA.push_back(rnd(GPUCA_ROW_COUNT - 1));
+      sliceA.push_back(rnd(NSLICES - 1));
+      timeA.push_back(o2::tpc::ClusterNative::packTime(100.f + rnd(400)));
+      padA.push_back(o2::tpc::ClusterNative::packPad(5.f + rnd(50)));
+      for (unsigned int j = 0; j < nCl; j++) {
+        qTotA.push_back(rnd(1000));
+        qMaxA.push_back(rnd(100));
+        flagsA.push_back(rnd(3));
+        sigmaPadA.push_back(rnd(255));
+        sigmaTimeA.push_back(rnd(255));
+        if (j) {
+          rowDiffA.push_back(1);
+          sliceLegDiffA.push_back(rnd(20) ? 0 : 1);
+          padResA.push_back(rnd(64));
+          timeResA.push_back(rnd(64));
+        }
+      }
+    }
+    nSliceRowClusters.resize(NSLICES * GPUCA_ROW_COUNT);
+    for (auto& n : nSliceRowClusters) {
+      n = rnd(4);
+      for (unsigned int k = 0; k < n; k++) {
+        qTotU.push_back(rnd(1000));
+        qMaxU.push_back(rnd(100));
+        flagsU.push_back(rnd(3));
+        padDiffU.push_back(rnd(200));
+        timeDiffU.push_back(rnd(2000));
+        sigmaPadU.push_back(rnd(255));
+        sigmaTimeU.push_back(rnd(255));
+      }
+    }
+
+    clusters.nTracks = nTracks;
+    clusters.nAttachedClusters = qTotA.size();
+    clusters.nUnattachedClusters = qTotU.size();
+    clusters.nAttachedClustersReduced = clusters.nAttachedClusters - nTracks;
+    clusters.nSliceRows = NSLICES * GPUCA_ROW_COUNT;
+    clusters.nComppressionModes = GPUSettings::CompressionDifferences;
+    clusters.qTotA = qTotA.data();
+    clusters.qMaxA = qMaxA.data();
+    clusters.flagsA = flagsA.data();
+    clusters.rowDiffA = rowDiffA.data();
+    clusters.sliceLegDiffA = sliceLegDiffA.data();
+    clusters.padResA = padResA.data();
+    clusters.timeResA = timeResA.data();
+    clusters.sigmaPadA = sigmaPadA.data();
+    clusters.sigmaTimeA = sigmaTimeA.data();
+    clusters.qPtA = qPtA.data();
+    clusters.rowA = rowA.data();
+    clusters.sliceA = sliceA.data();
+    clusters.timeA = timeA.data();
+    clusters.padA = padA.data();
+    clusters.qTotU = qTotU.data();
+    clusters.qMaxU = qMaxU.data();
+    clusters.flagsU = flagsU.data();
+    clusters.padDiffU = padDiffU.data();
+    clusters.timeDiffU = timeDiffU.data();
+    clusters.sigmaPadU = sigmaPadU.data();
+    clusters.sigmaTimeU = sigmaTimeU.data();
+    clusters.nTrackClusters = nTrackClusters.data();
+    clusters.nSliceRowClusters = nSliceRowClusters.data();
+  }
+};
+
+/// Decompress with the given number of OpenMP threads
+void decompress(const o2::tpc::CompressedClusters& compressed, const GPUParam& param, int nThreads,
+                std::unique_ptr<o2::tpc::ClusterNative[]>& buffer, o2::tpc::ClusterNativeAccess& access)
+{
+  omp_set_num_threads(nThreads);
+  auto allocator = [&buffer](size_t size) {
+    buffer.reset(new o2::tpc::ClusterNative[size]);
+    return buffer.get();
+  };
+  TPCClusterDecompressor decomp;
+  BOOST_REQUIRE_EQUAL(decomp.decompress(&compressed, access, allocator, param), 0);
+}
+} // namespace
+
+/// The decoded clusters, their row assignment and order must be identical for one and several threads
+BOOST_AUTO_TEST_CASE(TPCClusterDecompressor_threads)
+{
+  GPUParam param;
+  param.SetDefaults(5.00668f);
+  CompressedClustersStorage storage(2000, 12345);
+
+  std::unique_ptr<o2::tpc::ClusterNative[]> bufferSerial, bufferParallel;
+  o2::tpc::ClusterNativeAccess accessSerial, accessParallel;
+  decompress(storage.clusters, param, 1, bufferSerial, accessSerial);
+  decompress(storage.clusters, param, 4, bufferParallel, accessParallel);
+
+  BOOST_REQUIRE_EQUAL(accessSerial.nClustersTotal, accessParallel.nClustersTotal);
+  BOOST_CHECK(accessSerial.nClustersTotal > storage.clusters.nUnattachedClusters);
+  for (unsigned int i = 0; i < TPCClusterDecompressor::NSLICES; i++) {
+    for (unsigned int j = 0; j < GPUCA_ROW_COUNT; j++) {
+      BOOST_REQUIRE_EQUAL(accessSerial.nClusters[i][j], accessParallel.nClusters[i][j]);
+      BOOST_REQUIRE_EQUAL(accessSerial.clusterOffset[i][j], accessParallel.clusterOffset[i][j]);
+    }
+  }
+  BOOST_CHECK(std::memcmp(accessSerial.clustersLinear, accessParallel.clustersLinear, accessSerial.nClustersTotal * sizeof(o2::tpc::ClusterNative)) == 0);
+}
+
+} // namespace o2::gpu
@@ -18,6 +18,7 @@
 #include "CPVSimulation/Digitizer.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
 #include "DetectorsBase/BaseDPLDigitizer.h"
+#include "SimulationDataFormat/DigitizationContext.h"
 
 class TChain;
 
@@ -54,10 +55,12 @@ class DigitizerSpec final : public o2::base::BaseDPLDigitizer
 
  private:
   /// \brief helper function which will be offered as a service
+  /// \param context Digitization context providing the (cached) hits
   /// \param brname Name of the hit branch
   /// \param sourceID ID of the source
   /// \param entryID ID of the entry in the source
-  void retrieveHits(const char* brname,
+  void retrieveHits(const o2::steer::DigitizationContext& context,
+                    const char* brname,
                     int sourceID,
                     int entryID);
 
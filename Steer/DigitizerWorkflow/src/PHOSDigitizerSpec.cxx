@@ -60,18 +60,13 @@ void DigitizerSpec::initDigitizerTask(framework::InitContext& ic)
   mHits = new std::vector<Hit>();
 }
 // helper function which will be offered as a service
-void DigitizerSpec::retrieveHits(const char* brname,
+void DigitizerSpec::retrieveHits(const o2::steer::DigitizationContext& context,
+                                 const char* brname,
                                  int sourceID,
                                  int entryID)
 {
-  auto br = mSimChains[sourceID]->GetBranch(brname);
-  if (!br) {
-    LOG(ERROR) << "No branch found";
-    return;
-  }
   mHits->clear();
-  br->SetAddress(&mHits);
-  br->GetEntry(entryID);
+  context.retrieveHits(mSimChains, brname, sourceID, entryID, mHits);
 }
 
 void DigitizerSpec::run(framework::ProcessingContext& pc)
@@ -132,7 +127,7 @@ void DigitizerSpec::run(framework::ProcessingContext& pc)
       // get the hits for this event and this source
       int source = part->sourceID;
       int entry = part->entryID;
-      retrieveHits("PHSHit", source, entry);
+      retrieveHits(*context, "PHSHit", source, entry);
       part++;
       if (part == eventParts[collID].end() && isLastStream) { //last stream, copy digits directly to output vector
         mDigitizer.processHits(mHits, mDigitsFinal, mDigitsOut, mLabels, collID, source, dt);
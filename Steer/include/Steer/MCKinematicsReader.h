@@ -14,6 +14,10 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include "SimulationDataFormat/MCTruthContainer.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 class TChain;
@@ -32,6 +36,18 @@ class MCKinematicsReader
     kMCKine
   };
 
+  /// statistics of the in-memory cache of the tracks, headers and track references
+  struct CacheStats {
+    size_t nHits = 0;         ///< queries served from memory
+    size_t nMisses = 0;       ///< queries which required reading from the input
+    size_t nPrefetched = 0;   ///< events of tracks read ahead asynchronously
+    size_t nPrefetchHits = 0; ///< prefetched events which were queried later
+    size_t nEvicted = 0;      ///< entries released to respect the memory limit
+    size_t memory = 0;        ///< estimated memory of the loaded entries
+    size_t memoryPeak = 0;    ///< peak of the estimated memory
+    float getHitRate() const { return nHits + nMisses ? float(nHits) / (nHits + nMisses) : 0.f; }
+  };
+
   /// default constructor
   MCKinematicsReader() = default;
 
@@ -108,22 +124,73 @@ class MCKinematicsReader
     return mDigitizationContext;
   }
 
+  /// Limit the estimated memory (in bytes) of the loaded tracks, headers and track references, 0 = no limit (default).
+  /// When the limit is exceeded, the least recently queried entries are released: with the limit set, the objects
+  /// returned by earlier queries may be invalidated by any later query, only the one returned last stays valid.
+  void setMemoryLimit(size_t bytes);
+  size_t getMemoryLimit() const { return mMemoryLimit; }
+
+  /// Read ahead in a background thread the tracks of the next nEvents events of the source whose tracks
+  /// were queried, as the label consumers usually process the events in increasing order. 0 = disable (default).
+  /// Enabling it turns on the ROOT thread safety; the queries may then be issued from several threads.
+  void setPrefetchDepth(int nEvents);
+  int getPrefetchDepth() const { return mPrefetchDepth; }
+
+  CacheStats getCacheStats() const;
+  void resetCacheStats();
+  void printCacheStats() const;
+
  private:
-  void initTracksForSource(int source) const;
+  enum class EntryType : uint8_t {
+    kTracks,
+    kHeader,
+    kTrackRefs
+  };
+  struct LRUEntry {
+    std::list<uint64_t>::iterator pos; // position in the LRU list
+    size_t size = 0;                   // estimated memory
+    bool prefetched = false;           // loaded by the prefetcher and not queried yet
+  };
+  struct Prefetcher;
+
+  static uint64_t getEntryKey(EntryType type, int source, int event) { return (uint64_t(type) << 56) | (uint64_t(source) << 32) | uint32_t(event); }
+  static std::vector<o2::MCTrack>* readTracks(TChain* chain, int event);
+  static size_t getTracksSize(const std::vector<o2::MCTrack>& tracks) { return sizeof(tracks) + tracks.capacity() * sizeof(o2::MCTrack); }
+
+  std::unique_lock<std::mutex> lockCache() const;
+  void initSource(int source) const;
+  bool isLoaded(EntryType type, int source, int event) const;
+  void queryEntry(EntryType type, int source, int event) const;
   void loadTracksForSourceAndEvent(int source, int eventID) const;
-  void loadHeadersForSource(int source) const;
-  void loadTrackRefsForSource(int source) const;
+  void loadHeaderForSourceAndEvent(int source, int eventID) const;
+  void loadTrackRefsForSourceAndEvent(int source, int eventID) const;
   void initIndexedTrackRefs(std::vector<o2::TrackReference>& refs, o2::dataformats::MCTruthContainer<o2::TrackReference>& indexedrefs) const;
 
+  void registerEntry(uint64_t key, size_t size, bool prefetched = false) const;
+  void touchEntry(uint64_t key) const;
+  void releaseEntry(uint64_t key) const;
+  void evictEntries(uint64_t keep) const;
+  void schedulePrefetch(int source, int event) const;
+  void startPrefetcher();
+  void stopPrefetcher();
+  void runPrefetcher() const;
+
   DigitizationContext const* mDigitizationContext = nullptr;
 
   // chains for each source
   std::vector<TChain*> mInputChains;
 
   // a vector of tracks foreach source and each collision
-  mutable std::vector<std::vector<std::vector<o2::MCTrack>*>> mTracks;                                       // the in-memory track container
-  mutable std::vector<std::vector<o2::dataformats::MCEventHeader>> mHeaders;                                 // the in-memory header container
-  mutable std::vector<std::vector<o2::dataformats::MCTruthContainer<o2::TrackReference>>> mIndexedTrackRefs; // the in-memory track ref container
+  mutable std::vector<std::vector<std::vector<o2::MCTrack>*>> mTracks;                                                         //! the in-memory track container
+  mutable std::vector<std::vector<std::unique_ptr<o2::dataformats::MCEventHeader>>> mHeaders;                                  //! the in-memory header container
+  mutable std::vector<std::vector<std::unique_ptr<o2::dataformats::MCTruthContainer<o2::TrackReference>>>> mIndexedTrackRefs; //! the in-memory track ref container
+
+  size_t mMemoryLimit = 0;                                    // max estimated memory of the loaded entries, 0 = no limit
+  int mPrefetchDepth = 0;                                     // number of events to read ahead
+  mutable std::list<uint64_t> mLRUList;                       //! keys of the loaded entries, most recently queried first
+  mutable std::unordered_map<uint64_t, LRUEntry> mLRUEntries; //! bookkeeping of the loaded entries
+  mutable CacheStats mCacheStats;                             //! cache statistics
+  mutable Prefetcher* mPrefetcher = nullptr;                  //! asynchronous reader, if enabled
 
   bool mInitialized = false; // whether initialized
 };
@@ -146,46 +213,11 @@ inline MCTrack const* MCKinematicsReader::getTrack(int event, int track) const
   return getTrack(0, event, track);
 }
 
-inline std::vector<MCTrack> const& MCKinematicsReader::getTracks(int source, int event) const
-{
-  if (mTracks[source].size() == 0) {
-    initTracksForSource(source);
-  }
-  if (mTracks[source][event] == nullptr) {
-    loadTracksForSourceAndEvent(source, event);
-  }
-  return *mTracks[source][event];
-}
-
 inline std::vector<MCTrack> const& MCKinematicsReader::getTracks(int event) const
 {
   return getTracks(0, event);
 }
 
-inline o2::dataformats::MCEventHeader const& MCKinematicsReader::getMCEventHeader(int source, int event) const
-{
-  if (mHeaders.at(source).size() == 0) {
-    loadHeadersForSource(source);
-  }
-  return mHeaders.at(source)[event];
-}
-
-inline gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int source, int event, int track) const
-{
-  if (mIndexedTrackRefs[source].size() == 0) {
-    loadTrackRefsForSource(source);
-  }
-  return mIndexedTrackRefs[source][event].getLabels(track);
-}
-
-inline const std::vector<o2::TrackReference>& MCKinematicsReader::getTrackRefsByEvent(int source, int event) const
-{
-  if (mIndexedTrackRefs[source].size() == 0) {
-    loadTrackRefsForSource(source);
-  }
-  return mIndexedTrackRefs[source][event].getTruthArray();
-}
-
 inline gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int event, int track) const
 {
   return getTrackRefs(0, event, track);
@@ -196,13 +228,5 @@ inline size_t MCKinematicsReader::getNSources() const
   return mTracks.size();
 }
 
-inline size_t MCKinematicsReader::getNEvents(int source) const
-{
-  if (mTracks[source].size() == 0) {
-    initTracksForSource(source);
-  }
-  return mTracks[source].size();
-}
-
 } // namespace steer
 } // namespace o2
@@ -13,13 +13,44 @@
 #include "SimulationDataFormat/MCEventHeader.h"
 #include "SimulationDataFormat/TrackReference.h"
 #include <TChain.h>
+#include <TROOT.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <thread>
 #include <vector>
 #include "FairLogger.h"
 
 using namespace o2::steer;
 
+namespace
+{
+constexpr uint64_t NoEntry = std::numeric_limits<uint64_t>::max();
+}
+
+/// reader of the tracks ahead of the queries, with its own copies of the input chains
+struct MCKinematicsReader::Prefetcher {
+  std::thread thread;
+  std::mutex mutex;                            // protects the cache of the reader
+  std::condition_variable cond;                // signals new requests and finished reading
+  std::deque<std::pair<int, int>> queue;       // source and event of the tracks to read
+  uint64_t inFlight = NoEntry;                 // key of the tracks being read
+  int lastSource = -1;                         // source and event of the last scheduling
+  int lastEvent = -1;
+  std::vector<std::unique_ptr<TChain>> chains; // per source
+  bool stop = false;
+};
+
 MCKinematicsReader::~MCKinematicsReader()
 {
+  stopPrefetcher();
+  for (auto& tracksSource : mTracks) {
+    for (auto tracks : tracksSource) {
+      delete tracks;
+    }
+  }
+
   for (auto chain : mInputChains) {
     delete chain;
   }
@@ -49,65 +80,71 @@ void MCKinematicsReader::initIndexedTrackRefs(std::vector<o2::TrackReference>& r
   }
 }
 
-void MCKinematicsReader::initTracksForSource(int source) const
+void MCKinematicsReader::initSource(int source) const
 {
   auto chain = mInputChains[source];
   if (chain) {
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
-    mTracks[source].resize(br->GetEntries(), nullptr);
+    auto nEvents = br ? br->GetEntries() : 0;
+    mTracks[source].resize(nEvents, nullptr);
+    mHeaders[source].resize(nEvents);
+    mIndexedTrackRefs[source].resize(nEvents);
   }
 }
 
-void MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
+std::vector<o2::MCTrack>* MCKinematicsReader::readTracks(TChain* chain, int event)
 {
-  auto chain = mInputChains[source];
+  // read the tracks of the event, the caller takes the ownership
+  std::vector<o2::MCTrack>* loadtracks = nullptr;
   if (chain) {
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCTrack");
     if (br) {
-      std::vector<MCTrack>* loadtracks = nullptr;
       br->SetAddress(&loadtracks);
       br->GetEntry(event);
-      mTracks[source][event] = new std::vector<o2::MCTrack>;
-      *mTracks[source][event] = *loadtracks;
-      delete loadtracks;
     }
   }
+  return loadtracks;
+}
+
+void MCKinematicsReader::loadTracksForSourceAndEvent(int source, int event) const
+{
+  auto tracks = readTracks(mInputChains[source], event);
+  mTracks[source][event] = tracks ? tracks : new std::vector<o2::MCTrack>;
+  registerEntry(getEntryKey(EntryType::kTracks, source, event), getTracksSize(*mTracks[source][event]));
 }
 
 void MCKinematicsReader::releaseTracksForSourceAndEvent(int source, int eventID)
 {
+  auto lock = lockCache();
   if (mTracks.at(source).at(eventID) != nullptr) {
-    delete mTracks[source][eventID];
-    mTracks[source][eventID] = nullptr;
+    releaseEntry(getEntryKey(EntryType::kTracks, source, eventID));
   }
 }
 
-void MCKinematicsReader::loadHeadersForSource(int source) const
+void MCKinematicsReader::loadHeaderForSourceAndEvent(int source, int event) const
 {
+  o2::dataformats::MCEventHeader* header = nullptr;
   auto chain = mInputChains[source];
   if (chain) {
     // todo: get name from NameConfig
     auto br = chain->GetBranch("MCEventHeader.");
     if (br) {
-      o2::dataformats::MCEventHeader* header = nullptr;
       br->SetAddress(&header);
-      mHeaders[source].resize(br->GetEntries());
-      for (int event = 0; event < br->GetEntries(); ++event) {
-        br->GetEntry(event);
-        mHeaders[source][event] = *header;
-      }
-      delete header;
-      header = nullptr;
+      br->GetEntry(event);
     } else {
       LOG(WARN) << "MCHeader branch not found";
     }
   }
+  mHeaders[source][event].reset(header ? header : new o2::dataformats::MCEventHeader);
+  registerEntry(getEntryKey(EntryType::kHeader, source, event), sizeof(o2::dataformats::MCEventHeader));
 }
 
-void MCKinematicsReader::loadTrackRefsForSource(int source) const
+void MCKinematicsReader::loadTrackRefsForSourceAndEvent(int source, int event) const
 {
+  auto& indexedrefs = mIndexedTrackRefs[source][event];
+  indexedrefs = std::make_unique<o2::dataformats::MCTruthContainer<o2::TrackReference>>();
   auto chain = mInputChains[source];
   if (chain) {
     // todo: get name from NameConfig
@@ -115,20 +152,290 @@ void MCKinematicsReader::loadTrackRefsForSource(int source) const
     if (br) {
       std::vector<o2::TrackReference>* refs = nullptr;
       br->SetAddress(&refs);
-      mIndexedTrackRefs[source].resize(br->GetEntries());
-      for (int event = 0; event < br->GetEntries(); ++event) {
-        br->GetEntry(event);
-        if (refs) {
-          // we convert the original flat vector into an indexed structure
-          initIndexedTrackRefs(*refs, mIndexedTrackRefs[source][event]);
-          delete refs;
-          refs = nullptr;
-        }
+      br->GetEntry(event);
+      if (refs) {
+        // we convert the original flat vector into an indexed structure
+        initIndexedTrackRefs(*refs, *indexedrefs);
+        delete refs;
+        refs = nullptr;
       }
     } else {
       LOG(WARN) << "TrackRefs branch not found";
     }
   }
+  registerEntry(getEntryKey(EntryType::kTrackRefs, source, event),
+                sizeof(*indexedrefs) + indexedrefs->getNElements() * sizeof(o2::TrackReference) + indexedrefs->getIndexedSize() * sizeof(o2::dataformats::MCTruthHeaderElement));
+}
+
+std::vector<o2::MCTrack> const& MCKinematicsReader::getTracks(int source, int event) const
+{
+  auto lock = lockCache();
+  queryEntry(EntryType::kTracks, source, event);
+  if (mPrefetchDepth > 0) {
+    schedulePrefetch(source, event);
+  }
+  return *mTracks[source][event];
+}
+
+o2::dataformats::MCEventHeader const& MCKinematicsReader::getMCEventHeader(int source, int event) const
+{
+  auto lock = lockCache();
+  queryEntry(EntryType::kHeader, source, event);
+  return *mHeaders[source][event];
+}
+
+gsl::span<o2::TrackReference> MCKinematicsReader::getTrackRefs(int source, int event, int track) const
+{
+  auto lock = lockCache();
+  queryEntry(EntryType::kTrackRefs, source, event);
+  return mIndexedTrackRefs[source][event]->getLabels(track);
+}
+
+const std::vector<o2::TrackReference>& MCKinematicsReader::getTrackRefsByEvent(int source, int event) const
+{
+  auto lock = lockCache();
+  queryEntry(EntryType::kTrackRefs, source, event);
+  return mIndexedTrackRefs[source][event]->getTruthArray();
+}
+
+size_t MCKinematicsReader::getNEvents(int source) const
+{
+  auto lock = lockCache();
+  if (mTracks[source].size() == 0) {
+    initSource(source);
+  }
+  return mTracks[source].size();
+}
+
+bool MCKinematicsReader::isLoaded(EntryType type, int source, int event) const
+{
+  switch (type) {
+    case EntryType::kTracks:
+      return mTracks[source][event] != nullptr;
+    case EntryType::kHeader:
+      return mHeaders[source][event] != nullptr;
+    case EntryType::kTrackRefs:
+      return mIndexedTrackRefs[source][event] != nullptr;
+  }
+  return false;
+}
+
+void MCKinematicsReader::queryEntry(EntryType type, int source, int event) const
+{
+  // make sure the entry is loaded and mark it as the most recently used, must be called with the cache locked
+  if (mTracks.at(source).size() == 0) {
+    initSource(source);
+  }
+  auto key = getEntryKey(type, source, event);
+  if (mPrefetcher && mPrefetcher->inFlight == key) { // being read ahead, wait rather than reading it again
+    std::unique_lock<std::mutex> lock(mPrefetcher->mutex, std::adopt_lock);
+    mPrefetcher->cond.wait(lock, [this, key] { return mPrefetcher->inFlight != key; });
+    lock.release(); // the lock is owned by the caller
+  }
+  if (isLoaded(type, source, event)) {
+    mCacheStats.nHits++;
+    touchEntry(key);
+  } else {
+    mCacheStats.nMisses++;
+    switch (type) {
+      case EntryType::kTracks:
+        loadTracksForSourceAndEvent(source, event);
+        break;
+      case EntryType::kHeader:
+        loadHeaderForSourceAndEvent(source, event);
+        break;
+      case EntryType::kTrackRefs:
+        loadTrackRefsForSourceAndEvent(source, event);
+        break;
+    }
+  }
+  evictEntries(key);
+}
+
+void MCKinematicsReader::registerEntry(uint64_t key, size_t size, bool prefetched) const
+{
+  mLRUList.push_front(key);
+  mLRUEntries[key] = LRUEntry{mLRUList.begin(), size, prefetched};
+  mCacheStats.memory += size;
+  mCacheStats.memoryPeak = std::max(mCacheStats.memoryPeak, mCacheStats.memory);
+}
+
+void MCKinematicsReader::touchEntry(uint64_t key) const
+{
+  auto entry = mLRUEntries.find(key);
+  if (entry == mLRUEntries.end()) {
+    return;
+  }
+  if (entry->second.prefetched) {
+    entry->second.prefetched = false;
+    mCacheStats.nPrefetchHits++;
+  }
+  mLRUList.splice(mLRUList.begin(), mLRUList, entry->second.pos);
+}
+
+void MCKinematicsReader::releaseEntry(uint64_t key) const
+{
+  auto entry = mLRUEntries.find(key);
+  if (entry != mLRUEntries.end()) {
+    mCacheStats.memory -= entry->second.size;
+    mLRUList.erase(entry->second.pos);
+    mLRUEntries.erase(entry);
+  }
+  int source = (key >> 32) & 0xffffff, event = uint32_t(key);
+  switch (EntryType(key >> 56)) {
+    case EntryType::kTracks:
+      delete mTracks[source][event];
+      mTracks[source][event] = nullptr;
+      break;
+    case EntryType::kHeader:
+      mHeaders[source][event].reset();
+      break;
+    case EntryType::kTrackRefs:
+      mIndexedTrackRefs[source][event].reset();
+      break;
+  }
+}
+
+void MCKinematicsReader::evictEntries(uint64_t keep) const
+{
+  // release the least recently used entries until the memory limit is respected, except the one to keep
+  if (!mMemoryLimit) {
+    return;
+  }
+  while (mCacheStats.memory > mMemoryLimit && !mLRUList.empty() && mLRUList.back() != keep) {
+    releaseEntry(mLRUList.back());
+    mCacheStats.nEvicted++;
+  }
+}
+
+std::unique_lock<std::mutex> MCKinematicsReader::lockCache() const
+{
+  // the cache needs to be protected only when it is filled also by the prefetcher
+  return mPrefetcher ? std::unique_lock<std::mutex>(mPrefetcher->mutex) : std::unique_lock<std::mutex>();
+}
+
+void MCKinematicsReader::startPrefetcher()
+{
+  // must be started before the queries, since they are synchronized only with the running prefetcher
+  if (mPrefetchDepth <= 0 || !mInitialized || mPrefetcher) {
+    return;
+  }
+  mPrefetcher = new Prefetcher();
+  for (auto chain : mInputChains) {
+    auto& chainCopy = mPrefetcher->chains.emplace_back();
+    if (chain) {
+      chainCopy = std::make_unique<TChain>(chain->GetName());
+      chainCopy->Add(chain);
+    }
+  }
+  mPrefetcher->thread = std::thread([this] { runPrefetcher(); });
+}
+
+void MCKinematicsReader::stopPrefetcher()
+{
+  if (!mPrefetcher) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mPrefetcher->mutex);
+    mPrefetcher->stop = true;
+  }
+  mPrefetcher->cond.notify_all();
+  mPrefetcher->thread.join();
+  delete mPrefetcher;
+  mPrefetcher = nullptr;
+}
+
+void MCKinematicsReader::schedulePrefetch(int source, int event) const
+{
+  // request reading of the tracks of the next events of the source, must be called with the cache locked
+  auto& pf = *mPrefetcher;
+  if (source == pf.lastSource && event == pf.lastEvent) {
+    return;
+  }
+  pf.lastSource = source;
+  pf.lastEvent = event;
+  pf.queue.clear();
+  int nEvents = mTracks[source].size();
+  for (int ev = event + 1; ev <= event + mPrefetchDepth && ev < nEvents; ev++) {
+    if (!mTracks[source][ev] && getEntryKey(EntryType::kTracks, source, ev) != pf.inFlight) {
+      pf.queue.emplace_back(source, ev);
+    }
+  }
+  if (!pf.queue.empty()) {
+    pf.cond.notify_all();
+  }
+}
+
+void MCKinematicsReader::runPrefetcher() const
+{
+  auto& pf = *mPrefetcher;
+  std::unique_lock<std::mutex> lock(pf.mutex);
+  while (true) {
+    pf.cond.wait(lock, [&pf] { return pf.stop || !pf.queue.empty(); });
+    if (pf.stop) {
+      break;
+    }
+    auto [source, event] = pf.queue.front();
+    pf.queue.pop_front();
+    if (mTracks[source][event]) {
+      continue;
+    }
+    auto key = getEntryKey(EntryType::kTracks, source, event);
+    pf.inFlight = key;
+    lock.unlock();
+    auto tracks = readTracks(pf.chains[source].get(), event);
+    lock.lock();
+    pf.inFlight = NoEntry;
+    // the prefetched tracks may not evict the entries which were queried
+    if (tracks && !mTracks[source][event] && (!mMemoryLimit || mCacheStats.memory + getTracksSize(*tracks) <= mMemoryLimit)) {
+      mTracks[source][event] = tracks;
+      registerEntry(key, getTracksSize(*tracks), true);
+      mCacheStats.nPrefetched++;
+    } else {
+      delete tracks;
+    }
+    pf.cond.notify_all();
+  }
+}
+
+void MCKinematicsReader::setMemoryLimit(size_t bytes)
+{
+  auto lock = lockCache();
+  mMemoryLimit = bytes;
+  evictEntries(NoEntry);
+}
+
+void MCKinematicsReader::setPrefetchDepth(int nEvents)
+{
+  stopPrefetcher();
+  mPrefetchDepth = std::max(nEvents, 0);
+  if (mPrefetchDepth > 0) {
+    ROOT::EnableThreadSafety(); // the prefetcher reads its copies of the chains concurrently with the queries
+    startPrefetcher();
+  }
+}
+
+MCKinematicsReader::CacheStats MCKinematicsReader::getCacheStats() const
+{
+  auto lock = lockCache();
+  return mCacheStats;
+}
+
+void MCKinematicsReader::resetCacheStats()
+{
+  auto lock = lockCache();
+  auto memory = mCacheStats.memory;
+  mCacheStats = CacheStats();
+  mCacheStats.memory = mCacheStats.memoryPeak = memory;
+}
+
+void MCKinematicsReader::printCacheStats() const
+{
+  auto st = getCacheStats();
+  LOG(INFO) << "MCKinematicsReader cache: " << st.nHits << " hits, " << st.nMisses << " misses (hit rate " << st.getHitRate() * 100.f
+            << "%), " << st.nPrefetched << " events prefetched, " << st.nPrefetchHits << " of them used, " << st.nEvicted << " entries evicted, memory "
+            << st.memory / 1024 << " kB (peak " << st.memoryPeak / 1024 << " kB, limit " << mMemoryLimit / 1024 << " kB)";
 }
 
 bool MCKinematicsReader::initFromDigitContext(std::string_view name)
@@ -156,6 +463,7 @@ bool MCKinematicsReader::initFromDigitContext(std::string_view name)
   // actual loading will be done only if someone asks
   // the first time for a particular source ...
 
+  startPrefetcher();
   return true;
 }
 
@@ -172,5 +480,6 @@ bool MCKinematicsReader::initFromKinematics(std::string_view name)
   mIndexedTrackRefs.resize(1);
   mInitialized = true;
 
+  startPrefetcher();
   return true;
 }
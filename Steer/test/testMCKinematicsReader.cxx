@@ -0,0 +1,161 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test MCKinematicsReader class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "Steer/MCKinematicsReader.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+namespace o2
+{
+namespace steer
+{
+
+const std::string Prefix = "mckinereader";
+constexpr int NEvents = 20;
+
+int getNTracks(int event) { return 10 + 5 * event; }
+
+// event and track IDs are stored in the momentum of the tracks
+bool checkTracks(const std::vector<MCTrack>& tracks, int event)
+{
+  if (int(tracks.size()) != getNTracks(event)) {
+    return false;
+  }
+  for (int i = 0; i < int(tracks.size()); i++) {
+    if (tracks[i].GetStartVertexMomentumX() != event || tracks[i].GetStartVertexMomentumY() != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct KinematicsFile {
+  KinematicsFile()
+  {
+    TFile file(o2::base::NameConf::getMCKinematicsFileName(Prefix).c_str(), "RECREATE");
+    TTree tree("o2sim", "");
+    std::vector<MCTrack> tracks, *tracksPtr = &tracks;
+    tree.Branch("MCTrack", &tracksPtr);
+    for (int ev = 0; ev < NEvents; ev++) {
+      tracks.clear();
+      for (int i = 0; i < getNTracks(ev); i++) {
+        tracks.emplace_back(211, -1, -1, -1, -1, ev, i, 0., 0., 0., 0., 0., 0);
+      }
+      tree.Fill();
+    }
+    tree.Write();
+    file.Close();
+  }
+  ~KinematicsFile() { std::remove(o2::base::NameConf::getMCKinematicsFileName(Prefix).c_str()); }
+};
+
+BOOST_GLOBAL_FIXTURE(KinematicsFile);
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReader_eviction)
+{
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  BOOST_REQUIRE(reader.getNEvents(0) == NEvents);
+  // room for the tracks of ~3 largest events
+  const size_t limit = 3 * (sizeof(std::vector<MCTrack>) + getNTracks(NEvents - 1) * sizeof(MCTrack));
+  reader.setMemoryLimit(limit);
+  for (int ev = 0; ev < NEvents; ev++) {
+    BOOST_CHECK(checkTracks(reader.getTracks(ev), ev));
+  }
+  auto st = reader.getCacheStats();
+  BOOST_CHECK_EQUAL(st.nMisses, NEvents);
+  BOOST_CHECK_EQUAL(st.nHits, 0);
+  BOOST_CHECK(st.nEvicted > 0 && st.nEvicted < NEvents);
+  BOOST_CHECK(st.memory <= limit);
+
+  // the last event is still in memory, the first one was evicted and is reloaded correctly
+  BOOST_CHECK(checkTracks(reader.getTracks(NEvents - 1), NEvents - 1));
+  BOOST_CHECK_EQUAL(reader.getCacheStats().nHits, 1);
+  BOOST_CHECK(checkTracks(reader.getTracks(0), 0));
+  BOOST_CHECK_EQUAL(reader.getCacheStats().nMisses, NEvents + 1);
+  auto track = reader.getTrack(5, 7);
+  BOOST_CHECK(track->GetStartVertexMomentumX() == 5 && track->GetStartVertexMomentumY() == 7);
+
+  // the explicit release and the lowering of the limit free the memory
+  reader.releaseTracksForSourceAndEvent(0, 5);
+  reader.setMemoryLimit(1);
+  st = reader.getCacheStats();
+  BOOST_CHECK_EQUAL(st.memory, 0);
+  BOOST_CHECK(checkTracks(reader.getTracks(5), 5));
+  BOOST_CHECK_EQUAL(reader.getCacheStats().nMisses, NEvents + 3);
+}
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReader_prefetch)
+{
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  reader.setPrefetchDepth(3);
+  BOOST_CHECK(checkTracks(reader.getTracks(0), 0)); // schedules reading of the events 1-3
+  for (int i = 0; i < 1000 && reader.getCacheStats().nPrefetched < 3; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_REQUIRE_EQUAL(reader.getCacheStats().nPrefetched, 3);
+  for (int ev = 1; ev <= 3; ev++) {
+    BOOST_CHECK(checkTracks(reader.getTracks(ev), ev));
+  }
+  auto st = reader.getCacheStats();
+  BOOST_CHECK_EQUAL(st.nMisses, 1);
+  BOOST_CHECK_EQUAL(st.nHits, 3);
+  BOOST_CHECK_EQUAL(st.nPrefetchHits, 3);
+  BOOST_CHECK(st.getHitRate() == 0.75f);
+  reader.resetCacheStats();
+  BOOST_CHECK_EQUAL(reader.getCacheStats().nHits, 0);
+}
+
+BOOST_AUTO_TEST_CASE(MCKinematicsReader_concurrent)
+{
+  MCKinematicsReader reader(Prefix, MCKinematicsReader::Mode::kMCKine);
+  reader.setPrefetchDepth(4);
+  constexpr int NThreads = 4;
+  std::atomic<int> nErrors{0}, nQueries{0};
+  std::vector<std::thread> threads;
+  for (int ith = 0; ith < NThreads; ith++) {
+    threads.emplace_back([&reader, &nErrors, &nQueries, ith]() {
+      for (int iev = 0; iev < NEvents; iev++) {
+        int ev = (iev + ith * NEvents / NThreads) % NEvents; // the threads start at different events
+        if (!checkTracks(reader.getTracks(ev), ev)) {
+          nErrors++;
+        }
+        for (int i = 0; i < getNTracks(ev); i += 7) {
+          auto track = reader.getTrack(ev, i);
+          if (track->GetStartVertexMomentumX() != ev || track->GetStartVertexMomentumY() != i) {
+            nErrors++;
+          }
+          nQueries++;
+        }
+        nQueries++;
+      }
+    });
+  }
+  for (auto& th : threads) {
+    th.join();
+  }
+  BOOST_CHECK_EQUAL(nErrors.load(), 0);
+  auto st = reader.getCacheStats();
+  BOOST_CHECK_EQUAL(st.nHits + st.nMisses, nQueries.load());
+  BOOST_CHECK_EQUAL(st.nMisses + st.nPrefetched, NEvents); // every event was read once, w/o memory limit nothing is evicted
+  BOOST_CHECK_EQUAL(st.nEvicted, 0);
+}
+
+} // namespace steer
+} // namespace o2
@@ -19,12 +19,15 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 #include "Framework/DataProcessorSpec.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/Task.h"
+#include "Framework/ConcreteDataMatcher.h"
 
 class FairMQDevice;
+class FairMQMessage;
 
 namespace o2::monitoring
 {
@@ -62,17 +65,27 @@ class Dispatcher : public framework::Task
   framework::Options getOptions();
 
  private:
+  /// a policy accepting an input together with the output data type it routes the input to
+  struct PolicyRoute {
+    DataSamplingPolicy* policy;
+    framework::ConcreteDataTypeMatcher output;
+  };
+
+  const std::vector<PolicyRoute>& getPolicyRoutes(const framework::ConcreteDataMatcher& input);
   DataSamplingHeader prepareDataSamplingHeader(const DataSamplingPolicy& policy, const framework::DeviceSpec& spec);
   header::Stack extractAdditionalHeaders(const char* inputHeaderStack) const;
   void reportStats(monitoring::Monitoring& monitoring) const;
-  void send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, framework::Output&& output) const;
-  void sendFairMQ(FairMQDevice* device, const framework::DataRef& inputData, const std::string& fairMQChannel,
-                  header::Stack&& stack) const;
+  void send(framework::DataAllocator& dataAllocator, const framework::DataRef& inputData, FairMQMessage* inputPayload,
+            framework::Output&& output) const;
+  void sendFairMQ(FairMQDevice* device, const framework::DataRef& inputData, FairMQMessage* inputPayload,
+                  const std::string& fairMQChannel, header::Stack&& stack) const;
 
   std::string mName;
   std::string mReconfigurationSource;
   // policies should be shared between all pipeline threads
   std::vector<std::shared_ptr<DataSamplingPolicy>> mPolicies;
+  // policies matching each input seen so far, so they are not searched for every message
+  std::unordered_map<framework::ConcreteDataMatcher, std::vector<PolicyRoute>> mPolicyRoutes;
 };
 
 } // namespace o2::utilities
@@ -21,12 +21,12 @@
 #include "Framework/DataSpecUtils.h"
 #include "Framework/Logger.h"
 #include "Framework/ConfigParamRegistry.h"
-#include "Framework/InputRecordWalker.h"
 
 #include "Framework/Monitoring.h"
 #include <Configuration/ConfigurationInterface.h>
 #include <Configuration/ConfigurationFactory.h>
 #include <fairmq/FairMQDevice.h>
+#include <vector>
 
 using namespace o2::configuration;
 using namespace o2::monitoring;
@@ -58,6 +58,7 @@ void Dispatcher::init(InitContext& ctx)
   } else {
     ; // we use policies declared during workflow init.
   }
+  mPolicyRoutes.clear();
 
   for (auto&& policyConfig : policiesTree) {
     // we don't want the Dispatcher to exit due to one faulty Policy
@@ -75,30 +76,44 @@ void Dispatcher::init(InitContext& ctx)
 
 void Dispatcher::run(ProcessingContext& ctx)
 {
-  for (const auto& input : InputRecordWalker(ctx.inputs())) {
-
-    const auto* inputHeader = header::get<header::DataHeader*>(input.header);
-    ConcreteDataMatcher inputMatcher{inputHeader->dataOrigin, inputHeader->dataDescription, inputHeader->subSpecification};
-
-    for (auto& policy : mPolicies) {
-      // todo: consider getting the outputSpec in match to improve performance
-      // todo: consider matching (and deciding) in completion policy to save some time
-
-      if (policy->match(inputMatcher) && policy->decide(input)) {
-        // We copy every header which is not DataHeader or DataProcessingHeader,
-        // so that custom data-dependent headers are passed forward,
-        // and we add a DataSamplingHeader.
+  auto& inputs = ctx.inputs();
+  for (size_t pos = 0; pos < inputs.size(); pos++) {
+    for (size_t part = 0; part < inputs.getNofParts(pos); part++) {
+      DataRef input = inputs.getByPos(pos, part);
+      if (input.header == nullptr) {
+        continue;
+      }
+      const auto* inputHeader = header::get<header::DataHeader*>(input.header);
+      if (inputHeader == nullptr) {
+        continue;
+      }
+      ConcreteDataMatcher inputMatcher{inputHeader->dataOrigin, inputHeader->dataDescription, inputHeader->subSpecification};
+
+      // The custom data-dependent headers (all but DataHeader and DataProcessingHeader) are passed forward
+      // together with a DataSamplingHeader. They are extracted once per input, if any policy accepts it.
+      header::Stack additionalHeaders;
+      bool additionalHeadersExtracted = false;
+
+      for (auto& route : getPolicyRoutes(inputMatcher)) {
+        // todo: consider matching (and deciding) in completion policy to save some time
+        auto& policy = *route.policy;
+        if (!policy.decide(input)) {
+          continue;
+        }
+        if (!additionalHeadersExtracted) {
+          additionalHeaders = extractAdditionalHeaders(input.header);
+          additionalHeadersExtracted = true;
+        }
         header::Stack headerStack{
-          std::move(extractAdditionalHeaders(input.header)),
-          std::move(prepareDataSamplingHeader(*policy.get(), ctx.services().get<const DeviceSpec>()))};
+          additionalHeaders,
+          prepareDataSamplingHeader(policy, ctx.services().get<const DeviceSpec>())};
 
-        if (!policy->getFairMQOutputChannel().empty()) {
-          sendFairMQ(ctx.services().get<RawDeviceService>().device(), input, policy->getFairMQOutputChannelName(),
-                     std::move(headerStack));
+        if (!policy.getFairMQOutputChannel().empty()) {
+          sendFairMQ(ctx.services().get<RawDeviceService>().device(), input, inputs.getPayloadMessage(pos, part),
+                     policy.getFairMQOutputChannelName(), std::move(headerStack));
         } else {
-          Output output = policy->prepareOutput(inputMatcher, input.spec->lifetime);
-          output.metaHeader = std::move(header::Stack{std::move(output.metaHeader), std::move(headerStack)});
-          send(ctx.outputs(), input, std::move(output));
+          Output output{route.output.origin, route.output.description, inputMatcher.subSpec, input.spec->lifetime, std::move(headerStack)};
+          send(ctx.outputs(), input, inputs.getPayloadMessage(pos, part), std::move(output));
         }
       }
     }
@@ -109,6 +124,24 @@ void Dispatcher::run(ProcessingContext& ctx)
   }
 }
 
+const std::vector<Dispatcher::PolicyRoute>& Dispatcher::getPolicyRoutes(const ConcreteDataMatcher& input)
+{
+  auto cached = mPolicyRoutes.find(input);
+  if (cached != mPolicyRoutes.end()) {
+    return cached->second;
+  }
+  // the first message of this kind, we look for the policies which match it
+  std::vector<PolicyRoute> routes;
+  for (auto& policy : mPolicies) {
+    const auto& paths = policy->getPathMap();
+    auto path = paths.find(input);
+    if (path != paths.end()) {
+      routes.push_back({policy.get(), DataSpecUtils::asConcreteDataTypeMatcher(path->second)});
+    }
+  }
+  return mPolicyRoutes.emplace(input, std::move(routes)).first->second;
+}
+
 void Dispatcher::reportStats(Monitoring& monitoring) const
 {
   uint64_t dispatcherTotalEvaluatedMessages = 0;
@@ -139,28 +172,41 @@ DataSamplingHeader Dispatcher::prepareDataSamplingHeader(const DataSamplingPolic
 
 header::Stack Dispatcher::extractAdditionalHeaders(const char* inputHeaderStack) const
 {
-  header::Stack headerStack;
+  // the headers are gathered in a buffer first, so that the stack is built in one go
+  std::vector<o2::byte> headers;
+  size_t last = 0;
 
   const auto* first = header::BaseHeader::get(reinterpret_cast<const byte*>(inputHeaderStack));
   for (const auto* current = first; current != nullptr; current = current->next()) {
     if (current->description != header::DataHeader::sHeaderType &&
         current->description != DataProcessingHeader::sHeaderType) {
-      headerStack = std::move(header::Stack{std::move(headerStack), *current});
+      if (!headers.empty()) {
+        reinterpret_cast<header::BaseHeader*>(headers.data() + last)->flagsNextHeader = true;
+      }
+      last = headers.size();
+      headers.insert(headers.end(), current->data(), current->data() + current->size());
+      reinterpret_cast<header::BaseHeader*>(headers.data() + last)->flagsNextHeader = false;
     }
   }
 
-  return headerStack;
+  return headers.empty() ? header::Stack{} : header::Stack{headers.data()};
 }
 
-void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, Output&& output) const
+void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, FairMQMessage* inputPayload,
+                      Output&& output) const
 {
   const auto* inputHeader = header::get<header::DataHeader*>(inputData.header);
-  dataAllocator.snapshot(output, inputData.payload, inputHeader->payloadSize, inputHeader->payloadSerializationMethod);
+  if (inputPayload != nullptr) {
+    // we share the received message instead of copying the payload
+    dataAllocator.forward(output, *inputPayload, inputHeader->payloadSerializationMethod);
+  } else {
+    dataAllocator.snapshot(output, inputData.payload, inputHeader->payloadSize, inputHeader->payloadSerializationMethod);
+  }
 }
 
 // ideally this should be in a separate proxy device or use Lifetime::External
-void Dispatcher::sendFairMQ(FairMQDevice* device, const DataRef& inputData, const std::string& fairMQChannel,
-                            header::Stack&& stack) const
+void Dispatcher::sendFairMQ(FairMQDevice* device, const DataRef& inputData, FairMQMessage* inputPayload,
+                            const std::string& fairMQChannel, header::Stack&& stack) const
 {
   const auto* dh = header::get<header::DataHeader*>(inputData.header);
   assert(dh);
@@ -175,10 +221,14 @@ void Dispatcher::sendFairMQ(FairMQDevice* device, const DataRef& inputData, cons
   auto channelAlloc = o2::pmr::getTransportAllocator(device->Transport());
   FairMQMessagePtr msgHeaderStack = o2::pmr::getMessage(std::move(headerStack), channelAlloc);
 
-  char* payloadCopy = new char[dh->payloadSize];
-  memcpy(payloadCopy, inputData.payload, dh->payloadSize);
-  auto cleanupFcn = [](void* data, void*) { delete[] reinterpret_cast<char*>(data); };
-  FairMQMessagePtr msgPayload(device->NewMessage(payloadCopy, dh->payloadSize, cleanupFcn, payloadCopy));
+  FairMQMessagePtr msgPayload(device->NewMessageFor(fairMQChannel, 0));
+  if (inputPayload != nullptr && inputPayload->GetType() == msgPayload->GetType()) {
+    // the payload buffer is shared with the received message
+    msgPayload->Copy(*inputPayload);
+  } else {
+    msgPayload = device->NewMessageFor(fairMQChannel, 0, dh->payloadSize);
+    memcpy(msgPayload->GetData(), inputData.payload, dh->payloadSize);
+  }
 
   FairMQParts message;
   message.AddPart(move(msgHeaderStack));
@@ -190,6 +240,7 @@ void Dispatcher::sendFairMQ(FairMQDevice* device, const DataRef& inputData, cons
 void Dispatcher::registerPolicy(std::unique_ptr<DataSamplingPolicy>&& policy)
 {
   mPolicies.emplace_back(std::move(policy));
+  mPolicyRoutes.clear();
 }
 
 const std::string& Dispatcher::getName()
@@ -41,9 +41,12 @@ void customize(std::vector<ConfigParamSpec>& workflowOptions)
     ConfigParamSpec{"throttling", VariantType::Int, 0, {"stop producing messages if freeram < throttling * 1MB"}});
   workflowOptions.push_back(ConfigParamSpec{
     "fill", VariantType::Bool, false, {"should fill the messages (prevents memory overcommitting)"}});
+  workflowOptions.push_back(ConfigParamSpec{
+    "policies", VariantType::Int, 1, {"number of policies, the additional ones sample the data of one producer each"}});
 }
 
 #include <memory>
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
@@ -132,16 +135,15 @@ WorkflowSpec defineDataProcessing(ConfigContext const& config)
   size_t testDuration = config.options().get<int>("test-duration");
   size_t throttlingMB = config.options().get<int>("throttling");
   bool fill = config.options().get<bool>("fill");
+  size_t policies = std::max(config.options().get<int>("policies"), 1);
 
-  std::string configurationPath = "/tmp/dataSamplingBenchmark-" + std::to_string(samplingFraction) + ".json";
-  std::string configuration =
-    "{\n"
-    "  \"dataSamplingPolicies\": [\n"
+  auto policyConfiguration = [samplingFraction](const std::string& id, const std::string& query) {
+    return
     "    {\n"
-    "      \"id\": \"benchmark\",\n"
+    "      \"id\": \"" + id + "\",\n"
     "      \"active\": \"true\",\n"
     "      \"machines\": [],\n"
-    "      \"query\": \"TST:TST/RAWDATA\",\n"
+    "      \"query\": \"" + query + "\",\n"
     "      \"samplingConditions\": [\n"
     "        {\n"
     "          \"condition\": \"random\",\n"
@@ -150,7 +152,22 @@ WorkflowSpec defineDataProcessing(ConfigContext const& config)
     "        }\n"
     "      ],\n"
     "      \"blocking\": \"false\"\n"
-    "    }\n"
+    "    }";
+  };
+
+  std::string configurationPath = "/tmp/dataSamplingBenchmark-" + std::to_string(samplingFraction) + "-" +
+                                  std::to_string(policies) + "-" + std::to_string(producers) + ".json";
+  std::string configuration =
+    "{\n"
+    "  \"dataSamplingPolicies\": [\n" +
+    policyConfiguration("benchmark", "TST:TST/RAWDATA");
+  // the additional policies test the cost of matching the inputs with many policies
+  for (size_t i = 1; i < policies; i++) {
+    configuration += ",\n" + policyConfiguration("benchmark" + std::to_string(i),
+                                                 "TST" + std::to_string(i) + ":TST/RAWDATA/" + std::to_string(i % std::max(producers, size_t(1))));
+  }
+  configuration +=
+    "\n"
     "  ]\n"
     "}";
 
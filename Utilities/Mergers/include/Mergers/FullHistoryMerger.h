@@ -62,7 +62,9 @@ class FullHistoryMerger : public framework::Task
   int mUpdatesReceived = 0;
 
  private:
+  static std::string getSourceID(const framework::DataRef& ref);
   void updateCache(const framework::DataRef& ref);
+  void updateCache(const std::vector<framework::DataRef>& refs);
   void mergeCache();
   void publish(framework::DataAllocator& allocator);
 };
@@ -0,0 +1,110 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file HistogramDelta.h
+/// \brief Sparse encoding of the bin differences of histograms, to be sent to Mergers instead of full objects
+
+#ifndef O2_HISTOGRAMDELTA_H
+#define O2_HISTOGRAMDELTA_H
+
+#include <TObject.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::mergers
+{
+
+/// \brief The bin differences of a histogram (TH1, TH2, TH3, THn, THnSparse) in a compact (bin, value) form.
+///
+/// It can be sent to Mergers expecting InputObjectsTimespan::LastDifference instead of the full object.
+/// Only the bins which changed are stored, so the size of the message and the cost of merging it are
+/// proportional to the number of changed bins, not to the size of the histogram. The bins of TH1 are stored
+/// as global bin numbers, the bins of THnBase as coordinates, so THnSparse can be extended on the fly.
+/// The first delta of a histogram should carry its prototype (an empty copy), which allows Mergers to create
+/// the merged histogram. The binning of the histogram must not change in between.
+class HistogramDelta : public TObject
+{
+ public:
+  HistogramDelta() = default;
+  HistogramDelta(const HistogramDelta&) = delete;
+  HistogramDelta& operator=(const HistogramDelta&) = delete;
+  ~HistogramDelta() override;
+
+  /// Encodes the difference between the current and the previous state of a histogram (nullptr - empty histogram).
+  /// If withPrototype is set, an empty copy of the current histogram is attached.
+  static std::unique_ptr<HistogramDelta> encode(const TObject& current, const TObject* previous, bool withPrototype);
+
+  /// Adds the differences to the target histogram, which should have the same binning.
+  void applyTo(TObject* target) const;
+  /// Appends the differences of the other delta of the same histogram.
+  void add(const HistogramDelta& other);
+  /// Creates the histogram with the differences applied from the attached prototype, or the provided one.
+  TObject* createTarget(const TObject* prototype = nullptr) const;
+
+  const TObject* getPrototype() const { return mPrototype; }
+  size_t getNBins() const { return mContents.size(); }
+  const char* GetName() const override { return mName.c_str(); }
+
+ private:
+  std::string mName;
+  TObject* mPrototype = nullptr;  // empty copy of the histogram, owned
+  int mDimensions = 0;            // number of coordinates of THnBase bins, 0 for TH1
+  std::vector<Long64_t> mBins;    // global bin numbers (TH1)
+  std::vector<Int_t> mCoordinates; // bin coordinates (THnBase), mDimensions per bin
+  std::vector<Double_t> mContents;
+  std::vector<Double_t> mErrors2; // empty if the histogram does not store the errors
+  std::vector<Double_t> mStats;   // differences of TH1::GetStats
+  Double_t mEntries = 0;
+
+  ClassDefOverride(HistogramDelta, 1);
+};
+
+/// \brief Encodes the differences of a histogram filled continuously by the producer, since the previous call.
+///
+/// It keeps the state of the histogram at the previous call, updating it with the deltas it produces.
+class HistogramDeltaEncoder
+{
+ public:
+  /// Returns the delta since the previous call. The first one carries the prototype.
+  std::unique_ptr<HistogramDelta> encode(const TObject& current);
+  /// Forgets the previous state, the next delta will contain the whole histogram and its prototype.
+  void reset() { mPrevious.reset(); }
+
+ private:
+  std::unique_ptr<TObject> mPrevious;
+};
+
+/// \brief Prepares the objects received by a Merger, which may contain HistogramDeltas, to be merged.
+///
+/// It keeps the prototypes carried by the deltas, since only the first delta of each histogram has it, while
+/// the merged object may be reset. A delta cannot be published, so where the target misses its histogram
+/// (also inside TCollections), the delta is replaced with the histogram created from the prototype.
+/// The deltas of a histogram whose prototype was never received (e.g. the Merger was restarted) are dropped
+/// and counted, otherwise every following merge would fail.
+class HistogramDeltaResolver
+{
+ public:
+  /// Returns the object to be merged into the target (nullptr if there is none yet): the same object modified
+  /// in place, its replacement (the original should be deleted by the caller) or nullptr if it should be dropped.
+  TObject* prepare(TObject* object, const TObject* target);
+
+  size_t getNDropped() const { return mNDropped; }
+  void resetNDropped() { mNDropped = 0; }
+
+ private:
+  std::unordered_map<std::string, std::unique_ptr<TObject>> mPrototypes;
+  size_t mNDropped = 0;
+};
+
+} // namespace o2::mergers
+
+#endif //O2_HISTOGRAMDELTA_H
@@ -19,10 +19,12 @@
 #include "Mergers/MergerConfig.h"
 #include "Mergers/MergeInterface.h"
 #include "Mergers/ObjectStore.h"
+#include "Mergers/HistogramDelta.h"
 
 #include "Framework/Task.h"
 
 #include <memory>
+#include <vector>
 
 class TObject;
 
@@ -51,11 +53,15 @@ class IntegratingMerger : public framework::Task
   void run(framework::ProcessingContext& ctx) override;
 
  private:
+  void mergePending();
+  ObjectStore createTarget(ObjectStore&& object);
   void publish(framework::DataAllocator& allocator);
 
  private:
   header::DataHeader::SubSpecificationType mSubSpec;
   ObjectStore mMergedObject = std::monostate{};
+  std::vector<ObjectStore> mPendingObjects; // deserialized, but not merged yet (MergingMode::Parallel)
+  HistogramDeltaResolver mDeltaResolver; // prototypes of histograms sent as HistogramDelta
   MergerConfig mConfig;
   std::unique_ptr<monitoring::Monitoring> mCollector;
 
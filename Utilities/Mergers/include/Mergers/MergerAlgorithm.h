@@ -18,6 +18,8 @@
 
 #include "Mergers/MergeInterface.h"
 
+#include <vector>
+
 class TObject;
 
 namespace o2::mergers::algorithm
@@ -25,6 +27,16 @@ namespace o2::mergers::algorithm
 
 /// \brief A function which merges TObjects
 void merge(TObject* const target, TObject* const other);
+/// \brief A function which merges all the others into the target with one Merge(TCollection*) call per (sub)object
+void merge(TObject* const target, const std::vector<TObject*>& others);
+/// \brief A function which merges all the objects into the first one, reducing them as a tree across threads
+///
+/// The objects are split into groups, each group is merged into its first object in a separate thread
+/// and the partial results are reduced in the same way until one object is left. Thus all the objects
+/// but the first one may be modified. nThreads <= 0 means the default number of threads.
+/// HistogramDeltas may be merged together in the partial results, but the first object must not be one.
+void reduce(const std::vector<TObject*>& objects, int nThreads = 0);
+void reduce(const std::vector<MergeInterface*>& objects, int nThreads = 0);
 void deleteTCollections(TObject* obj);
 
 } // namespace o2::mergers::algorithm
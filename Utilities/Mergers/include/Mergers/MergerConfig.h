@@ -40,6 +40,13 @@ enum class PublicationDecision {
   EachNSeconds,       // Merged object is published each N seconds.
 };
 
+enum class MergingMode {
+  Sequential, // Each received object is deserialized and merged into the target right away.
+  // Received objects are deserialized on a thread pool and merged in batches with one Merge call per target,
+  // reducing them across threads when possible. The parameter is the number of threads, 0 means the default.
+  Parallel
+};
+
 enum class TopologySize {
   NumberOfLayers, // User specifies the number of layers in topology.
   ReductionFactor // User specifies how many sources should be handled by one merger (by maximum).
@@ -57,6 +64,7 @@ struct MergerConfig {
   ConfigEntry<MergedObjectTimespan> mergedObjectTimespan = {MergedObjectTimespan::FullHistory};
   ConfigEntry<PublicationDecision> publicationDecision = {PublicationDecision::EachNSeconds, 10};
   ConfigEntry<TopologySize, int> topologySize = {TopologySize::NumberOfLayers, 1};
+  ConfigEntry<MergingMode, int> mergingMode = {MergingMode::Sequential, 0};
 };
 
 } // namespace o2::mergers
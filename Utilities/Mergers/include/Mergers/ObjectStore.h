@@ -18,6 +18,7 @@
 
 #include <variant>
 #include <memory>
+#include <vector>
 #include "Framework/DataRef.h"
 
 class TObject;
@@ -36,6 +37,8 @@ namespace object_store_helpers
 
 /// \brief Takes a DataRef, deserializes it (if type is supported) and puts into an ObjectStore
 ObjectStore extractObjectFrom(const framework::DataRef& ref);
+/// Deserializes the objects in the refs concurrently, using nThreads threads (<= 0 means the default).
+std::vector<ObjectStore> extractObjectsFrom(const std::vector<framework::DataRef>& refs, int nThreads = 0);
 
 } // namespace object_store_helpers
 
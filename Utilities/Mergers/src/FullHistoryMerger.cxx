@@ -53,10 +53,20 @@ void FullHistoryMerger::run(framework::ProcessingContext& ctx)
   // we have to avoid mistaking the timer input with data inputs.
   auto* timerHeader = ctx.inputs().get("timer-publish").header;
 
-  for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
-    if (ref.header != timerHeader) {
-      updateCache(ref);
-      mUpdatesReceived++;
+  if (mConfig.mergingMode.value == MergingMode::Parallel) {
+    std::vector<DataRef> refs;
+    for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
+      if (ref.header != timerHeader) {
+        refs.push_back(ref);
+      }
+    }
+    updateCache(refs);
+  } else {
+    for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
+      if (ref.header != timerHeader) {
+        updateCache(ref);
+        mUpdatesReceived++;
+      }
     }
   }
 
@@ -66,10 +76,42 @@ void FullHistoryMerger::run(framework::ProcessingContext& ctx)
   }
 }
 
+std::string FullHistoryMerger::getSourceID(const DataRef& ref)
+{
+  auto* dh = get<DataHeader*>(ref.header);
+  return std::string(dh->dataOrigin.str) + "/" + std::string(dh->dataDescription.str) + "/" + std::to_string(dh->subSpecification);
+}
+
+void FullHistoryMerger::updateCache(const std::vector<DataRef>& refs)
+{
+  // Only the latest object of each source is needed, the one stored serialized is handled as usual.
+  std::unordered_map<std::string, size_t> latest;
+  std::vector<DataRef> toDeserialize;
+  std::vector<std::string> sourceIDs;
+  for (const auto& ref : refs) {
+    auto sourceID = getSourceID(ref);
+    mUpdatesReceived++;
+    if (mFirstObjectSerialized.first.empty() || mFirstObjectSerialized.first == sourceID) {
+      updateCache(ref);
+    } else if (auto it = latest.find(sourceID); it != latest.end()) {
+      toDeserialize[it->second] = ref;
+    } else {
+      latest.emplace(sourceID, toDeserialize.size());
+      toDeserialize.push_back(ref);
+      sourceIDs.push_back(sourceID);
+    }
+  }
+
+  auto objects = object_store_helpers::extractObjectsFrom(toDeserialize, mConfig.mergingMode.param);
+  for (size_t i = 0; i < objects.size(); i++) {
+    mCache[sourceIDs[i]] = std::move(objects[i]);
+  }
+}
+
 void FullHistoryMerger::updateCache(const DataRef& ref)
 {
   auto* dh = get<DataHeader*>(ref.header);
-  std::string sourceID = std::string(dh->dataOrigin.str) + "/" + std::string(dh->dataDescription.str) + "/" + std::to_string(dh->subSpecification);
+  std::string sourceID = getSourceID(ref);
 
   // I am not sure if ref.spec is always a concrete spec and not a broader matcher. Comparing it this way should be safer.
   if (mFirstObjectSerialized.first.empty() || mFirstObjectSerialized.first == sourceID) {
@@ -103,7 +145,26 @@ void FullHistoryMerger::mergeCache()
   mObjectsMerged++;
 
   // We expect that all the objects use the same kind of interface
-  if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
+  if (mConfig.mergingMode.value == MergingMode::Parallel) {
+    // The cached objects are kept for the next publications, so they cannot hold partial results of
+    // a reduction. Instead, we merge all of them with a single call.
+    if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
+      std::vector<TObject*> others;
+      for (auto& [name, entry] : mCache) {
+        (void)name;
+        others.push_back(std::get<TObjectPtr>(entry).get());
+      }
+      algorithm::merge(std::get<TObjectPtr>(mMergedObject).get(), others);
+    } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
+      auto target = std::get<MergeInterfacePtr>(mMergedObject);
+      for (auto& [name, entry] : mCache) {
+        (void)name;
+        target->merge(std::get<MergeInterfacePtr>(entry).get());
+      }
+    }
+    mObjectsMerged += mCache.size();
+
+  } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
 
     auto target = std::get<TObjectPtr>(mMergedObject);
     for (auto& [name, entry] : mCache) {
@@ -0,0 +1,323 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file HistogramDelta.cxx
+/// \brief Implementation of the sparse encoding of the histogram differences
+
+#include "Mergers/HistogramDelta.h"
+#include "Mergers/MergerAlgorithm.h"
+
+#include "Framework/Logger.h"
+
+#include <TH1.h>
+#include <THnBase.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
+#include <TProfile3D.h>
+#include <TCollection.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace o2::mergers
+{
+
+namespace
+{
+
+bool sameAxis(const TAxis* a, const TAxis* b)
+{
+  return a->GetNbins() == b->GetNbins() && a->GetXmin() == b->GetXmin() && a->GetXmax() == b->GetXmax();
+}
+
+bool sameBinning(const TH1& a, const TH1& b)
+{
+  return a.GetDimension() == b.GetDimension() && a.GetNcells() == b.GetNcells() &&
+         sameAxis(a.GetXaxis(), b.GetXaxis()) && sameAxis(a.GetYaxis(), b.GetYaxis()) && sameAxis(a.GetZaxis(), b.GetZaxis());
+}
+
+bool sameBinning(const THnBase& a, const THnBase& b)
+{
+  if (a.GetNdimensions() != b.GetNdimensions()) {
+    return false;
+  }
+  for (Int_t d = 0; d < a.GetNdimensions(); d++) {
+    if (!sameAxis(a.GetAxis(d), b.GetAxis(d))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// histograms are not attached to the current directory, their lifetime is managed by us
+TObject* cloneDetached(const TObject& object)
+{
+  auto* clone = object.Clone();
+  if (auto h = dynamic_cast<TH1*>(clone)) {
+    h->SetDirectory(nullptr);
+  }
+  return clone;
+}
+
+TObject* makePrototype(const TObject& histogram)
+{
+  auto* prototype = cloneDetached(histogram);
+  if (auto h = dynamic_cast<TH1*>(prototype)) {
+    h->Reset();
+  } else if (auto h = dynamic_cast<THnBase*>(prototype)) {
+    h->Reset();
+  }
+  return prototype;
+}
+
+} // namespace
+
+HistogramDelta::~HistogramDelta()
+{
+  delete mPrototype;
+}
+
+std::unique_ptr<HistogramDelta> HistogramDelta::encode(const TObject& current, const TObject* previous, bool withPrototype)
+{
+  auto delta = std::make_unique<HistogramDelta>();
+  delta->mName = current.GetName();
+
+  if (auto h = dynamic_cast<const TH1*>(&current)) {
+    if (h->InheritsFrom(TProfile::Class()) || h->InheritsFrom(TProfile2D::Class()) || h->InheritsFrom(TProfile3D::Class())) {
+      throw std::runtime_error("The bin differences of the profile '" + delta->mName + "' cannot be merged, it is not supported.");
+    }
+    auto prev = dynamic_cast<const TH1*>(previous);
+    if (previous != nullptr && (prev == nullptr || !sameBinning(*h, *prev))) {
+      throw std::runtime_error("The binning of the histogram '" + delta->mName + "' differs from its previous state.");
+    }
+    const bool errors = h->GetSumw2N() > 0;
+    const bool prevErrors = prev != nullptr && prev->GetSumw2N() > 0;
+    for (Int_t bin = 0; bin < h->GetNcells(); bin++) {
+      Double_t content = h->GetBinContent(bin) - (prev ? prev->GetBinContent(bin) : 0.);
+      Double_t error2 = errors ? h->GetSumw2()->At(bin) - (prevErrors ? prev->GetSumw2()->At(bin) : 0.) : 0.;
+      if (content != 0. || error2 != 0.) {
+        delta->mBins.push_back(bin);
+        delta->mContents.push_back(content);
+        if (errors) {
+          delta->mErrors2.push_back(error2);
+        }
+      }
+    }
+    Double_t stats[TH1::kNstat] = {0}, prevStats[TH1::kNstat] = {0};
+    h->GetStats(stats);
+    if (prev) {
+      prev->GetStats(prevStats);
+    }
+    delta->mStats.resize(TH1::kNstat);
+    for (int i = 0; i < TH1::kNstat; i++) {
+      delta->mStats[i] = stats[i] - prevStats[i];
+    }
+    delta->mEntries = h->GetEntries() - (prev ? prev->GetEntries() : 0.);
+
+  } else if (auto h = dynamic_cast<const THnBase*>(&current)) {
+    auto prev = const_cast<THnBase*>(dynamic_cast<const THnBase*>(previous));
+    if (previous != nullptr && (prev == nullptr || !sameBinning(*h, *prev))) {
+      throw std::runtime_error("The binning of the histogram '" + delta->mName + "' differs from its previous state.");
+    }
+    delta->mDimensions = h->GetNdimensions();
+    const bool errors = h->GetCalculateErrors();
+    const bool prevErrors = prev != nullptr && prev->GetCalculateErrors();
+    std::vector<Int_t> coordinates(delta->mDimensions);
+    // for THnSparse only the filled bins are visited
+    for (Long64_t i = 0; i < h->GetNbins(); i++) {
+      Double_t content = h->GetBinContent(i, coordinates.data());
+      Double_t error2 = errors ? h->GetBinError2(i) : 0.;
+      if (prev) {
+        Long64_t prevBin = prev->GetBin(coordinates.data(), kFALSE);
+        if (prevBin >= 0) {
+          content -= prev->GetBinContent(prevBin);
+          error2 -= (errors && prevErrors) ? prev->GetBinError2(prevBin) : 0.;
+        }
+      }
+      if (content != 0. || error2 != 0.) {
+        delta->mCoordinates.insert(delta->mCoordinates.end(), coordinates.begin(), coordinates.end());
+        delta->mContents.push_back(content);
+        if (errors) {
+          delta->mErrors2.push_back(error2);
+        }
+      }
+    }
+    // the bins of THnSparse removed since the previous state (e.g. by Reset) are subtracted
+    if (prev) {
+      auto current = const_cast<THnBase*>(h);
+      for (Long64_t i = 0; i < prev->GetNbins(); i++) {
+        Double_t content = -prev->GetBinContent(i, coordinates.data());
+        if (current->GetBin(coordinates.data(), kFALSE) >= 0) {
+          continue; // already accounted for above
+        }
+        Double_t error2 = (errors && prevErrors) ? -prev->GetBinError2(i) : 0.;
+        if (content != 0. || error2 != 0.) {
+          delta->mCoordinates.insert(delta->mCoordinates.end(), coordinates.begin(), coordinates.end());
+          delta->mContents.push_back(content);
+          if (errors) {
+            delta->mErrors2.push_back(error2);
+          }
+        }
+      }
+    }
+    delta->mEntries = h->GetEntries() - (prev ? prev->GetEntries() : 0.);
+
+  } else {
+    throw std::runtime_error("Object with type '" + std::string(current.ClassName()) + "' cannot be encoded as HistogramDelta.");
+  }
+
+  if (withPrototype) {
+    delta->mPrototype = makePrototype(current);
+  }
+  return delta;
+}
+
+void HistogramDelta::applyTo(TObject* target) const
+{
+  if (target == nullptr) {
+    throw std::runtime_error("The target of HistogramDelta '" + mName + "' is nullptr");
+  }
+
+  if (auto h = dynamic_cast<TH1*>(target)) {
+    if (mDimensions != 0) {
+      throw std::runtime_error("HistogramDelta '" + mName + "' of THnBase cannot be applied to '" + h->ClassName() + "'.");
+    }
+    Double_t stats[TH1::kNstat] = {0};
+    h->GetStats(stats);
+    const Double_t entries = h->GetEntries();
+    auto* sumw2 = (h->GetSumw2N() > 0 && !mErrors2.empty()) ? h->GetSumw2() : nullptr;
+    for (size_t i = 0; i < mContents.size(); i++) {
+      if (mBins[i] < 0 || mBins[i] >= h->GetNcells()) {
+        throw std::runtime_error("HistogramDelta '" + mName + "' does not match the binning of the target.");
+      }
+      h->AddBinContent(static_cast<Int_t>(mBins[i]), mContents[i]);
+      if (sumw2) {
+        sumw2->fArray[mBins[i]] += mErrors2[i];
+      }
+    }
+    for (size_t i = 0; i < mStats.size() && i < TH1::kNstat; i++) {
+      stats[i] += mStats[i];
+    }
+    h->PutStats(stats);
+    h->SetEntries(entries + mEntries);
+
+  } else if (auto h = dynamic_cast<THnBase*>(target)) {
+    if (mDimensions != h->GetNdimensions()) {
+      throw std::runtime_error("HistogramDelta '" + mName + "' does not match the dimensions of the target.");
+    }
+    const Double_t entries = h->GetEntries();
+    const bool errors = h->GetCalculateErrors() && !mErrors2.empty();
+    for (size_t i = 0; i < mContents.size(); i++) {
+      Long64_t bin = h->GetBin(mCoordinates.data() + i * mDimensions, kTRUE);
+      h->AddBinContent(bin, mContents[i]);
+      if (errors) {
+        h->AddBinError2(bin, mErrors2[i]);
+      }
+    }
+    h->SetEntries(entries + mEntries);
+
+  } else {
+    throw std::runtime_error("HistogramDelta '" + mName + "' cannot be applied to the object of type '" + target->ClassName() + "'.");
+  }
+}
+
+void HistogramDelta::add(const HistogramDelta& other)
+{
+  if (mName != other.mName || mDimensions != other.mDimensions) {
+    throw std::runtime_error("HistogramDelta '" + other.mName + "' does not match HistogramDelta '" + mName + "'.");
+  }
+  if (mErrors2.size() != mContents.size() || other.mErrors2.size() != other.mContents.size()) {
+    // the errors are kept only if both have them
+    mErrors2.clear();
+  } else {
+    mErrors2.insert(mErrors2.end(), other.mErrors2.begin(), other.mErrors2.end());
+  }
+  mBins.insert(mBins.end(), other.mBins.begin(), other.mBins.end());
+  mCoordinates.insert(mCoordinates.end(), other.mCoordinates.begin(), other.mCoordinates.end());
+  mContents.insert(mContents.end(), other.mContents.begin(), other.mContents.end());
+  mStats.resize(std::max(mStats.size(), other.mStats.size()));
+  for (size_t i = 0; i < other.mStats.size(); i++) {
+    mStats[i] += other.mStats[i];
+  }
+  mEntries += other.mEntries;
+  if (mPrototype == nullptr && other.mPrototype != nullptr) {
+    mPrototype = cloneDetached(*other.mPrototype);
+  }
+}
+
+TObject* HistogramDelta::createTarget(const TObject* prototype) const
+{
+  if (mPrototype != nullptr) {
+    prototype = mPrototype;
+  }
+  if (prototype == nullptr) {
+    throw std::runtime_error("HistogramDelta '" + mName + "' has no prototype to create the merged histogram from.");
+  }
+  auto* target = cloneDetached(*prototype);
+  applyTo(target);
+  return target;
+}
+
+std::unique_ptr<HistogramDelta> HistogramDeltaEncoder::encode(const TObject& current)
+{
+  auto delta = HistogramDelta::encode(current, mPrevious.get(), mPrevious == nullptr);
+  if (mPrevious == nullptr) {
+    mPrevious.reset(delta->createTarget());
+  } else {
+    delta->applyTo(mPrevious.get());
+  }
+  return delta;
+}
+
+TObject* HistogramDeltaResolver::prepare(TObject* object, const TObject* target)
+{
+  if (auto delta = dynamic_cast<HistogramDelta*>(object)) {
+    auto& prototype = mPrototypes[delta->GetName()];
+    if (delta->getPrototype() != nullptr) {
+      prototype.reset(cloneDetached(*delta->getPrototype()));
+    }
+    if (target != nullptr) {
+      return object; // it is applied to the existing histogram
+    }
+    if (prototype == nullptr) {
+      if (mNDropped++ == 0) {
+        LOG(WARNING) << "The prototype of the histogram '" << delta->GetName()
+                     << "' was not received, its deltas are dropped";
+      }
+      return nullptr;
+    }
+    return delta->createTarget(prototype.get());
+  }
+
+  if (auto collection = dynamic_cast<TCollection*>(object)) {
+    auto targetCollection = dynamic_cast<const TCollection*>(target);
+    std::vector<TObject*> elements;
+    auto iterator = collection->MakeIterator();
+    while (auto element = iterator->Next()) {
+      elements.push_back(element);
+    }
+    delete iterator;
+
+    for (auto element : elements) {
+      auto targetElement = targetCollection ? targetCollection->FindObject(element->GetName()) : nullptr;
+      auto prepared = prepare(element, targetElement);
+      if (prepared != element) {
+        collection->Remove(element);
+        algorithm::deleteTCollections(element);
+        if (prepared != nullptr) {
+          collection->Add(prepared);
+        }
+      }
+    }
+  }
+  return object;
+}
+
+} // namespace o2::mergers
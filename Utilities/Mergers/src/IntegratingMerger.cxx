@@ -17,11 +17,13 @@
 
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerBuilder.h"
+#include "Mergers/HistogramDelta.h"
 
 #include <Monitoring/MonitoringFactory.h>
 
 #include "Framework/InputRecordWalker.h"
 #include "Framework/Logger.h"
+#include <iterator>
 //#include "Framework/DataRef.h"
 
 //using namespace o2;
@@ -31,6 +33,9 @@ using namespace o2::framework;
 namespace o2::mergers
 {
 
+// the max number of deserialized objects waiting to be merged in MergingMode::Parallel
+constexpr size_t maxPendingObjects = 256;
+
 IntegratingMerger::IntegratingMerger(const MergerConfig& config, const header::DataHeader::SubSpecificationType& subSpec)
   : mConfig(config),
     mSubSpec(subSpec)
@@ -48,30 +53,55 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
   // we have to avoid mistaking the timer input with data inputs.
   auto* timerHeader = ctx.inputs().get("timer-publish").header;
 
-  for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
-    if (ref.header != timerHeader) {
-      if (std::holds_alternative<std::monostate>(mMergedObject)) {
-        mMergedObject = object_store_helpers::extractObjectFrom(ref);
-
-      } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
-        // We expect that if the first object was TObject, then all should.
-        auto other = TObjectPtr(framework::DataRefUtils::as<TObject>(ref).release(), algorithm::deleteTCollections);
-        auto target = std::get<TObjectPtr>(mMergedObject);
-        algorithm::merge(target.get(), other.get());
-
-      } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
-        // We expect that if the first object inherited MergeInterface, then all should.
-        auto other = framework::DataRefUtils::as<MergeInterface>(ref);
-        std::get<MergeInterfacePtr>(mMergedObject)->merge(other.get());
-      } else {
-        throw std::runtime_error("mMergedObject' variant has no value.");
+  if (mConfig.mergingMode.value == MergingMode::Parallel) {
+    std::vector<DataRef> refs;
+    for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
+      if (ref.header != timerHeader) {
+        refs.push_back(ref);
+      }
+    }
+    auto objects = object_store_helpers::extractObjectsFrom(refs, mConfig.mergingMode.param);
+    mPendingObjects.insert(mPendingObjects.end(), std::make_move_iterator(objects.begin()), std::make_move_iterator(objects.end()));
+    // we merge in batches as large as possible, but we do not want to keep too many objects in memory
+    if (mPendingObjects.size() >= maxPendingObjects) {
+      mergePending();
+    }
+  } else {
+    for (const DataRef& ref : InputRecordWalker(ctx.inputs())) {
+      if (ref.header != timerHeader) {
+        if (std::holds_alternative<std::monostate>(mMergedObject)) {
+          mMergedObject = createTarget(object_store_helpers::extractObjectFrom(ref));
+          if (std::holds_alternative<std::monostate>(mMergedObject)) {
+            continue;
+          }
+
+        } else if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
+          // We expect that if the first object was TObject, then all should.
+          auto other = TObjectPtr(framework::DataRefUtils::as<TObject>(ref).release(), algorithm::deleteTCollections);
+          auto target = std::get<TObjectPtr>(mMergedObject);
+          auto prepared = mDeltaResolver.prepare(other.get(), target.get());
+          if (prepared == nullptr) {
+            continue;
+          } else if (prepared != other.get()) {
+            other = TObjectPtr(prepared, algorithm::deleteTCollections);
+          }
+          algorithm::merge(target.get(), other.get());
+
+        } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
+          // We expect that if the first object inherited MergeInterface, then all should.
+          auto other = framework::DataRefUtils::as<MergeInterface>(ref);
+          std::get<MergeInterfacePtr>(mMergedObject)->merge(other.get());
+        } else {
+          throw std::runtime_error("mMergedObject' variant has no value.");
+        }
+        mObjectsMerged++;
       }
-      mObjectsMerged++;
     }
   }
 
   if (ctx.inputs().isValid("timer-publish")) {
 
+    mergePending();
     publish(ctx.outputs());
 
     if (mConfig.mergedObjectTimespan.value == MergedObjectTimespan::LastDifference) {
@@ -80,6 +110,65 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
   }
 }
 
+void IntegratingMerger::mergePending()
+{
+  if (mPendingObjects.empty()) {
+    return;
+  }
+  auto first = mPendingObjects.begin();
+  while (std::holds_alternative<std::monostate>(mMergedObject) && first != mPendingObjects.end()) {
+    mMergedObject = createTarget(std::move(*first++));
+  }
+  if (std::holds_alternative<std::monostate>(mMergedObject)) {
+    mPendingObjects.clear();
+    return;
+  }
+  mObjectsMerged++;
+
+  // The pending objects are not used anywhere else, so they can serve as partial results of the reduction.
+  // We expect that all the objects use the same kind of interface.
+  if (std::holds_alternative<TObjectPtr>(mMergedObject)) {
+    auto* target = std::get<TObjectPtr>(mMergedObject).get();
+    std::vector<TObject*> objects{target};
+    for (auto it = first; it != mPendingObjects.end(); ++it) {
+      auto& other = std::get<TObjectPtr>(*it);
+      auto prepared = mDeltaResolver.prepare(other.get(), target);
+      if (prepared == nullptr) {
+        continue;
+      } else if (prepared != other.get()) {
+        other = TObjectPtr(prepared, algorithm::deleteTCollections);
+      }
+      objects.push_back(other.get());
+    }
+    algorithm::reduce(objects, mConfig.mergingMode.param);
+    mObjectsMerged += objects.size() - 1;
+  } else if (std::holds_alternative<MergeInterfacePtr>(mMergedObject)) {
+    std::vector<MergeInterface*> objects{std::get<MergeInterfacePtr>(mMergedObject).get()};
+    for (auto it = first; it != mPendingObjects.end(); ++it) {
+      objects.push_back(std::get<MergeInterfacePtr>(*it).get());
+    }
+    algorithm::reduce(objects, mConfig.mergingMode.param);
+    mObjectsMerged += objects.size() - 1;
+  } else {
+    throw std::runtime_error("mMergedObject' variant has no value.");
+  }
+  mPendingObjects.clear();
+}
+
+ObjectStore IntegratingMerger::createTarget(ObjectStore&& object)
+{
+  // A HistogramDelta cannot be published, the merged histograms are created from the prototypes.
+  if (auto tobject = std::get_if<TObjectPtr>(&object)) {
+    auto prepared = mDeltaResolver.prepare(tobject->get(), nullptr);
+    if (prepared == nullptr) {
+      return std::monostate{};
+    } else if (prepared != tobject->get()) {
+      return TObjectPtr(prepared, algorithm::deleteTCollections);
+    }
+  }
+  return std::move(object);
+}
+
 void IntegratingMerger::publish(framework::DataAllocator& allocator)
 {
   if (std::holds_alternative<std::monostate>(mMergedObject)) {
@@ -97,7 +186,9 @@ void IntegratingMerger::publish(framework::DataAllocator& allocator)
   mTotalObjectsMerged += mObjectsMerged;
   mCollector->send({mTotalObjectsMerged, "total_objects_merged"}, monitoring::DerivedMetricMode::RATE);
   mCollector->send({mObjectsMerged, "objects_merged_since_last_publication"});
+  mCollector->send({static_cast<int>(mDeltaResolver.getNDropped()), "deltas_dropped_since_last_publication"});
   mObjectsMerged = 0;
+  mDeltaResolver.resetNDropped();
 }
 
 } // namespace o2::mergers
@@ -16,6 +16,7 @@
 #include "Mergers/MergerAlgorithm.h"
 
 #include "Mergers/MergeInterface.h"
+#include "Mergers/HistogramDelta.h"
 
 #include <TH1.h>
 #include <TH2.h>
@@ -25,54 +26,135 @@
 #include <THnSparse.h>
 #include <TObjArray.h>
 #include <TGraph.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 namespace o2::mergers::algorithm
 {
 
+namespace
+{
+// The partial results of a reduction are not published, so they may hold deltas until they reach the final target.
+void mergeImpl(TObject* const target, const std::vector<TObject*>& others, bool partialResult);
+} // namespace
+
 void merge(TObject* const target, TObject* const other)
+{
+  merge(target, std::vector<TObject*>{other});
+}
+
+void merge(TObject* const target, const std::vector<TObject*>& others)
+{
+  mergeImpl(target, others, false);
+}
+
+namespace
+{
+void mergeImpl(TObject* const target, const std::vector<TObject*>& others, bool partialResult)
 {
   if (target == nullptr) {
     throw std::runtime_error("Merging target is nullptr");
   }
-  if (other == nullptr) {
-    throw std::runtime_error("Object to be merged in is nullptr");
+  for (auto other : others) {
+    if (other == nullptr) {
+      throw std::runtime_error("Object to be merged in is nullptr");
+    }
+    if (other == target) {
+      throw std::runtime_error("Merging target and the other object point to the same address");
+    }
   }
-  if (other == target) {
-    throw std::runtime_error("Merging target and the other object point to the same address");
+  if (others.empty()) {
+    return;
   }
   // fixme: should we check if names match?
 
   // We expect that both objects follow the same structure, but we allow to add missing objects to TCollections.
   // First we check if an object contains a MergeInterface, as it should overlap default Merge() methods of TObject.
-  if (auto custom = dynamic_cast<MergeInterface*>(target)) {
+  if (auto targetDelta = dynamic_cast<HistogramDelta*>(target)) {
+
+    // Deltas are merged together only when they serve as partial results of a reduction,
+    // otherwise they would end up in the merged object instead of the histograms.
+    if (!partialResult) {
+      throw std::runtime_error(std::string("The target object '") + target->GetName() +
+                               "' is a HistogramDelta, it can be merged into only as a partial result of a reduction.");
+    }
+    for (auto other : others) {
+      auto otherDelta = dynamic_cast<HistogramDelta*>(other);
+      if (otherDelta == nullptr) {
+        throw std::runtime_error(std::string("The target object '") + target->GetName() +
+                                 "' is a HistogramDelta, while the other object '" + other->GetName() + "' is not.");
+      }
+      targetDelta->add(*otherDelta);
+    }
 
-    custom->merge(dynamic_cast<MergeInterface* const>(other));
+  } else if (auto custom = dynamic_cast<MergeInterface*>(target)) {
+
+    for (auto other : others) {
+      custom->merge(dynamic_cast<MergeInterface* const>(other));
+    }
 
   } else if (auto targetCollection = dynamic_cast<TCollection*>(target)) {
 
-    auto otherCollection = dynamic_cast<TCollection*>(other);
-    if (otherCollection == nullptr) {
-      throw std::runtime_error(std::string("The target object '") + target->GetName() +
-                               "' is a TCollection, while the other object '" + other->GetName() + "' is not.");
+    // We gather the entries with the same name from all the others, so each of them is merged in one go.
+    std::vector<std::string> names;
+    std::unordered_map<std::string, std::vector<TObject*>> entries;
+    for (auto other : others) {
+      auto otherCollection = dynamic_cast<TCollection*>(other);
+      if (otherCollection == nullptr) {
+        throw std::runtime_error(std::string("The target object '") + target->GetName() +
+                                 "' is a TCollection, while the other object '" + other->GetName() + "' is not.");
+      }
+      auto otherIterator = otherCollection->MakeIterator();
+      while (auto otherObject = otherIterator->Next()) {
+        auto& entry = entries[otherObject->GetName()];
+        if (entry.empty()) {
+          names.emplace_back(otherObject->GetName());
+        }
+        entry.push_back(otherObject);
+      }
+      delete otherIterator;
     }
 
-    auto otherIterator = otherCollection->MakeIterator();
-    while (auto otherObject = otherIterator->Next()) {
-      TObject* targetObject = targetCollection->FindObject(otherObject->GetName());
-      if (targetObject) {
-        // That might be another collection or a concrete object to be merged, we walk on the collection recursively.
-        merge(targetObject, otherObject);
-      } else {
+    for (const auto& name : names) {
+      auto& entry = entries[name];
+      TObject* targetObject = targetCollection->FindObject(name.c_str());
+      auto firstToMerge = entry.begin();
+      if (targetObject == nullptr) {
         // We prefer to clone instead of passing the pointer in order to simplify deleting the `other`.
-        targetCollection->Add(otherObject->Clone());
+        // A histogram sent as a delta is created from its prototype, unless we are building a partial result.
+        auto firstDelta = dynamic_cast<HistogramDelta*>(*firstToMerge);
+        targetObject = (firstDelta && !partialResult) ? firstDelta->createTarget() : (*firstToMerge)->Clone();
+        targetCollection->Add(targetObject);
+        ++firstToMerge;
       }
+      // That might be another collection or a concrete object to be merged, we walk on the collection recursively.
+      mergeImpl(targetObject, std::vector<TObject*>(firstToMerge, entry.end()), partialResult);
     }
-    delete otherIterator;
   } else {
-    Long64_t errorCode = 0;
-    TObjArray otherCollection;
+    // The deltas are applied directly, bin by bin.
+    TObjArray otherCollection(others.size());
     otherCollection.SetOwner(false);
-    otherCollection.Add(other);
+    for (auto other : others) {
+      if (auto otherDelta = dynamic_cast<HistogramDelta*>(other)) {
+        otherDelta->applyTo(target);
+      } else {
+        otherCollection.Add(other);
+      }
+    }
+    if (otherCollection.GetEntriesFast() == 0) {
+      return;
+    }
+
+    Long64_t errorCode = 0;
 
     if (target->InheritsFrom(TH1::Class())) {
       // this includes TH1, TH2, TH3
@@ -92,6 +174,83 @@ void merge(TObject* const target, TObject* const other)
     }
   }
 }
+} // namespace
+
+namespace
+{
+// Merges the objects into the first one as a tree of groups, one group per thread at each level.
+template <typename T, typename MergeBatch>
+void reduceTree(std::vector<T*> objects, int nThreads, MergeBatch mergeBatch)
+{
+#ifdef WITH_OPENMP
+  if (nThreads <= 0) {
+    nThreads = omp_get_max_threads();
+  }
+#else
+  nThreads = 1;
+#endif
+  if (nThreads > 1 && objects.size() > 2) {
+    ROOT::EnableThreadSafety();
+  }
+
+  while (objects.size() > 1) {
+    // each group should have at least two objects, otherwise there is nothing to merge
+    size_t nGroups = std::clamp(objects.size() / 2, size_t(1), size_t(std::max(nThreads, 1)));
+    const size_t groupSize = (objects.size() + nGroups - 1) / nGroups;
+    nGroups = (objects.size() + groupSize - 1) / groupSize;
+    std::vector<std::exception_ptr> errors(nGroups);
+
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(nGroups) schedule(static, 1)
+#endif
+    for (size_t g = 0; g < nGroups; g++) {
+      // exceptions must not leave the parallel region, we rethrow them afterwards
+      try {
+        auto first = objects.begin() + g * groupSize;
+        auto last = objects.begin() + std::min(objects.size(), (g + 1) * groupSize);
+        mergeBatch(*first, std::vector<T*>(first + 1, last));
+      } catch (...) {
+        errors[g] = std::current_exception();
+      }
+    }
+    for (auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    std::vector<T*> partialResults(nGroups);
+    for (size_t g = 0; g < nGroups; g++) {
+      partialResults[g] = objects[g * groupSize];
+    }
+    objects.swap(partialResults);
+  }
+}
+} // namespace
+
+void reduce(const std::vector<TObject*>& objects, int nThreads)
+{
+  // The first object stays the target of the first group at each level, all the other targets are partial results.
+  TObject* const finalTarget = objects.empty() ? nullptr : objects.front();
+  reduceTree(objects, nThreads, [finalTarget](TObject* target, const std::vector<TObject*>& others) {
+    mergeImpl(target, others, target != finalTarget);
+  });
+}
+
+void reduce(const std::vector<MergeInterface*>& objects, int nThreads)
+{
+  reduceTree(objects, nThreads, [](MergeInterface* target, const std::vector<MergeInterface*>& others) {
+    if (target == nullptr) {
+      throw std::runtime_error("Merging target is nullptr");
+    }
+    for (auto other : others) {
+      if (other == nullptr) {
+        throw std::runtime_error("Object to be merged in is nullptr");
+      }
+      target->merge(other);
+    }
+  });
+}
 
 void deleteTCollections(TObject* obj)
 {
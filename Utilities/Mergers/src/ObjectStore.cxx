@@ -18,6 +18,12 @@
 #include "Mergers/MergeInterface.h"
 #include "Mergers/MergerAlgorithm.h"
 #include <TObject.h>
+#include <TROOT.h>
+#include <exception>
+
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 namespace o2::mergers
 {
@@ -71,6 +77,40 @@ ObjectStore extractObjectFrom(const framework::DataRef& ref)
   }
 }
 
+std::vector<ObjectStore> extractObjectsFrom(const std::vector<framework::DataRef>& refs, int nThreads)
+{
+#ifdef WITH_OPENMP
+  if (nThreads <= 0) {
+    nThreads = omp_get_max_threads();
+  }
+#else
+  nThreads = 1;
+#endif
+  if (nThreads > 1 && refs.size() > 1) {
+    ROOT::EnableThreadSafety();
+  }
+
+  std::vector<ObjectStore> objects(refs.size());
+  std::vector<std::exception_ptr> errors(refs.size());
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(nThreads) schedule(dynamic)
+#endif
+  for (size_t i = 0; i < refs.size(); i++) {
+    // exceptions must not leave the parallel region, we rethrow the first one afterwards
+    try {
+      objects[i] = extractObjectFrom(refs[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  }
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return objects;
+}
+
 } // namespace object_store_helpers
 
 } // namespace o2::mergers
\ No newline at end of file
@@ -38,6 +38,7 @@ void customize(std::vector<ConfigParamSpec>& options)
   options.push_back({"mergers-publication-interval", VariantType::Double, 10.0, {"Publication interval of merged object [s]. It takes effect with --mergers-publication-decision interval"}});
   options.push_back(
     {"mergers-input-timespan", VariantType::String, "diffs", {"Should the topology use 'diffs' or 'full' objects"}});
+  options.push_back({"mergers-threads", VariantType::Int, -1, {"Number of threads of parallel merging (0 - default), -1 merges sequentially"}});
 }
 
 #include "Framework/runDataProcessing.h"
@@ -62,6 +63,8 @@ WorkflowSpec defineDataProcessing(ConfigContext const& config)
   InputObjectsTimespan mergersInputObjectTimespan =
     config.options().get<std::string>("mergers-input-timespan") == "full" ? InputObjectsTimespan::FullHistory : InputObjectsTimespan::LastDifference;
 
+  int mergersThreads = config.options().get<int>("mergers-threads");
+
   WorkflowSpec specs;
   // clang-format off
   // one 1D histo, binwise
@@ -106,6 +109,7 @@ WorkflowSpec defineDataProcessing(ConfigContext const& config)
     mergerConfig.publicationDecision = { mergersPublicationDecision, mergersPublicationDecision == PublicationDecision::EachNSeconds ? mergersPublicationInterval : 1.0 };
     mergerConfig.mergedObjectTimespan = { MergedObjectTimespan::FullHistory };
     mergerConfig.topologySize = { TopologySize::NumberOfLayers, mergersLayers };
+    mergerConfig.mergingMode = { mergersThreads < 0 ? MergingMode::Sequential : MergingMode::Parallel, mergersThreads };
     mergersBuilder.setConfig(mergerConfig);
 
     mergersBuilder.generateInfrastructure(specs);
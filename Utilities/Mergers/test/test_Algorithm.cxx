@@ -22,6 +22,7 @@
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/CustomMergeableTObject.h"
 #include "Mergers/CustomMergeableObject.h"
+#include "Mergers/HistogramDelta.h"
 
 #include <TObjArray.h>
 #include <TObjString.h>
@@ -328,3 +329,284 @@ BOOST_AUTO_TEST_CASE(Deleting)
   // I am afraid we can't check more than that.
   BOOST_CHECK_NO_THROW(algorithm::deleteTCollections(main));
 }
+
+BOOST_AUTO_TEST_CASE(MergerBatch)
+{
+  {
+    TH1I* target = new TH1I("obj1", "obj1", bins, min, max);
+    target->Fill(5);
+    std::vector<TObject*> others;
+    for (int i = 0; i < 10; i++) {
+      auto other = new TH1I("obj1", "obj1", bins, min, max);
+      other->Fill(i);
+      others.push_back(other);
+    }
+
+    BOOST_CHECK_NO_THROW(algorithm::merge(target, others));
+    BOOST_CHECK_EQUAL(target->GetEntries(), 11);
+    BOOST_CHECK_EQUAL(target->GetBinContent(target->FindBin(5)), 2);
+    BOOST_CHECK_EQUAL(target->GetBinContent(target->FindBin(9)), 1);
+
+    others.push_back(target);
+    BOOST_CHECK_THROW(algorithm::merge(target, others), std::runtime_error);
+    others.pop_back();
+    others.push_back(nullptr);
+    BOOST_CHECK_THROW(algorithm::merge(target, others), std::runtime_error);
+    others.pop_back();
+
+    delete target;
+    for (auto other : others) {
+      delete other;
+    }
+  }
+  {
+    // the entries missing in the target are added once, the other ones are merged into them
+    TObjArray* target = new TObjArray();
+    target->SetOwner(true);
+    target->Add(new CustomMergeableTObject("custom", 9000));
+
+    std::vector<TObject*> others;
+    for (int i = 0; i < 3; i++) {
+      auto other = new TList();
+      other->SetOwner(true);
+      auto histo = new TH1I("histo 1d", "histo 1d", bins, min, max);
+      histo->Fill(2);
+      other->Add(histo);
+      other->Add(new CustomMergeableTObject("custom", 1));
+      others.push_back(other);
+    }
+
+    BOOST_CHECK_NO_THROW(algorithm::merge(target, others));
+    for (auto other : others) {
+      delete other;
+    }
+
+    BOOST_REQUIRE_EQUAL(target->GetEntries(), 2);
+    TH1I* resultTH1I = dynamic_cast<TH1I*>(target->FindObject("histo 1d"));
+    BOOST_REQUIRE(resultTH1I != nullptr);
+    BOOST_CHECK_EQUAL(resultTH1I->GetBinContent(resultTH1I->FindBin(2)), 3);
+    auto* resultCustom = dynamic_cast<CustomMergeableTObject*>(target->FindObject("custom"));
+    BOOST_REQUIRE(resultCustom != nullptr);
+    BOOST_CHECK_EQUAL(resultCustom->getSecret(), 9003);
+
+    delete target;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MergerReduce)
+{
+  for (int nThreads : {1, 2, 4}) {
+    std::vector<TObject*> histos;
+    for (int i = 0; i < 37; i++) {
+      auto histo = new TH1I("obj1", "obj1", bins, min, max);
+      histo->Fill(i % bins);
+      histos.push_back(histo);
+    }
+    BOOST_CHECK_NO_THROW(algorithm::reduce(histos, nThreads));
+    auto result = dynamic_cast<TH1I*>(histos[0]);
+    BOOST_CHECK_EQUAL(result->GetEntries(), 37);
+    BOOST_CHECK_EQUAL(result->GetBinContent(result->FindBin(0)), 4);
+    BOOST_CHECK_EQUAL(result->GetBinContent(result->FindBin(9)), 3);
+    for (auto histo : histos) {
+      delete histo;
+    }
+
+    std::vector<MergeInterface*> customs;
+    for (int i = 0; i < 21; i++) {
+      customs.push_back(new CustomMergeableObject(1));
+    }
+    BOOST_CHECK_NO_THROW(algorithm::reduce(customs, nThreads));
+    BOOST_CHECK_EQUAL(dynamic_cast<CustomMergeableObject*>(customs[0])->getSecret(), 21);
+    for (auto custom : customs) {
+      delete custom;
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MergerHistogramDelta)
+{
+  {
+    // a continuously filled histogram, sent as deltas
+    TH2F producerHisto("histo 2d", "histo 2d", bins, min, max, bins, min, max);
+    producerHisto.Sumw2();
+    producerHisto.SetDirectory(nullptr);
+    HistogramDeltaEncoder encoder;
+
+    producerHisto.Fill(5, 5);
+    producerHisto.Fill(2, 3, 2.);
+    auto first = encoder.encode(producerHisto);
+    BOOST_REQUIRE(first->getPrototype() != nullptr);
+    BOOST_CHECK_EQUAL(first->getNBins(), 2);
+
+    std::unique_ptr<TObject> target(first->createTarget());
+    auto* result = dynamic_cast<TH2F*>(target.get());
+    BOOST_REQUIRE(result != nullptr);
+
+    producerHisto.Fill(5, 5);
+    auto second = encoder.encode(producerHisto);
+    BOOST_CHECK(second->getPrototype() == nullptr);
+    BOOST_CHECK_EQUAL(second->getNBins(), 1);
+    auto third = encoder.encode(producerHisto);
+    BOOST_CHECK_EQUAL(third->getNBins(), 0);
+
+    BOOST_CHECK_NO_THROW(algorithm::merge(target.get(), std::vector<TObject*>{second.get(), third.get()}));
+    BOOST_CHECK_EQUAL(result->GetBinContent(result->FindBin(5, 5)), 2);
+    BOOST_CHECK_EQUAL(result->GetBinContent(result->FindBin(2, 3)), 2);
+    BOOST_CHECK_CLOSE(result->GetBinError(result->FindBin(2, 3)), 2, 0.001);
+    BOOST_CHECK_EQUAL(result->GetEntries(), producerHisto.GetEntries());
+    BOOST_CHECK_CLOSE(result->GetMean(1), producerHisto.GetMean(1), 0.001);
+
+    // the binning must match
+    TH1F otherHisto("histo 2d", "histo 2d", bins, min, max);
+    BOOST_CHECK_THROW(encoder.encode(otherHisto), std::runtime_error);
+    BOOST_CHECK_THROW(algorithm::merge(&otherHisto, second.get()), std::runtime_error);
+  }
+  {
+    // sparse histograms are extended by the deltas, the deltas of a reduction are merged together
+    const Int_t sparseBins[] = {1000, 1000};
+    const Double_t sparseMin[] = {0, 0};
+    const Double_t sparseMax[] = {1000, 1000};
+    THnSparseF target("sparse", "sparse", 2, sparseBins, sparseMin, sparseMax);
+    std::vector<std::unique_ptr<HistogramDelta>> deltas;
+    for (int i = 0; i < 10; i++) {
+      THnSparseF producerSparse("sparse", "sparse", 2, sparseBins, sparseMin, sparseMax);
+      const Double_t x[] = {Double_t(i), Double_t(i)};
+      const Double_t y[] = {500, 500};
+      producerSparse.Fill(x);
+      producerSparse.Fill(y);
+      deltas.push_back(HistogramDelta::encode(producerSparse, nullptr, false));
+    }
+    std::vector<TObject*> objects{&target};
+    for (auto& delta : deltas) {
+      objects.push_back(delta.get());
+    }
+    BOOST_CHECK_NO_THROW(algorithm::reduce(objects, 3));
+    BOOST_CHECK_EQUAL(target.GetNbins(), 11);
+    BOOST_CHECK_EQUAL(target.GetEntries(), 20);
+    const Int_t centre[] = {501, 501};
+    BOOST_CHECK_EQUAL(target.GetBinContent(centre), 10);
+  }
+  {
+    // the bins removed from a THnSparse by the producer's Reset are subtracted from the merged histogram
+    const Int_t sparseBins[] = {100, 100};
+    const Double_t sparseMin[] = {0, 0};
+    const Double_t sparseMax[] = {100, 100};
+    THnSparseF producerSparse("sparse reset", "sparse reset", 2, sparseBins, sparseMin, sparseMax);
+    producerSparse.Sumw2();
+    HistogramDeltaEncoder encoder;
+    const Double_t x[] = {10, 10};
+    const Double_t y[] = {50, 50};
+    producerSparse.Fill(x);
+    producerSparse.Fill(y, 2.);
+    auto first = encoder.encode(producerSparse);
+    std::unique_ptr<TObject> target(first->createTarget());
+    auto* result = dynamic_cast<THnSparseF*>(target.get());
+    BOOST_REQUIRE(result != nullptr);
+
+    producerSparse.Reset();
+    producerSparse.Fill(y);
+    const Double_t z[] = {70, 20};
+    producerSparse.Fill(z);
+    auto second = encoder.encode(producerSparse);
+    BOOST_CHECK_NO_THROW(algorithm::merge(target.get(), second.get()));
+    for (auto point : {x, y, z}) {
+      const Int_t bin[] = {result->GetAxis(0)->FindBin(point[0]), result->GetAxis(1)->FindBin(point[1])};
+      const Long64_t producerBin = producerSparse.GetBin(bin, kFALSE);
+      const Double_t expected = producerBin >= 0 ? producerSparse.GetBinContent(producerBin) : 0.;
+      BOOST_CHECK_EQUAL(result->GetBinContent(bin), expected);
+      BOOST_CHECK_CLOSE(result->GetBinError2(result->GetBin(bin)), producerBin >= 0 ? producerSparse.GetBinError2(producerBin) : 0., 0.001);
+    }
+    BOOST_CHECK_EQUAL(result->GetEntries(), producerSparse.GetEntries());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MergerHistogramDeltaCollections)
+{
+  // two producers send the collections of deltas, as a Merger receives them
+  auto makeHisto = [](const char* name) {
+    auto histo = std::make_unique<TH1F>(name, name, bins, min, max);
+    histo->SetDirectory(nullptr);
+    return histo;
+  };
+  auto histoA = makeHisto("histo A");
+  auto histoB = makeHisto("histo B");
+  auto histoC = makeHisto("histo C");
+  HistogramDeltaEncoder encoderA, encoderB;
+  auto encodeCollection = [](const std::vector<std::pair<HistogramDeltaEncoder*, TH1F*>>& histos) {
+    auto collection = new TObjArray();
+    collection->SetOwner(true);
+    for (auto& [encoder, histo] : histos) {
+      collection->Add(encoder->encode(*histo).release());
+    }
+    return collection;
+  };
+  auto deleteCollection = [](TObject* collection) { algorithm::deleteTCollections(collection); };
+  using CollectionPtr = std::unique_ptr<TObject, decltype(deleteCollection)>;
+
+  HistogramDeltaResolver resolver;
+  histoA->Fill(1);
+  histoB->Fill(2);
+  CollectionPtr first(encodeCollection({{&encoderA, histoA.get()}, {&encoderB, histoB.get()}}), deleteCollection);
+  // the merged object has the histograms instead of the deltas
+  BOOST_REQUIRE(resolver.prepare(first.get(), nullptr) == first.get());
+  auto target = dynamic_cast<TCollection*>(first.get());
+  BOOST_REQUIRE(dynamic_cast<TH1F*>(target->FindObject("histo A")) != nullptr);
+  BOOST_REQUIRE(dynamic_cast<TH1F*>(target->FindObject("histo B")) != nullptr);
+
+  // the next deltas are applied, a delta cannot be a merging target outside of a reduction
+  histoA->Fill(1);
+  histoB->Fill(3);
+  CollectionPtr second(encodeCollection({{&encoderA, histoA.get()}, {&encoderB, histoB.get()}}), deleteCollection);
+  BOOST_CHECK_THROW(algorithm::merge(second.get(), first.get()), std::runtime_error);
+  BOOST_REQUIRE(resolver.prepare(second.get(), target) == second.get());
+  BOOST_CHECK_NO_THROW(algorithm::merge(target, second.get()));
+  BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(target->FindObject("histo A"))->GetBinContent(2), 2);
+  BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(target->FindObject("histo B"))->GetEntries(), 2);
+
+  // the delta of a histogram, whose prototype was not received, is dropped and reported
+  histoA->Fill(5);
+  histoC->Fill(5);
+  HistogramDeltaEncoder encoderC;
+  encoderC.encode(*histoC); // the first delta, with the prototype, is lost
+  histoC->Fill(6);
+  CollectionPtr third(encodeCollection({{&encoderA, histoA.get()}, {&encoderC, histoC.get()}}), deleteCollection);
+  BOOST_REQUIRE(resolver.prepare(third.get(), target) == third.get());
+  BOOST_CHECK_EQUAL(resolver.getNDropped(), 1);
+  BOOST_CHECK_EQUAL(dynamic_cast<TCollection*>(third.get())->GetEntries(), 1);
+  BOOST_CHECK_NO_THROW(algorithm::merge(target, third.get()));
+  BOOST_CHECK(target->FindObject("histo C") == nullptr);
+  BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(target->FindObject("histo A"))->GetBinContent(6), 1);
+
+  // the merged object was reset after the publication, it is created from the kept prototypes,
+  // while the deltas of several cycles are reduced together as partial results
+  resolver.resetNDropped();
+  std::vector<CollectionPtr> cycles;
+  for (int i = 0; i < 4; i++) {
+    histoA->Fill(7);
+    histoB->Fill(8);
+    cycles.emplace_back(encodeCollection({{&encoderA, histoA.get()}, {&encoderB, histoB.get()}}), deleteCollection);
+  }
+  CollectionPtr merged(cycles[0].release(), deleteCollection);
+  BOOST_REQUIRE(resolver.prepare(merged.get(), nullptr) == merged.get());
+  std::vector<TObject*> objects{merged.get()};
+  for (size_t i = 1; i < cycles.size(); i++) {
+    BOOST_REQUIRE(resolver.prepare(cycles[i].get(), merged.get()) == cycles[i].get());
+    objects.push_back(cycles[i].get());
+  }
+  BOOST_CHECK_NO_THROW(algorithm::reduce(objects, 2));
+  auto mergedCollection = dynamic_cast<TCollection*>(merged.get());
+  auto mergedA = dynamic_cast<TH1F*>(mergedCollection->FindObject("histo A"));
+  auto mergedB = dynamic_cast<TH1F*>(mergedCollection->FindObject("histo B"));
+  BOOST_REQUIRE(mergedA != nullptr && mergedB != nullptr);
+  BOOST_CHECK_EQUAL(mergedA->GetBinContent(8), 4);
+  BOOST_CHECK_EQUAL(mergedA->GetEntries(), 4);
+  BOOST_CHECK_EQUAL(mergedB->GetBinContent(9), 4);
+  BOOST_CHECK_EQUAL(resolver.getNDropped(), 0);
+
+  // a single delta, whose prototype is known, becomes the merged histogram
+  histoB->Fill(1);
+  std::unique_ptr<TObject> delta(encoderB.encode(*histoB).release());
+  std::unique_ptr<TObject> histo(resolver.prepare(delta.get(), nullptr));
+  BOOST_REQUIRE(dynamic_cast<TH1F*>(histo.get()) != nullptr);
+  BOOST_CHECK_EQUAL(dynamic_cast<TH1F*>(histo.get())->GetBinContent(2), 1);
+}